@@ -0,0 +1,256 @@
+/*
+ * BoxCollisionMatrix.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include "BoxCollisionMatrix.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+#include "../../Utility_Functions/src/CollisionEngine.h"
+#include "../../Utility_Functions/src/OsgHelpers.h"
+#include "../../Utility_Functions/src/ThreadPool.h"
+#include "../../Utility_Functions/src/Constants.h"
+
+using namespace utility_functions;
+
+namespace evolutionary_inspection_plan_evaluation {
+
+namespace {
+	const char FILE_MAGIC[8] = {'I', 'P', 'P', 'B', 'C', 'M', 'X', '\0'};
+	const uint32_t FILE_FORMAT_VERSION = 2;
+
+	///@return The number of pairs whose state is stored in the word.
+	size_t countKnownPairs(uint64_t word) {
+		//A pair is known if either of its two bits is set.
+		uint64_t knownPairs = (word | (word >> 1)) & 0x5555555555555555ull;
+		return __builtin_popcountll(knownPairs);
+	}
+}
+
+BoxCollisionMatrix::BoxCollisionMatrix(osg::ref_ptr<osg::Vec3dArray> boxCenters, osg::ref_ptr<osg::Node> scene,
+		const std::string& cacheFileName)
+:boxCenters(boxCenters),
+ scene(scene),
+ cacheFileName(cacheFileName),
+ numSparseWords(0),
+ hasUnsavedPairs(false){
+	size_t numBoxes = boxCenters->size();
+	numPairs = numBoxes * (numBoxes - (numBoxes > 0 ? 1 : 0)) / 2;
+	numWords = (numPairs + PAIRS_PER_WORD - 1) / PAIRS_PER_WORD;
+	//Plans on large grids only use a small part of all edges, so storing all of them would mostly waste memory.
+	dense = numPairs <= BOX_COLLISION_MATRIX_EAGER_PAIRS;
+	if (dense) {
+		words.reset(new std::atomic<uint64_t>[numWords]);
+		for (size_t w = 0; w < numWords; w++) {
+			words[w].store(0, std::memory_order_relaxed);
+		}
+	} else {
+		sparseShards.reset(new SparseShard[NUM_SPARSE_SHARDS]);
+	}
+
+	//The answers depend on where the boxes are, on the triangles of the scene, and on how close edges may come to them.
+	Hash128Builder keyBuilder;
+	keyBuilder.addBytes(&EDGE_SAFETY_BUFFER, sizeof(EDGE_SAFETY_BUFFER));
+	uint64_t numBoxesWord = numBoxes;
+	keyBuilder.addBytes(&numBoxesWord, sizeof(numBoxesWord));
+	for (size_t box = 0; box < numBoxes; box++) {
+		keyBuilder.addBytes((*boxCenters)[box].ptr(), 3 * sizeof(double));
+	}
+	const CollisionEngine* collisionEngine = CollisionEngine::getAttached(*scene);
+	if (collisionEngine != nullptr) {
+		Hash128 sceneFingerprint = collisionEngine->getFingerprint();
+		keyBuilder.addWord(sceneFingerprint.low);
+		keyBuilder.addWord(sceneFingerprint.high);
+	} else {
+		this->cacheFileName.clear(); //Without the engine's fingerprint, we cannot tell a changed model from the old one.
+	}
+	key = keyBuilder.finish();
+
+	if (!this->cacheFileName.empty()) {
+		mergeFromFile(this->cacheFileName);
+	}
+}
+
+size_t BoxCollisionMatrix::pairIndex(size_t box1, size_t box2) {
+	if (box1 > box2) {
+		std::swap(box1, box2);
+	}
+	return box2 * (box2 - 1) / 2 + box1;
+}
+
+uint64_t BoxCollisionMatrix::loadWord(size_t w) const {
+	if (dense) {
+		return words[w].load(std::memory_order_relaxed);
+	}
+	SparseShard& shard = sparseShards[w % NUM_SPARSE_SHARDS];
+	std::lock_guard<std::mutex> lock(shard.mutex);
+	std::unordered_map<size_t, uint64_t>::const_iterator it = shard.words.find(w);
+	return it == shard.words.end() ? 0 : it->second;
+}
+
+void BoxCollisionMatrix::orWord(size_t w, uint64_t bits) {
+	if (dense) {
+		words[w].fetch_or(bits, std::memory_order_relaxed);
+		return;
+	}
+	SparseShard& shard = sparseShards[w % NUM_SPARSE_SHARDS];
+	std::lock_guard<std::mutex> lock(shard.mutex);
+	std::unordered_map<size_t, uint64_t>::iterator it = shard.words.find(w);
+	if (it != shard.words.end()) {
+		it->second |= bits;
+	} else if (numSparseWords.load(std::memory_order_relaxed) < BOX_COLLISION_MATRIX_MAX_SPARSE_WORDS) {
+		//Shards may together go a few words over the limit, which does not matter.
+		shard.words[w] = bits;
+		numSparseWords.fetch_add(1, std::memory_order_relaxed);
+	}
+}
+
+BoxCollisionMatrix::PairState BoxCollisionMatrix::getState(size_t pair) const {
+	uint64_t word = loadWord(pair / PAIRS_PER_WORD);
+	return (PairState) ((word >> (2 * (pair % PAIRS_PER_WORD))) & 3);
+}
+
+bool BoxCollisionMatrix::checkPair(size_t box1, size_t box2, size_t pair) {
+	bool collides = edgeComesTooCloseToStructure((*boxCenters)[box1], (*boxCenters)[box2], *scene);
+	uint64_t state = collides ? COLLIDES : CLEAR;
+	orWord(pair / PAIRS_PER_WORD, state << (2 * (pair % PAIRS_PER_WORD)));
+	if (!hasUnsavedPairs.load(std::memory_order_relaxed)) {
+		hasUnsavedPairs.store(true, std::memory_order_relaxed);
+	}
+	return collides;
+}
+
+bool BoxCollisionMatrix::edgeCollides(size_t box1, size_t box2) {
+	size_t pair = pairIndex(box1, box2);
+	PairState state = getState(pair);
+	if (state == UNKNOWN) {
+		return checkPair(box1, box2, pair);
+	}
+	return state == COLLIDES;
+}
+
+void BoxCollisionMatrix::precompute(size_t numThreads/*=0*/) {
+	if (!dense) {
+		throw std::logic_error("ERROR! Asked to check all edges of a grid too large to store them all.");
+	}
+	//Edges are checked for one box at a time, against all boxes before it.
+	size_t numBoxes = boxCenters->size();
+	ThreadPool threadPool(numThreads);
+	threadPool.parallelFor(numBoxes, [&](size_t box2, size_t) {
+		for (size_t box1 = 0; box1 < box2; box1++) {
+			size_t pair = pairIndex(box1, box2);
+			if (getState(pair) == UNKNOWN) {
+				checkPair(box1, box2, pair);
+			}
+		}
+	});
+}
+
+size_t BoxCollisionMatrix::getNumKnownPairs() const {
+	size_t numKnown = 0;
+	if (dense) {
+		for (size_t w = 0; w < numWords; w++) {
+			numKnown += countKnownPairs(words[w].load(std::memory_order_relaxed));
+		}
+	} else {
+		for (size_t shard = 0; shard < NUM_SPARSE_SHARDS; shard++) {
+			std::lock_guard<std::mutex> lock(sparseShards[shard].mutex);
+			for (const std::pair<const size_t, uint64_t>& word : sparseShards[shard].words) {
+				numKnown += countKnownPairs(word.second);
+			}
+		}
+	}
+	return numKnown;
+}
+
+bool BoxCollisionMatrix::mergeFromFile(const std::string& fileName) {
+	std::ifstream in(fileName.c_str(), std::ios::binary);
+	char magic[sizeof(FILE_MAGIC)];
+	uint32_t version;
+	Hash128 fileKey;
+	uint64_t fileNumWords;
+	uint64_t numStoredWords;
+	if (!in.read(magic, sizeof(magic)) || memcmp(magic, FILE_MAGIC, sizeof(magic)) != 0
+			|| !in.read(reinterpret_cast<char*>(&version), sizeof(version)) || version != FILE_FORMAT_VERSION
+			|| !in.read(reinterpret_cast<char*>(&fileKey.low), sizeof(fileKey.low))
+			|| !in.read(reinterpret_cast<char*>(&fileKey.high), sizeof(fileKey.high)) || fileKey != key
+			|| !in.read(reinterpret_cast<char*>(&fileNumWords), sizeof(fileNumWords)) || fileNumWords != numWords
+			|| !in.read(reinterpret_cast<char*>(&numStoredWords), sizeof(numStoredWords)) || numStoredWords > numWords) {
+		return false;
+	}
+	//Only words holding a known pair are stored, each after its index.
+	std::vector<uint64_t> fileWords(2 * numStoredWords);
+	if (!in.read(reinterpret_cast<char*>(fileWords.data()), fileWords.size() * sizeof(uint64_t))) {
+		return false;
+	}
+	//Both hold answers for the same pairs, which never differ, so a pair is known if either knows it.
+	for (size_t i = 0; i < fileWords.size(); i += 2) {
+		if (fileWords[i] < numWords) {
+			orWord(fileWords[i], fileWords[i + 1]);
+		}
+	}
+	return true;
+}
+
+bool BoxCollisionMatrix::saveIfChanged() {
+	if (cacheFileName.empty() || !hasUnsavedPairs.exchange(false)) {
+		return true;
+	}
+	mergeFromFile(cacheFileName);
+
+	//Writing to a file of our own first, so other processes never load half a matrix.
+	std::ostringstream temporaryName;
+	temporaryName << cacheFileName << ".tmp" << getpid();
+	std::vector<uint64_t> knownWords; //The index of each word holding a known pair, followed by the word.
+	if (dense) {
+		for (size_t w = 0; w < numWords; w++) {
+			uint64_t word = words[w].load(std::memory_order_relaxed);
+			if (word != 0) {
+				knownWords.push_back(w);
+				knownWords.push_back(word);
+			}
+		}
+	} else {
+		for (size_t shard = 0; shard < NUM_SPARSE_SHARDS; shard++) {
+			std::lock_guard<std::mutex> lock(sparseShards[shard].mutex);
+			for (const std::pair<const size_t, uint64_t>& word : sparseShards[shard].words) {
+				knownWords.push_back(word.first);
+				knownWords.push_back(word.second);
+			}
+		}
+	}
+	{
+		std::ofstream out(temporaryName.str().c_str(), std::ios::binary | std::ios::trunc);
+		uint64_t numWordsToWrite = numWords;
+		uint64_t numKnownWords = knownWords.size() / 2;
+		out.write(FILE_MAGIC, sizeof(FILE_MAGIC));
+		out.write(reinterpret_cast<const char*>(&FILE_FORMAT_VERSION), sizeof(FILE_FORMAT_VERSION));
+		out.write(reinterpret_cast<const char*>(&key.low), sizeof(key.low));
+		out.write(reinterpret_cast<const char*>(&key.high), sizeof(key.high));
+		out.write(reinterpret_cast<const char*>(&numWordsToWrite), sizeof(numWordsToWrite));
+		out.write(reinterpret_cast<const char*>(&numKnownWords), sizeof(numKnownWords));
+		out.write(reinterpret_cast<const char*>(knownWords.data()), knownWords.size() * sizeof(uint64_t));
+		if (!out.flush()) {
+			std::remove(temporaryName.str().c_str());
+			hasUnsavedPairs.store(true);
+			return false;
+		}
+	}
+	if (std::rename(temporaryName.str().c_str(), cacheFileName.c_str()) != 0) {
+		std::remove(temporaryName.str().c_str());
+		hasUnsavedPairs.store(true);
+		return false;
+	}
+	return true;
+}
+
+} /* namespace evolutionary_inspection_plan_evaluation */
@@ -0,0 +1,123 @@
+/*
+ * BoxCollisionMatrix.h
+ *
+ * Remembers which edges between candidate viewpoints (boxes) collide with the inspection target. Plans only move
+ * between boxes, so once the grid is made, every edge the optimizer can propose is one of these pairs.
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef BOXCOLLISIONMATRIX_H_
+#define BOXCOLLISIONMATRIX_H_
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <osg/Array>
+#include <osg/Node>
+#include <osg/ref_ptr>
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
+
+#include "../../Utility_Functions/src/Hash128.h"
+
+namespace evolutionary_inspection_plan_evaluation {
+
+/**
+ * For each unordered pair of boxes, whether the edge between them comes too close to the target (see
+ * edgeComesTooCloseToStructure), or that we do not know yet. Pairs are checked the first time they are asked for, and
+ * the answer is stored in two bits. Any number of threads may ask at once: A pair checked by two threads at the same
+ * time is stored twice, with the same answer.
+ * Grids with at most BOX_COLLISION_MATRIX_EAGER_PAIRS pairs are stored as one array of bits. Larger grids only store the
+ * words of 32 pairs that hold a known pair, in hash maps, up to BOX_COLLISION_MATRIX_MAX_SPARSE_WORDS words. Once that
+ * many are stored, pairs in other words are checked against the scene each time they are asked for.
+ * The matrix can be stored in a file, so later runs on the same model and grid start with what earlier runs found.
+ */
+class BoxCollisionMatrix {
+
+private:
+	enum PairState {
+		UNKNOWN = 0,
+		CLEAR = 1,
+		COLLIDES = 2
+	};
+	static const size_t PAIRS_PER_WORD = 32;
+	static const size_t NUM_SPARSE_SHARDS = 64;
+
+	///Part of the words of a sparse matrix: Those whose index modulo NUM_SPARSE_SHARDS is the index of the shard.
+	struct SparseShard {
+		std::mutex mutex;
+		std::unordered_map<size_t, uint64_t> words;
+	};
+
+	osg::ref_ptr<osg::Vec3dArray> boxCenters;
+	osg::ref_ptr<osg::Node> scene;
+	std::string cacheFileName;			///<Where the matrix is stored between runs. Empty if it is not.
+	utility_functions::Hash128 key;		///<Identifies the boxes, the scene and the safety buffer the matrix holds answers for.
+	size_t numPairs;
+	size_t numWords;
+	bool dense;							///<Whether all words are stored in words. If not, known words are in sparseShards.
+	std::unique_ptr<std::atomic<uint64_t>[]> words;	///<The state of pair p is in bits 2*(p%32) and up of words[p/32].
+	std::unique_ptr<SparseShard[]> sparseShards;
+	std::atomic<size_t> numSparseWords;
+	std::atomic<bool> hasUnsavedPairs;
+
+	///@return The index of the pair of two different boxes, in either order.
+	static size_t pairIndex(size_t box1, size_t box2);
+
+	///@return Word w, which is 0 if a sparse matrix does not store it.
+	uint64_t loadWord(size_t w) const;
+
+	///Sets the bits in word w. A sparse matrix that is full drops them, unless it already stores the word.
+	void orWord(size_t w, uint64_t bits);
+
+	PairState getState(size_t pair) const;
+
+	///Checks the edge between the boxes against the scene, and stores the answer.
+	bool checkPair(size_t box1, size_t box2, size_t pair);
+
+	///Sets the state of all pairs known in the file, if it holds a matrix with our key. @return false if it does not.
+	bool mergeFromFile(const std::string& fileName);
+
+public:
+
+	/**
+	 * Makes a matrix with all pairs unknown, and fills in those stored in the cache file, if it has a matrix for the same
+	 * boxes and scene.
+	 * @param boxCenters The boxes. Must not change while the matrix is in use.
+	 * @param scene The inspection target, as loaded by a SceneKeeper.
+	 * @param cacheFileName Where to store the matrix between runs, or empty to not store it.
+	 */
+	BoxCollisionMatrix(osg::ref_ptr<osg::Vec3dArray> boxCenters, osg::ref_ptr<osg::Node> scene, const std::string& cacheFileName);
+
+	/**
+	 * @return true if the edge between the two boxes comes too close to the target. Must be two different boxes.
+	 */
+	bool edgeCollides(size_t box1, size_t box2);
+
+	/**
+	 * Checks all pairs not yet known, in parallel. Only for matrices of at most BOX_COLLISION_MATRIX_EAGER_PAIRS pairs.
+	 * @param numThreads The number of threads to use. 0 means one per hardware thread.
+	 */
+	void precompute(size_t numThreads = 0);
+
+	/**
+	 * Stores the matrix in its cache file, if pairs have been checked since it was loaded or last saved. Pairs another
+	 * process stored in the file meanwhile are kept.
+	 * @return false if the file could not be written.
+	 */
+	bool saveIfChanged();
+
+	size_t getNumPairs() const {
+		return numPairs;
+	}
+
+	///@return The number of pairs we know the answer for.
+	size_t getNumKnownPairs() const;
+};
+
+} /* namespace evolutionary_inspection_plan_evaluation */
+
+#endif /* BOXCOLLISIONMATRIX_H_ */
@@ -0,0 +1,61 @@
+/*
+ * EdgeCoverageMemo.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include "EdgeCoverageMemo.h"
+
+using namespace utility_functions;
+
+namespace evolutionary_inspection_plan_evaluation {
+
+CoveragePattern EdgeCoverageMemo::find(const std::string& edgeName, unsigned int* numFrames/*=nullptr*/) const {
+	std::map<std::string, MemoisedEdge>::const_iterator edge = edges.find(edgeName);
+	if (edge == edges.end()) {
+		return CoveragePattern();
+	}
+	if (numFrames != nullptr) {
+		*numFrames = edge->second.numFrames;
+	}
+	return edge->second.coverage;
+}
+
+CoveragePattern EdgeCoverageMemo::insert(const std::string& edgeName, const boost::dynamic_bitset<>& coverage,
+		unsigned int numFrames/*=0*/) {
+	MemoisedEdge& edge = edges[edgeName];
+	edge.coverage = patterns.intern(coverage);
+	edge.numFrames = numFrames;
+	return edge.coverage;
+}
+
+size_t EdgeCoverageMemo::retainOnly(const std::set<std::string>& edgesToKeep) {
+	size_t numRemoved = 0;
+	for (std::map<std::string, MemoisedEdge>::iterator edge = edges.begin(); edge != edges.end();) {
+		if (edgesToKeep.find(edge->first) == edgesToKeep.end()) { //Find in set has logarithmic complexity.
+			edges.erase(edge++);
+			numRemoved++;
+		} else {
+			edge++;
+		}
+	}
+	patterns.releaseUnused();
+	return numRemoved;
+}
+
+void EdgeCoverageMemo::collectEdgeNames(std::set<std::string>& edgeNames) const {
+	for (std::map<std::string, MemoisedEdge>::const_iterator edge = edges.begin(); edge != edges.end(); edge++) {
+		edgeNames.insert(edgeNames.end(), edge->first);
+	}
+}
+
+size_t EdgeCoverageMemo::estimateBytes() const {
+	size_t edgeBytes = 0;
+	for (std::map<std::string, MemoisedEdge>::const_iterator edge = edges.begin(); edge != edges.end(); edge++) {
+		//The map node, the key string and the edge entry.
+		edgeBytes += 4 * sizeof(void*) + sizeof(std::string) + edge->first.capacity() + sizeof(MemoisedEdge);
+	}
+	return edgeBytes + patterns.estimateBytes();
+}
+
+} /* namespace evolutionary_inspection_plan_evaluation */
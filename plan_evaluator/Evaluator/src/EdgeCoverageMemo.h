@@ -0,0 +1,75 @@
+/*
+ * EdgeCoverageMemo.h
+ *
+ * The memo of edge coverages used when evaluating plans with memoization. Edges are indexed by name, and point to
+ * shared coverage patterns, so memory use scales with the number of distinct patterns, not the number of edges.
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef EDGECOVERAGEMEMO_H_
+#define EDGECOVERAGEMEMO_H_
+
+#include <boost/dynamic_bitset/dynamic_bitset.hpp>
+#include <map>
+#include <set>
+#include <stddef.h>
+#include <string>
+
+#include "../../Utility_Functions/src/CoveragePatternPool.h"
+
+namespace evolutionary_inspection_plan_evaluation {
+
+class EdgeCoverageMemo {
+
+private:
+	struct MemoisedEdge {
+		utility_functions::CoveragePattern coverage;
+		unsigned int numFrames;		///<The number of frames rendered to find the coverage. Lets us tell how much work the memo saves.
+	};
+	std::map<std::string, MemoisedEdge> edges;	///<The coverage of each memoized edge, indexed by edge name.
+	utility_functions::CoveragePatternPool patterns;				///<The distinct coverages the edges point to.
+
+public:
+
+	/**
+	 * @param edgeName The name of the edge
+	 * @param[out] numFrames If given, set to the number of frames that were rendered to find the edge's coverage.
+	 * @return The memoized coverage of the given edge, or an empty pointer if the edge is not memoized.
+	 */
+	utility_functions::CoveragePattern find(const std::string& edgeName, unsigned int* numFrames = nullptr) const;
+
+	/**
+	 * Memoizes the coverage of an edge, replacing any earlier coverage memoized for it.
+	 * @param numFrames The number of frames that were rendered to find the coverage. 0 if not known.
+	 * @return The pooled coverage the edge now points to.
+	 */
+	utility_functions::CoveragePattern insert(const std::string& edgeName, const boost::dynamic_bitset<>& coverage,
+			unsigned int numFrames = 0);
+
+	/**
+	 * Forgets every edge not in the given set, and every coverage pattern no longer used by any edge.
+	 * @return The number of forgotten edges.
+	 */
+	size_t retainOnly(const std::set<std::string>& edgesToKeep);
+
+	///Adds the names of all memoized edges to the given set.
+	void collectEdgeNames(std::set<std::string>& edgeNames) const;
+
+	///@return The number of memoized edges.
+	size_t size() const {
+		return edges.size();
+	}
+
+	///@return The number of distinct coverage patterns among the memoized edges.
+	size_t numDistinctPatterns() const {
+		return patterns.size();
+	}
+
+	///@return An estimate of the memory used by the memo, in bytes.
+	size_t estimateBytes() const;
+};
+
+} /* namespace evolutionary_inspection_plan_evaluation */
+
+#endif /* EDGECOVERAGEMEMO_H_ */
@@ -0,0 +1,444 @@
+/*
+ * EvaluationService.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include "EvaluationService.h"
+
+#include <boost/filesystem.hpp>
+#include <errno.h>
+#include <iostream>
+#include <poll.h>
+#include <stdexcept>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "PlanCoverageEstimator.h"
+
+namespace evolutionary_inspection_plan_evaluation {
+
+using namespace service_protocol;
+
+namespace {
+	typedef std::vector<std::vector<double> > Plan;
+
+	///How long we wait in poll before checking whether the service is stopping, in milliseconds.
+	const int STOP_CHECK_INTERVAL_MS = 200;
+
+	///Reads the pieces of a request payload in order, throwing if the payload is too short.
+	class PayloadReader {
+	private:
+		const std::vector<char>& payload;
+		size_t position;
+
+		void read(void* destination, size_t numBytes) {
+			if (numBytes > payload.size() - position) {
+				throw std::invalid_argument("Malformed request: The payload ended too early.");
+			}
+			memcpy(destination, &payload[position], numBytes);
+			position += numBytes;
+		}
+	public:
+		explicit PayloadReader(const std::vector<char>& payload)
+		:payload(payload), position(0){}
+
+		template<typename T>
+		T readValue() {
+			T value;
+			read(&value, sizeof(T));
+			return value;
+		}
+
+		std::string readString() {
+			uint32_t length = readValue<uint32_t>();
+			if (length > payload.size() - position) {
+				throw std::invalid_argument("Malformed request: A string is longer than the payload.");
+			}
+			std::string value(length, '\0');
+			if (length > 0) {
+				read(&value[0], length);
+			}
+			return value;
+		}
+
+		std::vector<double> readDoubles() {
+			uint32_t length = readValue<uint32_t>();
+			if (length > (payload.size() - position) / sizeof(double)) {
+				throw std::invalid_argument("Malformed request: A list is longer than the payload.");
+			}
+			std::vector<double> values(length);
+			if (length > 0) {
+				read(&values[0], length * sizeof(double));
+			}
+			return values;
+		}
+
+		Plan readPlan() {
+			uint32_t numGenes = readValue<uint32_t>();
+			Plan plan;
+			for (uint32_t i = 0; i < numGenes; i++) {
+				plan.push_back(readDoubles());
+			}
+			return plan;
+		}
+
+		std::vector<Plan> readPlans() {
+			uint32_t numPlans = readValue<uint32_t>();
+			std::vector<Plan> plans;
+			for (uint32_t i = 0; i < numPlans; i++) {
+				plans.push_back(readPlan());
+			}
+			return plans;
+		}
+
+		///Throws if anything of the payload is left unread, which means the client and we disagree on the protocol.
+		void finish() const {
+			if (position != payload.size()) {
+				throw std::invalid_argument("Malformed request: The payload is longer than expected.");
+			}
+		}
+	};
+
+	template<typename T>
+	void writeValue(std::vector<char>& out, const T& value) {
+		const char* bytes = reinterpret_cast<const char*>(&value);
+		out.insert(out.end(), bytes, bytes + sizeof(T));
+	}
+
+	void writeDoubles(std::vector<char>& out, const std::vector<double>& values) {
+		writeValue<uint32_t>(out, values.size());
+		for (size_t i = 0; i < values.size(); i++) {
+			writeValue(out, values[i]);
+		}
+	}
+
+	void writePlans(std::vector<char>& out, const std::vector<Plan>& plans) {
+		writeValue<uint32_t>(out, plans.size());
+		for (size_t i = 0; i < plans.size(); i++) {
+			writeValue<uint32_t>(out, plans[i].size());
+			for (size_t j = 0; j < plans[i].size(); j++) {
+				writeDoubles(out, plans[i][j]);
+			}
+		}
+	}
+
+	///Writes the fields in the order of evaluationStatisticsCounters and evaluationStatisticsTimes in Constants_and_Datastructures.py.
+	void writeStatistics(std::vector<char>& out, const EvaluationStatistics& statistics) {
+		const unsigned long long counters[] = {statistics.plansEvaluated, statistics.planCacheHits, statistics.memoHits,
+				statistics.memoMisses, statistics.sharedCacheHits, statistics.prefixEdgesSkipped, statistics.framesRendered,
+				statistics.framesSkipped, statistics.pixelsScanned, statistics.edgeSubtasks, statistics.subtaskSteals,
+				statistics.maxQueueDepth, statistics.speculativeEdges, statistics.memoEdges, statistics.memoPatterns, statistics.memoBytes};
+		for (size_t i = 0; i < sizeof(counters) / sizeof(counters[0]); i++) {
+			writeValue<uint64_t>(out, counters[i]);
+		}
+		const double times[] = {statistics.energySeconds, statistics.edgeCoverageSeconds, statistics.renderSeconds,
+				statistics.pixelScanSeconds, statistics.scoringSeconds, statistics.totalSeconds};
+		for (size_t i = 0; i < sizeof(times) / sizeof(times[0]); i++) {
+			writeValue(out, times[i]);
+		}
+	}
+
+	/**
+	 * Reads exactly numBytes from the socket, waiting for at most STOP_CHECK_INTERVAL_MS at a time so we notice when the service stops.
+	 * @return false if the client disconnected or the service is stopping.
+	 */
+	bool readFully(int socket, void* destination, size_t numBytes, const std::atomic<bool>& stopping) {
+		char* position = static_cast<char*>(destination);
+		while (numBytes > 0) {
+			if (stopping) {
+				return false;
+			}
+			pollfd request = {socket, POLLIN, 0};
+			int ready = poll(&request, 1, STOP_CHECK_INTERVAL_MS);
+			if (ready == 0 || (ready == -1 && errno == EINTR)) {
+				continue;
+			}
+			if (ready == -1) {
+				return false;
+			}
+			ssize_t numRead = recv(socket, position, numBytes, 0);
+			if (numRead == -1 && errno == EINTR) {
+				continue;
+			}
+			if (numRead <= 0) {
+				return false;
+			}
+			position += numRead;
+			numBytes -= numRead;
+		}
+		return true;
+	}
+
+	///Writes all of the data to the socket. @return false if the client disconnected.
+	bool writeFully(int socket, const void* source, size_t numBytes) {
+		const char* position = static_cast<const char*>(source);
+		while (numBytes > 0) {
+			ssize_t numWritten = send(socket, position, numBytes, MSG_NOSIGNAL);
+			if (numWritten == -1 && errno == EINTR) {
+				continue;
+			}
+			if (numWritten <= 0) {
+				return false;
+			}
+			position += numWritten;
+			numBytes -= numWritten;
+		}
+		return true;
+	}
+
+	///The canonical form of a path, so clients may name the scene file differently. Paths that do not exist are left as they are.
+	std::string canonicalPath(const std::string& path) {
+		boost::system::error_code error;
+		boost::filesystem::path canonical = boost::filesystem::canonical(path, error);
+		return error ? path : canonical.string();
+	}
+}
+
+EvaluationService::EvaluationService(PlanCoverageEstimator& estimator, const std::string& sceneFile,
+		const std::vector<double>& sensorSpecs, const std::vector<double>* startLocation, bool planLoopsAround,
+		double visibilityMeshFaceFraction)
+:estimator(estimator),
+ sceneFile(canonicalPath(sceneFile)),
+ sensorSpecs(sensorSpecs),
+ planLoopsAround(planLoopsAround),
+ visibilityMeshFaceFraction(visibilityMeshFaceFraction),
+ nextClientId(0),
+ listeningSocket(-1),
+ stopping(false){
+	if (startLocation) {
+		this->startLocation = *startLocation;
+	}
+}
+
+EvaluationService::~EvaluationService() {
+	stop();
+	if (listeningSocket != -1) {
+		close(listeningSocket);
+		unlink(socketPath.c_str());
+	}
+	for (std::map<int, std::thread>::iterator client = clientThreads.begin(); client != clientThreads.end(); client++) {
+		if (client->second.joinable()) {
+			client->second.join();
+		}
+	}
+	clientThreads.clear();
+}
+
+void EvaluationService::stop() {
+	stopping = true;
+}
+
+void EvaluationService::run(const std::string& socketPath) {
+	sockaddr_un address;
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	if (socketPath.size() >= sizeof(address.sun_path)) {
+		throw std::runtime_error("The socket path " + socketPath + " is too long.");
+	}
+	strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+
+	listeningSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (listeningSocket == -1) {
+		throw std::runtime_error(std::string("Could not create the service socket: ") + strerror(errno));
+	}
+	this->socketPath = socketPath;
+	unlink(socketPath.c_str()); //Left behind if an earlier service did not shut down cleanly.
+	if (bind(listeningSocket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == -1
+			|| listen(listeningSocket, SOMAXCONN) == -1) {
+		std::string reason = strerror(errno);
+		close(listeningSocket);
+		listeningSocket = -1;
+		throw std::runtime_error("Could not listen on " + socketPath + ": " + reason);
+	}
+	std::cout << "Evaluation service listening on " << socketPath << std::endl;
+
+	while (!stopping) {
+		joinFinishedClients();
+		pollfd request = {listeningSocket, POLLIN, 0};
+		if (poll(&request, 1, STOP_CHECK_INTERVAL_MS) <= 0) {
+			continue;
+		}
+		int clientSocket = accept(listeningSocket, nullptr, nullptr);
+		if (clientSocket == -1) {
+			continue;
+		}
+		int clientId = nextClientId++;
+		clientThreads[clientId] = std::thread(&EvaluationService::serveClient, this, clientSocket, clientId);
+	}
+
+	close(listeningSocket);
+	listeningSocket = -1;
+	unlink(socketPath.c_str());
+	for (std::map<int, std::thread>::iterator client = clientThreads.begin(); client != clientThreads.end(); client++) {
+		client->second.join();
+	}
+	clientThreads.clear();
+	std::lock_guard<std::mutex> lock(finishedClientsMutex);
+	finishedClients.clear();
+}
+
+void EvaluationService::joinFinishedClients() {
+	std::vector<int> finished;
+	{
+		std::lock_guard<std::mutex> lock(finishedClientsMutex);
+		finished.swap(finishedClients);
+	}
+	for (std::vector<int>::const_iterator clientId = finished.begin(); clientId != finished.end(); clientId++) {
+		std::map<int, std::thread>::iterator client = clientThreads.find(*clientId);
+		if (client != clientThreads.end()) {
+			client->second.join(); //The thread is done serving, so this only waits for it to return.
+			clientThreads.erase(client);
+		}
+	}
+}
+
+void EvaluationService::serveClient(int clientSocket, int clientId) {
+	bool greeted = false;
+	RequestHeader request;
+	while (readFully(clientSocket, &request, sizeof(request), stopping)) {
+		if (request.payloadBytes > MAX_PAYLOAD_BYTES) {
+			break; //We would not find the start of the next request, so there is nothing sensible left to do.
+		}
+		std::vector<char> payload(request.payloadBytes);
+		if (request.payloadBytes > 0 && !readFully(clientSocket, &payload[0], payload.size(), stopping)) {
+			break;
+		}
+
+		std::vector<char> response;
+		ResponseHeader header = {ok, 0};
+		try {
+			handleRequest(clientId, request.type, payload, greeted, response);
+		} catch (const std::exception& e) {
+			header.status = failed;
+			std::string message = e.what();
+			response.assign(message.begin(), message.end());
+		}
+		header.payloadBytes = response.size();
+		if (!writeFully(clientSocket, &header, sizeof(header))
+				|| (!response.empty() && !writeFully(clientSocket, &response[0], response.size()))) {
+			break;
+		}
+	}
+	close(clientSocket);
+
+	{
+		std::lock_guard<std::mutex> lock(estimatorMutex);
+		clientPopulations.erase(clientId);
+	}
+	//Letting run join this thread, so the threads of long gone clients do not pile up.
+	std::lock_guard<std::mutex> lock(finishedClientsMutex);
+	finishedClients.push_back(clientId);
+}
+
+void EvaluationService::checkClientSetup(const std::string& clientSceneFile, const std::vector<double>& clientSensorSpecs,
+		const std::vector<double>& clientStartLocation, bool clientPlanLoopsAround, double clientVisibilityMeshFaceFraction) const {
+	if (canonicalPath(clientSceneFile) != sceneFile) {
+		throw std::invalid_argument("This evaluation service serves the scene " + sceneFile + ", not " + clientSceneFile + ".");
+	}
+	if (clientSensorSpecs != sensorSpecs || clientStartLocation != startLocation || clientPlanLoopsAround != planLoopsAround
+			|| clientVisibilityMeshFaceFraction != visibilityMeshFaceFraction) {
+		throw std::invalid_argument("This evaluation service was started with different sensor parameters, start location, "
+				"looping setting or visibility mesh than the client asked for.");
+	}
+}
+
+void EvaluationService::handleRequest(int clientId, uint32_t type, const std::vector<char>& payload, bool& greeted,
+		std::vector<char>& response) {
+	PayloadReader reader(payload);
+	if (type == hello) {
+		uint32_t version = reader.readValue<uint32_t>();
+		if (version != PROTOCOL_VERSION) {
+			throw std::invalid_argument("The client speaks a different version of the evaluation service protocol.");
+		}
+		std::string clientSceneFile = reader.readString();
+		std::vector<double> clientSensorSpecs = reader.readDoubles();
+		std::vector<double> clientStartLocation = reader.readDoubles();
+		bool clientPlanLoopsAround = reader.readValue<uint8_t>() != 0;
+		double clientVisibilityMeshFaceFraction = reader.readValue<double>();
+		reader.finish();
+		checkClientSetup(clientSceneFile, clientSensorSpecs, clientStartLocation, clientPlanLoopsAround, clientVisibilityMeshFaceFraction);
+		greeted = true;
+		return;
+	}
+	if (!greeted) {
+		throw std::logic_error("Clients have to say hello before sending other requests.");
+	}
+
+	switch (type) {
+	case evaluate_plans: {
+		bool memoization = reader.readValue<uint8_t>() != 0;
+		bool disableEnergyLimit = reader.readValue<uint8_t>() != 0;
+		std::vector<Plan> plans = reader.readPlans();
+		reader.finish();
+		std::vector<std::vector<double> > scores;
+		{
+			std::lock_guard<std::mutex> lock(estimatorMutex);
+			scores = estimator.evaluatePlans(plans, memoization, disableEnergyLimit);
+		}
+		writeValue<uint32_t>(response, scores.size());
+		for (size_t i = 0; i < scores.size(); i++) {
+			writeDoubles(response, scores[i]);
+		}
+		break;
+	}
+	case evaluate_plan: {
+		bool memoization = reader.readValue<uint8_t>() != 0;
+		bool disableEnergyLimit = reader.readValue<uint8_t>() != 0;
+		Plan plan = reader.readPlan();
+		reader.finish();
+		std::lock_guard<std::mutex> lock(estimatorMutex);
+		writeDoubles(response, estimator.evaluatePlan(plan, memoization, nothing, disableEnergyLimit));
+		break;
+	}
+	case get_number_of_boxes: {
+		reader.finish();
+		std::lock_guard<std::mutex> lock(estimatorMutex);
+		writeValue<int32_t>(response, estimator.getNumberOfBoxes());
+		break;
+	}
+	case get_max_allowed_energy: {
+		reader.finish();
+		std::lock_guard<std::mutex> lock(estimatorMutex);
+		writeValue<double>(response, estimator.getMaxAllowedEnergy());
+		break;
+	}
+	case get_simple_plans: {
+		reader.finish();
+		std::lock_guard<std::mutex> lock(estimatorMutex);
+		writePlans(response, estimator.getSimplePlans());
+		break;
+	}
+	case update_memoised_edges: {
+		std::vector<Plan> population = reader.readPlans();
+		reader.finish();
+		std::lock_guard<std::mutex> lock(estimatorMutex);
+		clientPopulations[clientId].swap(population);
+		//Keep the edges of every connected experiment, not only those of the one asking.
+		std::vector<Plan> allPopulations;
+		for (std::map<int, std::vector<Plan> >::const_iterator client = clientPopulations.begin(); client != clientPopulations.end(); client++) {
+			allPopulations.insert(allPopulations.end(), client->second.begin(), client->second.end());
+		}
+		writeValue<int32_t>(response, estimator.updateMemoisedEdges(allPopulations));
+		break;
+	}
+	case get_statistics: {
+		reader.finish();
+		std::lock_guard<std::mutex> lock(estimatorMutex);
+		writeStatistics(response, estimator.getStatistics());
+		break;
+	}
+	case get_visibility_mesh_face_count: {
+		reader.finish();
+		std::lock_guard<std::mutex> lock(estimatorMutex);
+		writeValue<int32_t>(response, estimator.getVisibilityMeshFaceCount());
+		break;
+	}
+	default:
+		throw std::invalid_argument("Unknown request type.");
+	}
+}
+
+} /* namespace evolutionary_inspection_plan_evaluation */
@@ -0,0 +1,162 @@
+/*
+ * EvaluationService.h
+ *
+ * A long-lived process owning one PlanCoverageEstimator, which local optimizer processes send plans to over a UNIX
+ * domain socket. This way, the scene is loaded, the grid classified and the energy limit calibrated once per host,
+ * and the memo and render contexts stay warm across experiments.
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef EVALUATIONSERVICE_H_
+#define EVALUATIONSERVICE_H_
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <stdint.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace evolutionary_inspection_plan_evaluation {
+
+class PlanCoverageEstimator;
+
+/**
+ * The wire protocol of the evaluation service. All numbers are in the host's byte order, since clients always run on the
+ * same host. Every request is a RequestHeader followed by payloadBytes of payload, and is answered by a ResponseHeader
+ * followed by its payload. On errors, the response payload is the error message.
+ *
+ * Payloads are built from these pieces:
+ * - A plan is a uint32 number of genes, followed by each gene as a uint32 length and that many doubles.
+ * - A plan list is a uint32 number of plans, followed by each plan.
+ * - A string is a uint32 length, followed by that many bytes.
+ * - A double list is a uint32 length, followed by that many doubles.
+ */
+namespace service_protocol {
+
+	const uint32_t PROTOCOL_VERSION = 3;
+
+	enum request_type {
+		///Must be the first request of a client. Payload: uint32 protocol version, string scene file, double list of sensor
+		///specs, double list start location (empty if none), uint8 planLoopsAround, double visibilityMeshFaceFraction.
+		///Fails unless these match the service's setup.
+		hello = 1,
+		///Payload: uint8 memoization, uint8 disableEnergyLimit, plan list. Response: a double list of scores for each plan.
+		evaluate_plans = 2,
+		///Payload: uint8 memoization, uint8 disableEnergyLimit, plan. Response: double list of scores.
+		evaluate_plan = 3,
+		///No payload. Response: int32 number of boxes.
+		get_number_of_boxes = 4,
+		///No payload. Response: double.
+		get_max_allowed_energy = 5,
+		///No payload. Response: plan list.
+		get_simple_plans = 6,
+		///Payload: plan list, the client's current population. Response: int32 number of memoized edges kept.
+		update_memoised_edges = 7,
+		///No payload. Response: the EvaluationStatistics of the whole service: its counters as uint64s, then its times as
+		///doubles, each in the order they are declared.
+		get_statistics = 8,
+		///No payload. Response: int32 number of faces of the simplified model rendered, 0 if the model itself is rendered.
+		get_visibility_mesh_face_count = 9
+	};
+
+	enum response_status {
+		ok = 0,
+		failed = 1
+	};
+
+	struct RequestHeader {
+		uint32_t type;			///<A request_type.
+		uint32_t payloadBytes;
+	};
+
+	struct ResponseHeader {
+		uint32_t status;		///<A response_status.
+		uint32_t payloadBytes;
+	};
+
+	///The largest payload we accept, to protect the service from corrupt requests.
+	const uint32_t MAX_PAYLOAD_BYTES = 1u << 30;
+}
+
+/**
+ * Serves plan evaluations to local clients over a UNIX domain socket. Each client gets its own thread, and requests
+ * from all clients are handed to the estimator one at a time. Batches sent with evaluate_plans are spread over the
+ * estimator's own threads, as usual.
+ *
+ * Since several experiments share the memo, the memo is pruned to the union of the latest populations sent by each
+ * connected client, rather than to the population of whichever client asked last.
+ */
+class EvaluationService {
+
+private:
+	PlanCoverageEstimator& estimator;
+	std::string sceneFile;					///<The canonical path of the scene the estimator was made for.
+	std::vector<double> sensorSpecs;
+	std::vector<double> startLocation;		///<Empty if the estimator has no start location.
+	bool planLoopsAround;
+	double visibilityMeshFaceFraction;
+
+	std::mutex estimatorMutex;				///<Held while the estimator works on a request. Also guards clientPopulations.
+	///The latest population sent with update_memoised_edges by each connected client, indexed by client ID.
+	std::map<int, std::vector<std::vector<std::vector<double> > > > clientPopulations;
+	int nextClientId;
+
+	std::string socketPath;
+	int listeningSocket;					///<-1 when not listening.
+	std::atomic<bool> stopping;
+	std::map<int, std::thread> clientThreads;	///<The thread serving each client, by client ID. Only touched by the thread in run.
+	std::mutex finishedClientsMutex;		///<Guards finishedClients.
+	std::vector<int> finishedClients;		///<Clients whose threads are done, but not yet joined by run.
+
+	///Joins the threads of the clients that have disconnected. Called by run between connections.
+	void joinFinishedClients();
+
+	///Reads requests from one client and answers them, until the client disconnects or the service stops.
+	void serveClient(int clientSocket, int clientId);
+
+	/**
+	 * Carries out one request.
+	 * @param[in,out] greeted Whether the client has sent a successful hello. Requests other than hello fail until it has.
+	 * @param[out] response The response payload.
+	 * @throws std::exception with a message for the client, if the request fails.
+	 */
+	void handleRequest(int clientId, uint32_t type, const std::vector<char>& payload, bool& greeted, std::vector<char>& response);
+
+	///Throws std::invalid_argument unless the setup a client sent in its hello matches ours.
+	void checkClientSetup(const std::string& clientSceneFile, const std::vector<double>& clientSensorSpecs,
+			const std::vector<double>& clientStartLocation, bool clientPlanLoopsAround, double clientVisibilityMeshFaceFraction) const;
+
+	//Here, I'm disallowing copy-constructors for this object, as it owns a socket and threads.
+	EvaluationService(const EvaluationService&) = delete;
+	EvaluationService& operator=(const EvaluationService&) = delete;
+
+public:
+
+	/**
+	 * @param estimator The estimator to serve. Has to outlive the service, and should not be used by anyone else while the service runs.
+	 * The remaining parameters are the ones the estimator was made with. Clients have to give the same in their hello.
+	 */
+	EvaluationService(PlanCoverageEstimator& estimator, const std::string& sceneFile, const std::vector<double>& sensorSpecs,
+			const std::vector<double>* startLocation, bool planLoopsAround, double visibilityMeshFaceFraction);
+
+	~EvaluationService();
+
+	/**
+	 * Listens on the given socket path, and serves clients until stop is called. Replaces any stale socket file at the path.
+	 * @throws std::runtime_error if the socket cannot be set up.
+	 */
+	void run(const std::string& socketPath);
+
+	/**
+	 * Makes run disconnect all clients and return, within a fraction of a second. Only sets a flag, so it is safe to
+	 * call from any thread, or from a signal handler.
+	 */
+	void stop();
+};
+
+} /* namespace evolutionary_inspection_plan_evaluation */
+
+#endif /* EVALUATIONSERVICE_H_ */
@@ -0,0 +1,79 @@
+/*
+ * EvaluationStatistics.h
+ *
+ * Counters describing the work done while evaluating plans. Readable from Python, to help tune memoization and
+ * sampling settings based on real runs.
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef EVALUATIONSTATISTICS_H_
+#define EVALUATIONSTATISTICS_H_
+
+#include <algorithm>
+
+namespace evolutionary_inspection_plan_evaluation {
+
+struct EvaluationStatistics {
+	unsigned long plansEvaluated;		///<Plans given to evaluatePlan, evaluatePlans and evaluateMutation.
+	unsigned long planCacheHits;		///<Plans whose scores were already known.
+	unsigned long memoHits;				///<Edges found in the edge memo.
+	unsigned long memoMisses;			///<Edges we had to render.
+	unsigned long sharedCacheHits;		///<Edges found in the shared edge cache (see PlanCoverageEstimator::attachSharedEdgeCache).
+	unsigned long prefixEdgesSkipped;	///<Edges we did not look at, since the coverage of the plan prefix containing them was known.
+	unsigned long framesRendered;		///<Camera images rendered.
+	unsigned long framesSkipped;		///<Camera images we avoided rendering, thanks to memo hits.
+	unsigned long long pixelsScanned;	///<Pixels we read colors from.
+
+	///Pieces of edges rendered by the work-stealing scheduler in evaluatePlans. Long edges are split into several.
+	unsigned long edgeSubtasks;
+	unsigned long subtaskSteals;		///<Edge pieces taken from another thread's queue.
+	unsigned long maxQueueDepth;		///<The most edge pieces waiting in one thread's queue at once.
+	unsigned long speculativeEdges;		///<Edges rendered ahead of time. See PlanCoverageEstimator::startSpeculativePrefetch.
+
+	///The current size of the memo. Only filled in by PlanCoverageEstimator::getStatistics.
+	unsigned long memoEdges;
+	unsigned long memoPatterns;			///<Distinct coverage patterns among the memoized edges.
+	unsigned long memoBytes;			///<Estimated memory used by the memo.
+
+	///Time spent in each stage of evaluation, in seconds. When evaluatePlans runs on several threads, the stage
+	///times are summed over the threads, and may add up to more than totalSeconds.
+	double energySeconds;				///<Decoding plans and calculating their energy use.
+	double edgeCoverageSeconds;			///<Finding what the edges of plans cover, including rendering and memo look-ups.
+	double renderSeconds;				///<Rendering camera images. Part of edgeCoverageSeconds.
+	double pixelScanSeconds;			///<Reading colors from rendered images. Part of edgeCoverageSeconds.
+	double scoringSeconds;				///<Turning covered triangles into coverage scores.
+	double totalSeconds;				///<Everything.
+
+	EvaluationStatistics()
+	:plansEvaluated(0), planCacheHits(0), memoHits(0), memoMisses(0), sharedCacheHits(0), prefixEdgesSkipped(0),
+	 framesRendered(0), framesSkipped(0), pixelsScanned(0), edgeSubtasks(0), subtaskSteals(0), maxQueueDepth(0), speculativeEdges(0), memoEdges(0), memoPatterns(0), memoBytes(0),
+	 energySeconds(0), edgeCoverageSeconds(0), renderSeconds(0), pixelScanSeconds(0), scoringSeconds(0), totalSeconds(0){}
+
+	///Adds the counts and times of other to this. The memo sizes are snapshots, and are not added. Of the queue depths, the largest is kept.
+	void add(const EvaluationStatistics& other) {
+		plansEvaluated += other.plansEvaluated;
+		planCacheHits += other.planCacheHits;
+		memoHits += other.memoHits;
+		memoMisses += other.memoMisses;
+		sharedCacheHits += other.sharedCacheHits;
+		prefixEdgesSkipped += other.prefixEdgesSkipped;
+		framesRendered += other.framesRendered;
+		framesSkipped += other.framesSkipped;
+		pixelsScanned += other.pixelsScanned;
+		edgeSubtasks += other.edgeSubtasks;
+		subtaskSteals += other.subtaskSteals;
+		maxQueueDepth = std::max(maxQueueDepth, other.maxQueueDepth);
+		speculativeEdges += other.speculativeEdges;
+		energySeconds += other.energySeconds;
+		edgeCoverageSeconds += other.edgeCoverageSeconds;
+		renderSeconds += other.renderSeconds;
+		pixelScanSeconds += other.pixelScanSeconds;
+		scoringSeconds += other.scoringSeconds;
+		totalSeconds += other.totalSeconds;
+	}
+};
+
+} /* namespace evolutionary_inspection_plan_evaluation */
+
+#endif /* EVALUATIONSTATISTICS_H_ */
@@ -8,6 +8,13 @@
 #include "PlanCoverageEstimator.h"
 
 #include <boost/exception/diagnostic_information.hpp>
+#include <chrono>
+#include <limits>
+#include <stdexcept>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <thread>
+#include <unistd.h>
 #include <osg/LightModel>
 #include <osg/ShapeDrawable>
 #include <osgDB/ReadFile>
@@ -18,14 +25,76 @@
 #include "../../Utility_Functions/src/HelperMethods.h"
 #include "../../Utility_Functions/src/KeyboardInputHandler.h"
 #include "../../Utility_Functions/src/OsgHelpers.h"
+#include "BoxCollisionMatrix.h"
 #include "PlanEnergyEvaluator.h"
 #include "PlanInterpreterBoxOrder.h"
+#include "SceneRegistry.h"
 #include "../../Utility_Functions/src/SceneKeeper.h"
+#include "../../Utility_Functions/src/SharedEdgeCache.h"
+#include "../../Utility_Functions/src/ThreadPool.h"
+#include "../../Utility_Functions/src/VisibilityMesh.h"
+#include "../../Utility_Functions/src/WorkStealingScheduler.h"
 #include "../../Utility_Functions/src/Constants.h"
 
 using namespace utility_functions;
 namespace evolutionary_inspection_plan_evaluation {
 
+namespace {
+	///The current time in seconds, for timing the stages of evaluation.
+	double now() {
+		return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	///One camera traversal (a straight move with a fixed heading) of an edge we need to render.
+	struct CameraTraversal {
+		size_t edgeTask;	///<The edge the traversal is part of. Loops give several traversals per edge.
+		osg::ref_ptr<osg::Vec3Array> samplingPositions;	///<Computed once, and shared by all subtasks rendering the traversal.
+		osg::Vec3d heading;
+	};
+
+	///The coverage seen by one thread of the parts of an edge it rendered.
+	struct PartialEdgeCoverage {
+		boost::dynamic_bitset<> coverage;
+		unsigned int numFrames;
+
+		PartialEdgeCoverage()
+		:numFrames(0){}
+	};
+
+	///Adds what a camera has rendered to the statistics.
+	void addRenderStatistics(EvaluationStatistics& statistics, const RenderStatistics& rendering) {
+		statistics.framesRendered += rendering.framesRendered;
+		statistics.pixelsScanned += rendering.pixelsScanned;
+		statistics.renderSeconds += rendering.renderSeconds;
+		statistics.pixelScanSeconds += rendering.pixelScanSeconds;
+	}
+}
+
+class PlanCoverageEstimator::StatisticsScope {
+private:
+	PlanCoverageEstimator& estimator;
+public:
+	explicit StatisticsScope(PlanCoverageEstimator& estimator)
+	:estimator(estimator){
+		if (estimator.statisticsCallDepth++ == 0) {
+			estimator.stopSpeculativePrefetch(); //Speculation only uses time we would otherwise sit idle.
+			estimator.mainContext.statistics = EvaluationStatistics();
+			estimator.cam_estimator->resetRenderStatistics();
+			estimator.statisticsCallStart = now();
+		}
+	}
+
+	~StatisticsScope() {
+		if (--estimator.statisticsCallDepth == 0) {
+			EvaluationStatistics call = estimator.mainContext.statistics;
+			addRenderStatistics(call, estimator.cam_estimator->getRenderStatistics());
+			call.totalSeconds = now() - estimator.statisticsCallStart;
+			estimator.lastCallStatistics = call;
+			estimator.cumulativeStatistics.add(call);
+		}
+	}
+};
+
 ///Used from the Python interface.
 std::vector<std::vector<double> > viewMatrixSelector(
 		std::string sceneFileName) {
@@ -40,83 +109,217 @@ void PlanCoverageEstimator::storePlanImage(const std::vector<std::vector<double>
 }
 
 
-boost::dynamic_bitset<> PlanCoverageEstimator::evaluateMemoisedPlan(const std::vector<std::vector<double> >& plan){
-
-	osg::Vec3d previousLocation;
-	std::string previousPlanPartName = "None";
-	if (startLocation != nullptr) {
+std::string PlanCoverageEstimator::getEdgeName(const std::vector<std::vector<double> >& plan, size_t i,
+		const std::string& currentPlanPartName) const{
+	std::string previousPlanPartName;
+	if (i != 0) {
+		previousPlanPartName = vectorToString(plan[i - 1], 1);
+	} else if (startLocation != nullptr) {
 		previousPlanPartName = "start";
-		previousLocation = osg::Vec3d((*startLocation)[0], (*startLocation)[1],
-				(*startLocation)[2]);
+	} else {
+		previousPlanPartName = "None";
 	}
+	return previousPlanPartName + "-" + currentPlanPartName; //The string we use to store and look up the current edge.
+}
 
-	boost::dynamic_bitset<> observedColors(sceneKeeper->getTriangleCount());
-	int memoizedCount = 0;
-	int notmemoizedCount = 0;
-	for (size_t i = 0; i < plan.size(); i++) {
-		//Each part of a plan is a vector of doubles - representing a single viewpoint. The first element of the vector is the position of that viewpoint.
-		std::vector<double> currentPlanPart = plan[i];
-		if (i != 0) {
-			previousPlanPartName = vectorToString(plan[i - 1], 1);
+CoveragePattern PlanCoverageEstimator::findMemoisedEdge(const std::string& edgeName, size_t node, unsigned int* numFrames/*=nullptr*/) {
+	CoveragePattern coverage = memoShards[node].find(edgeName, numFrames);
+	if (coverage) {
+		return coverage;
+	}
+	for (size_t otherNode = 0; otherNode < memoShards.size(); otherNode++) {
+		if (otherNode == node) {
+			continue;
+		}
+		unsigned int otherNumFrames = 0;
+		coverage = memoShards[otherNode].find(edgeName, &otherNumFrames);
+		if (coverage) {
+			//Copying the edge, so the next lookups from this node read local memory. The copy is made by the calling thread, which runs on the node.
+			if (numFrames != nullptr) {
+				*numFrames = otherNumFrames;
+			}
+			return memoShards[node].insert(edgeName, *coverage, otherNumFrames);
 		}
-		std::string currentPlanPartName = vectorToString(currentPlanPart,
-				currentPlanPart.size());
-		std::string memoizationIndex = previousPlanPartName + "-"
-				+ currentPlanPartName; //The string we use to store and look up the current edge.
+	}
+	return CoveragePattern();
+}
 
-		//std::cout << "Evaluating "<< memoizationIndex << std::endl;
+bool PlanCoverageEstimator::isMemoised(const std::string& edgeName) const {
+	for (std::vector<EdgeCoverageMemo>::const_iterator shard = memoShards.begin(); shard != memoShards.end(); shard++) {
+		if (shard->find(edgeName)) {
+			return true;
+		}
+	}
+	return false;
+}
 
-		boost::dynamic_bitset<> currentlyObservedColors(sceneKeeper->getTriangleCount());
-		if (memoisedEdgesBitset->find(memoizationIndex)	== memoisedEdgesBitset->end()) {
-			notmemoizedCount+=1;
-			//Element not memoized. Calculating manually.
-			osg::ref_ptr<osg::Vec3dArray> decodedPositions = new osg::Vec3dArray;
-			osg::ref_ptr<osg::Vec3dArray> decodedAngles = new osg::Vec3dArray;
-			if (previousPlanPartName != "start"	&& previousPlanPartName != "None") {
-				previousLocation = planInterpreter->getPositionFromGene(plan, i - 1);
-			}
-			if (previousPlanPartName == "None") {
-				//In the special case that this is the first point, we have no previous point.
-				//This will normally result in no decoded edges (which will simply result in no observed primitives),
-				//but in the case that the plan starts with a loop, we will have edges also in this first part of the plan.
-				planInterpreter->InterpretOnePlanPoint(nullptr, currentPlanPart, *decodedPositions, *decodedAngles);
-
-			} else {
-				decodedPositions->push_back(previousLocation); //Move starts at previous location
-				planInterpreter->InterpretOnePlanPoint(&previousLocation,currentPlanPart, *decodedPositions, *decodedAngles);
-			}
-			if (decodedPositions->size() < 2) {
-				//The decoding only gave us a single waypoint. No edge to traverse. This should only happen when decoding the first point
-				assert(i == 0);
-				continue;
-			}
-			//Fetched the next viewpoints and angles (often this will just be one viewpoint). Now, recording and storing their coverage.
-			for (size_t edgeNr = 0; edgeNr < decodedAngles->size(); edgeNr++) {
-				//Iterates over all the edges we just decoded (usually just one, unless we decoded a complete loop).
-				osg::Vec3d previousNode = decodedPositions->at(edgeNr);
-				osg::Vec3d nextNode = decodedPositions->at(edgeNr + 1);
-				osg::Vec3d angle = decodedAngles->at(edgeNr);
-				cam_estimator->GetColorsDuringTraversal(previousNode, nextNode,
-						angle, coloredScene, currentlyObservedColors);
-				observedColors |= currentlyObservedColors; //bitwise OR
-				(*memoisedEdgesBitset)[previousPlanPartName + "-"
-						+ currentPlanPartName] = currentlyObservedColors;
-			}
+size_t PlanCoverageEstimator::numMemoisedEdges() const {
+	if (memoShards.size() == 1) {
+		return memoShards[0].size();
+	}
+	//Edges used on several nodes are in several shards.
+	std::set<std::string> edgeNames;
+	for (std::vector<EdgeCoverageMemo>::const_iterator shard = memoShards.begin(); shard != memoShards.end(); shard++) {
+		shard->collectEdgeNames(edgeNames);
+	}
+	return edgeNames.size();
+}
 
-		} else {
-			memoizedCount+=1;
-			//Element memoized. Fetching values.
-			boost::dynamic_bitset<> memoizedResult =
-					memoisedEdgesBitset->at(memoizationIndex);
-			observedColors |= memoizedResult;
+double PlanCoverageEstimator::calculateCoverage(const boost::dynamic_bitset<>& observedColors, const EvaluationContext& context) const {
+	const boost::dynamic_bitset<>* coveredTriangles = &observedColors;
+	boost::dynamic_bitset<> expandedColors;
+	if (visibilityMesh != nullptr) {
+		expandedColors = visibilityMesh->expandCoverage(observedColors);
+		coveredTriangles = &expandedColors;
+	}
+	if (context.triangleAreas == nullptr) {
+		return sceneKeeper->calculateCoverage(*coveredTriangles);
+	}
+	//Summing in the same order as TriangleData::calculateCoveredArea, so we give exactly the same score.
+	const std::vector<double>& triangleAreas = *context.triangleAreas;
+	double coveredArea = 0;
+	for (size_t triangleId = coveredTriangles->find_first(); triangleId != boost::dynamic_bitset<>::npos;
+			triangleId = coveredTriangles->find_next(triangleId)) {
+		coveredArea += triangleAreas[triangleId];
+	}
+	return 1.0 - (coveredArea / sceneKeeper->getTotalArea());
+}
+
+CoveragePattern PlanCoverageEstimator::getEdgeCoverage(const std::vector<std::vector<double> >& plan, size_t i,
+		const std::string& memoizationIndex, EvaluationContext& context){
+	//std::cout << "Evaluating "<< memoizationIndex << std::endl;
+	unsigned int numMemoizedFrames = 0;
+	CoveragePattern memoizedResult;
+	{
+		std::lock_guard<std::mutex> lock(memoMutex);
+		memoizedResult = findMemoisedEdge(memoizationIndex, context.node, &numMemoizedFrames);
+	}
+	if (memoizedResult) {
+		//Element memoized. Fetching values.
+		context.statistics.memoHits++;
+		context.statistics.framesSkipped += numMemoizedFrames;
+		return memoizedResult;
+	}
+
+	boost::dynamic_bitset<> currentlyObservedColors(numVisibleFaces);
+	//Before rendering, checking if another evaluator process already rendered this edge, or is rendering it.
+	bool sharedClaim = false;
+	size_t sharedSlot = 0;
+	if (sharedEdgeCache != nullptr) {
+		SharedEdgeCache::ClaimResult claim = sharedEdgeCache->claim(hash128(memoizationIndex), currentlyObservedColors, sharedSlot);
+		if (claim == SharedEdgeCache::claim_found ||
+				(claim == SharedEdgeCache::claim_taken && sharedEdgeCache->waitForClaimed(sharedSlot, currentlyObservedColors))) {
+			context.statistics.sharedCacheHits++;
+			std::lock_guard<std::mutex> lock(memoMutex);
+			return memoShards[context.node].insert(memoizationIndex, currentlyObservedColors);
 		}
+		sharedClaim = claim == SharedEdgeCache::claim_granted;
+	}
+	//Rendering without holding the lock, so other threads can use the memo meanwhile. If two threads render the same
+	//edge at once, both get the same result, and the memo keeps the first.
+	context.statistics.memoMisses++;
+	unsigned long framesRenderedBefore = context.camera->getRenderStatistics().framesRendered;
+
+	//Element not memoized. Calculating manually.
+	try {
+		osg::ref_ptr<osg::Vec3dArray> decodedPositions = new osg::Vec3dArray;
+		osg::ref_ptr<osg::Vec3dArray> decodedAngles = new osg::Vec3dArray;
+		decodeEdge(plan, i, *decodedPositions, *decodedAngles);
+		//Fetched the next viewpoints and angles (often this will just be one viewpoint). Now, recording and storing their coverage.
+		for (size_t edgeNr = 0; edgeNr < decodedAngles->size(); edgeNr++) {
+			//Iterates over all the edges we just decoded (usually just one, unless we decoded a complete loop).
+			osg::Vec3d previousNode = decodedPositions->at(edgeNr);
+			osg::Vec3d nextNode = decodedPositions->at(edgeNr + 1);
+			osg::Vec3d angle = decodedAngles->at(edgeNr);
+			context.camera->GetColorsDuringTraversal(previousNode, nextNode,
+					angle, context.scene, currentlyObservedColors);
+		}
+	} catch (...) {
+		//Letting processes waiting for our claim render the edge themselves.
+		if (sharedClaim) {
+			sharedEdgeCache->abandon(sharedSlot);
+		}
+		throw;
+	}
+	if (sharedClaim) {
+		sharedEdgeCache->publish(sharedSlot, currentlyObservedColors);
+	}
+	unsigned int numFrames = context.camera->getRenderStatistics().framesRendered - framesRenderedBefore;
+	std::lock_guard<std::mutex> lock(memoMutex);
+	return memoShards[context.node].insert(memoizationIndex, currentlyObservedColors, numFrames);
+}
+
+void PlanCoverageEstimator::decodeEdge(const std::vector<std::vector<double> >& plan, size_t i,
+		osg::Vec3dArray& decodedPositions, osg::Vec3dArray& decodedAngles) const{
+	const std::vector<double>& currentPlanPart = plan[i];
+	osg::Vec3d previousLocation;
+	if (i != 0) {
+		previousLocation = planInterpreter->getPositionFromGene(plan, i - 1);
+	} else if (startLocation != nullptr) {
+		previousLocation = osg::Vec3d((*startLocation)[0], (*startLocation)[1], (*startLocation)[2]);
+	}
+	if (i == 0 && startLocation == nullptr) {
+		//In the special case that this is the first point, we have no previous point.
+		//This will normally result in no decoded edges (which will simply result in no observed primitives),
+		//but in the case that the plan starts with a loop, we will have edges also in this first part of the plan.
+		planInterpreter->InterpretOnePlanPoint(nullptr, currentPlanPart, decodedPositions, decodedAngles);
+
+	} else {
+		decodedPositions.push_back(previousLocation); //Move starts at previous location
+		planInterpreter->InterpretOnePlanPoint(&previousLocation,currentPlanPart, decodedPositions, decodedAngles);
+	}
+	//If the decoding only gave us a single waypoint, there is no edge to traverse, and we observe nothing.
+	//This should only happen when decoding the first point.
+	assert(decodedPositions.size() >= 2 || i == 0);
+}
+
+boost::dynamic_bitset<> PlanCoverageEstimator::evaluateMemoisedPlan(const std::vector<std::vector<double> >& plan,
+		EvaluationContext& context){
+
+	std::vector<std::string> planPartNames;
+	planPartNames.reserve(plan.size());
+	for (size_t i = 0; i < plan.size(); i++) {
+		planPartNames.push_back(vectorToString(plan[i], plan[i].size()));
+	}
 
+	boost::dynamic_bitset<> observedColors(numVisibleFaces);
+	//If we already know the coverage of the start of this plan, we continue from where that leaves off.
+	CoveragePattern knownPrefixCoverage;
+	size_t knownPrefixLength;
+	{
+		std::lock_guard<std::mutex> lock(memoMutex);
+		knownPrefixLength = planPrefixes.findLongestKnownPrefix(planPartNames, knownPrefixCoverage);
+	}
+	if (knownPrefixLength > 0) {
+		observedColors = *knownPrefixCoverage;
+		context.statistics.prefixEdgesSkipped += knownPrefixLength;
+	}
+	for (size_t i = knownPrefixLength; i < plan.size(); i++) {
+		if (i != knownPrefixLength && planPrefixes.isSnapshotDepth(i)) {
+			std::lock_guard<std::mutex> lock(memoMutex);
+			planPrefixes.storePrefix(planPartNames, i, observedColors);
+		}
+		//Each part of a plan is a vector of doubles - representing a single viewpoint. The first element of the vector is the position of that viewpoint.
+		observedColors |= *getEdgeCoverage(plan, i, getEdgeName(plan, i, planPartNames[i]), context); //bitwise OR
+	}
+	if (plan.size() != knownPrefixLength && planPrefixes.isSnapshotDepth(plan.size())) {
+		std::lock_guard<std::mutex> lock(memoMutex);
+		planPrefixes.storePrefix(planPartNames, plan.size(), observedColors);
 	}
 
 	return observedColors;
 
 }
 
+std::vector<std::vector<double> > PlanCoverageEstimator::prepareForEvaluation(const std::vector<std::vector<double> >& plan) const{
+	std::vector<std::vector<double> > planCopy = plan;
+	//If we want to enforce looping, we simply reinsert the first waypoint in the end.
+	if(planLoopsAround && !plan.empty()){
+		planCopy.push_back(plan[0]);
+	}
+	return planCopy;
+}
+
 std::vector<double> PlanCoverageEstimator::evaluateEmptyPlan() const{
 	//Immediately giving the default score to empty plans can speed evaluation up.
 	double objectiveScores[] = { 1.0, 0 }; //The score for an empty plan. No coverage, no energy spent.
@@ -125,7 +328,8 @@ std::vector<double> PlanCoverageEstimator::evaluateEmptyPlan() const{
 	return scoreVector;
 }
 
-boost::dynamic_bitset<> PlanCoverageEstimator::evaluatePlanInternal(const std::vector<std::vector<double> >& plan,osg::ref_ptr<osg::Geode> geode) const{
+boost::dynamic_bitset<> PlanCoverageEstimator::evaluatePlanInternal(const std::vector<std::vector<double> >& plan,osg::ref_ptr<osg::Geode> geode,
+		EvaluationContext& context) const{
 
 	osg::ref_ptr<osg::Vec3dArray> plannedPositions = new osg::Vec3dArray(); //All points we will visit
 	osg::ref_ptr<osg::Vec3dArray> plannedAngles = new osg::Vec3dArray(); //The angle the AUV will point towards in those positions.
@@ -133,13 +337,13 @@ boost::dynamic_bitset<> PlanCoverageEstimator::evaluatePlanInternal(const std::v
     planInterpreter->InterpretPlan(plan, *plannedPositions, *plannedAngles);
 	osg::Vec3d currentLocation = (*plannedPositions)[0];
 
-	boost::dynamic_bitset<> observedColors(sceneKeeper->getTriangleCount());
+	boost::dynamic_bitset<> observedColors(numVisibleFaces);
 	//Going through each edge, calculating it's coverage.
 	for (unsigned int i = 0; i < plannedAngles->size(); i++) {
 		osg::Vec3d nextLocation = (*plannedPositions)[i + 1]; //We have one more position than angles, as positions refer to nodes, and angles to edges.
 		osg::Vec3d sensorHeading = (*plannedAngles)[i];
-		cam_estimator->GetColorsDuringTraversal(currentLocation, nextLocation,
-				sensorHeading, coloredScene, observedColors, textureRoot);
+		context.camera->GetColorsDuringTraversal(currentLocation, nextLocation,
+				sensorHeading, context.scene, observedColors, textureRoot);
 
 		currentLocation = nextLocation;
 	}
@@ -151,10 +355,13 @@ boost::dynamic_bitset<> PlanCoverageEstimator::evaluatePlanInternal(const std::v
 }
 
 PlanCoverageEstimator::~PlanCoverageEstimator() {
+	stopSpeculativePrefetch();
+	delete speculationContext.camera;
 	//delete planInterpreter;
-	delete sceneKeeper;
 	delete energyEvaluator;
 	delete cam_estimator;
+	delete sharedEdgeCache;
+	releaseWorkerContexts();
 }
 
 //Only valid if we have a "Box-Order" interpretation of our plan.
@@ -166,31 +373,97 @@ int PlanCoverageEstimator::getNumberOfBoxes() const{
 
 PlanCoverageEstimator::PlanCoverageEstimator(const std::string& sceneFileName,
 		const std::vector<double>& sensorSpecs, bool postProcessing/*=false*/, const std::vector<double>* startLocation/*=nullptr*/, bool planLoopsAround /*= false*/,
-		bool printerFriendly/*=true*/)
+		bool printerFriendly/*=true*/, double visibilityMeshFaceFraction/*=1.0*/)
 	:startLocation(startLocation),
-	 planLoopsAround(planLoopsAround){
-	std::cout << "Loading scene" << std::endl;
+	 planLoopsAround(planLoopsAround),
+	 sensorSpecs(sensorSpecs),
+	 postProcessing(postProcessing),
+	 threadPool(nullptr),
+	 numThreads(0),
+	 stopSpeculation(false),
+	 planPrefixes(PLAN_PREFIX_SNAPSHOT_INTERVAL),
+	 planResultCache(PLAN_RESULT_CACHE_CAPACITY),
+	 sharedEdgeCache(nullptr),
+	 nextParentHandle(0),
+	 statisticsCallDepth(0),
+	 statisticsCallStart(0){
+	if (!(visibilityMeshFaceFraction > 0 && visibilityMeshFaceFraction <= 1)) {
+		throw std::invalid_argument("ERROR! The visibility mesh needs a fraction of the model's triangles above 0, and at most 1.");
+	}
 	this->printerFriendly = printerFriendly;
-	sceneKeeper = new SceneKeeper(sceneFileName);
-	sceneKeeper->countTriangles();
+	memoShards.resize(numaTopology.numNodes());
+	sceneData = SceneRegistry::instance().acquire(sceneFileName);
+	sceneKeeper = sceneData->sceneKeeper.get();
+	coloredScene = sceneData->coloredScene;
+	visibilityMesh = nullptr;
+	numVisibleFaces = sceneKeeper->getTriangleCount();
+	size_t visibilityMeshFaces = std::max(VISIBILITY_MESH_MIN_FACES, (size_t) (visibilityMeshFaceFraction * numVisibleFaces));
+	if (!postProcessing && visibilityMeshFaces < numVisibleFaces) {
+		//Ranking plans during optimization does not need every triangle rendered. Post-processing renders the model itself.
+		std::lock_guard<std::mutex> lock(sceneData->visibilityMeshMutex);
+		SceneData::VisibilityMeshData& meshData = sceneData->visibilityMeshes[visibilityMeshFaces];
+		if (!meshData.mesh) {
+			meshData.mesh.reset(new VisibilityMesh(sceneKeeper->getTriangleStore(), visibilityMeshFaces));
+			meshData.scene = meshData.mesh->colorEachFaceDifferently();
+		}
+		visibilityMesh = meshData.mesh.get();
+		coloredScene = meshData.scene;
+		numVisibleFaces = visibilityMesh->getFaceCount();
+		std::cout << "Rendering a simplified model of " << numVisibleFaces << " faces instead of the " << sceneKeeper->getTriangleCount()
+				<< " triangles of the model" << std::endl;
+	}
 
-	memoisedEdgesBitset = new std::map<std::string, boost::dynamic_bitset<> >;
-	coloredScene = sceneKeeper->colorEachTriangleDifferently();
+	//Everything that influences how an edge is rendered goes into the fingerprint.
+	std::ostringstream setupDescription;
+	setupDescription << sceneFileName << "|" << sceneKeeper->getTriangleCount() << "|" << numVisibleFaces << "|" << vectorToString(sensorSpecs, sensorSpecs.size())
+			<< "|" << postProcessing;
+	if (startLocation != nullptr) {
+		setupDescription << "|" << vectorToString(*startLocation, startLocation->size());
+	}
+	setupFingerprint = hash128(setupDescription.str());
 
 	cam_estimator = new CameraEstimator(sensorSpecs);
+	mainContext.camera = cam_estimator;
+	mainContext.scene = coloredScene.get();
+	speculationContext.camera = nullptr;
 
 	bool usingMaxEnergy = true;
-		this->boxes = new osg::Vec3dArray();
-		planInterpreter = new PlanInterpreterBoxOrder(*sceneKeeper, boxes, *cam_estimator, coloredScene, startLocation, postProcessing);
+	{
+		//The boxes and circling plans only depend on the scene, so we make them only if no estimator of the scene has yet.
+		std::lock_guard<std::mutex> lock(sceneData->boxGridMutex);
+		BoxGrid& boxGrid = sceneData->boxGrid;
+		if (boxGrid.boxCenters == nullptr) {
+			planInterpreter = new PlanInterpreterBoxOrder(*sceneKeeper, nullptr, *cam_estimator, sceneData->coloredScene, startLocation, postProcessing);
+			planInterpreter->exportBoxGrid(boxGrid, false);
+			boxGrid.collisionMatrix = std::make_shared<BoxCollisionMatrix>(boxGrid.boxCenters, sceneKeeper->getScene(),
+					sceneFileName + ".collisions");
+			BoxCollisionMatrix& collisionMatrix = *boxGrid.collisionMatrix;
+			if (!postProcessing && collisionMatrix.getNumPairs() <= BOX_COLLISION_MATRIX_EAGER_PAIRS
+					&& collisionMatrix.getNumKnownPairs() < collisionMatrix.getNumPairs()) {
+				std::cout << "Checking the " << collisionMatrix.getNumPairs() << " edges between boxes for collisions" << std::endl;
+				collisionMatrix.precompute();
+				collisionMatrix.saveIfChanged();
+			}
+		} else {
+			planInterpreter = new PlanInterpreterBoxOrder(*sceneKeeper, boxGrid, *cam_estimator, sceneData->coloredScene, startLocation, postProcessing);
+		}
+		this->boxes = boxGrid.boxCenters;
 		if (!postProcessing) {
 			usingMaxEnergy = true;
-			planInterpreter->ProduceSimpleCirclingPlans();
+			if (!boxGrid.hasCirclingPlans) {
+				planInterpreter->ProduceSimpleCirclingPlans();
+				planInterpreter->exportBoxGrid(boxGrid, true);
+			}
 		} else {
 			//In post-processing runs, we do not estimate the max energy, to save time.
 			usingMaxEnergy = false;
 			planInterpreter->setPostProcessing(true);
 		}
-	energyEvaluator = new PlanEnergyEvaluator(usingMaxEnergy, this,	planInterpreter, *sceneKeeper);
+	}
+	if (postProcessing) {
+		prepareWorkerContexts();
+	}
+	energyEvaluator = new PlanEnergyEvaluator(usingMaxEnergy, this,	planInterpreter, *sceneKeeper, sceneData->boxGrid.collisionMatrix.get());
 
 }
 
@@ -207,26 +480,20 @@ std::vector<double> PlanCoverageEstimator::evaluatePlan(
 		throw std::logic_error("ERROR! Asked to plot image, but not given an OSG-drawable to plot to.");
 	}
 
-	//std::cout << "Evaluating plan: " << plan << std::endl;
-	if (plan.size() == 0) {
-		return evaluateEmptyPlan();
-	}
+	StatisticsScope statisticsScope(*this);
+	return evaluatePlanInContext(plan, memoization, how_to_plot, disableEnergyLimit, returnedDrawable, mainContext);
+}
 
-	//Making a copy of the plan that we can modify - so we are sure never to mess with the genotype.
-	std::vector<std::vector<double> > planCopy = plan;
-	//If we want to enforce looping, we simply reinsert the first waypoint in the end.
-	if(planLoopsAround){
-		planCopy.push_back(plan[0]);
-	}
+std::vector<double> PlanCoverageEstimator::evaluatePlanInContext(const std::vector<std::vector<double> > &plan, bool memoization,
+		plotting_style how_to_plot, bool disableEnergyLimit, osg::ref_ptr<osg::Group> returnedDrawable, EvaluationContext& context) {
 
-	double energyUsed = energyEvaluator->decodeAndCalculateEnergyUsage(planCopy);
-	if(!disableEnergyLimit && !energyEvaluator->energyWithinBounds(energyUsed)) {
-			//std::cout << "Current plan: " << plan << std::endl;
-			double objectiveScores[] = {1, energyUsed}; //For both objectives: 0 is best score.
-			std::vector<double> scoreVector(objectiveScores,
-											objectiveScores + sizeof(objectiveScores) / sizeof(double));
-			return scoreVector;
+	context.statistics.plansEvaluated++;
+	//Plots have to be produced anew, but for plain evaluations we may already know the answer.
+	PlanEvaluation evaluation;
+	if (startPlanEvaluation(plan, how_to_plot==nothing, disableEnergyLimit, evaluation, context)) {
+		return evaluation.scores;
 	}
+	const std::vector<std::vector<double> >& planCopy = evaluation.plan;
 
 	osg::ref_ptr<osg::Group> root = nullptr; //For plotting
 	osg::ref_ptr<osg::Geode> geode = nullptr; //For plotting
@@ -241,21 +508,25 @@ std::vector<double> PlanCoverageEstimator::evaluatePlan(
 	boost::dynamic_bitset<> observedColors; ///<Will contains zeros for all colors that have not been observed by the camera, and one for those that have.
 	std::set<int> coveredPrimitives;
 
+	double stageStart = now();
 	if (memoization) {
-		observedColors = evaluateMemoisedPlan(planCopy);
+		observedColors = evaluateMemoisedPlan(planCopy, context);
 	} else {
-		observedColors = evaluatePlanInternal(planCopy, geode);
+		observedColors = evaluatePlanInternal(planCopy, geode, context);
 	}
+	context.statistics.edgeCoverageSeconds += now() - stageStart;
 
+	stageStart = now();
 	double coverageScore;
 	if (how_to_plot!=nothing) {
-		coverageScore = sceneKeeper->calculateCoverage(observedColors, geode,
-				printerFriendly);
+		//Plots show the model's triangles, also when we rendered the simplified scene.
+		coverageScore = sceneKeeper->calculateCoverage(visibilityMesh != nullptr ? visibilityMesh->expandCoverage(observedColors) : observedColors,
+				geode, printerFriendly);
 
 	} else {
-		coverageScore = sceneKeeper->calculateCoverage(observedColors);
+		coverageScore = calculateCoverage(observedColors, context);
 	}
-	double objectiveScores[] = { coverageScore, energyUsed }; //For both objectives: 0 is best score.
+	context.statistics.scoringSeconds += now() - stageStart;
 
 	if (how_to_plot==normal) {
 
@@ -273,23 +544,66 @@ std::vector<double> PlanCoverageEstimator::evaluatePlan(
 		run_rotating_camera(geode);
 	}
 
-	std::vector<double> scoreVector(objectiveScores,
-			objectiveScores + sizeof(objectiveScores) / sizeof(double));
+	finishPlanEvaluation(evaluation, coverageScore, disableEnergyLimit);
+	//std::cout << "Plan score was: " << evaluation.scores << std::endl;
+	return evaluation.scores;
 
-	//std::cout << "Plan score was: " << scoreVector << std::endl;
-	return scoreVector;
+}
+
+bool PlanCoverageEstimator::startPlanEvaluation(const std::vector<std::vector<double> > &plan, bool usingPlanResultCache,
+		bool disableEnergyLimit, PlanEvaluation& evaluation, EvaluationContext& context) {
+	//std::cout << "Evaluating plan: " << plan << std::endl;
+	if (plan.size() == 0) {
+		evaluation.scores = evaluateEmptyPlan();
+		return true;
+	}
+
+	//Making a copy of the plan that we can modify - so we are sure never to mess with the genotype.
+	evaluation.plan = prepareForEvaluation(plan);
+
+	evaluation.usingPlanResultCache = usingPlanResultCache;
+	if (usingPlanResultCache) {
+		evaluation.canonicalPlan = PlanResultCache::canonicalForm(evaluation.plan);
+		std::lock_guard<std::mutex> lock(planResultCacheMutex);
+		if (planResultCache.find(evaluation.canonicalPlan, disableEnergyLimit, evaluation.scores)) {
+			context.statistics.planCacheHits++;
+			return true;
+		}
+	}
 
+	double stageStart = now();
+	evaluation.energyUsed = energyEvaluator->decodeAndCalculateEnergyUsage(evaluation.plan);
+	context.statistics.energySeconds += now() - stageStart;
+	if(!disableEnergyLimit && !energyEvaluator->energyWithinBounds(evaluation.energyUsed)) {
+			//std::cout << "Current plan: " << plan << std::endl;
+			finishPlanEvaluation(evaluation, 1, disableEnergyLimit); //No coverage for plans using too much energy.
+			return true;
+	}
+	return false;
+}
+
+void PlanCoverageEstimator::finishPlanEvaluation(PlanEvaluation& evaluation, double coverageScore, bool disableEnergyLimit) {
+	double objectiveScores[] = { coverageScore, evaluation.energyUsed }; //For both objectives: 0 is best score.
+	evaluation.scores.assign(objectiveScores, objectiveScores + sizeof(objectiveScores) / sizeof(double));
+	if (evaluation.usingPlanResultCache) {
+		std::lock_guard<std::mutex> lock(planResultCacheMutex);
+		planResultCache.insert(evaluation.canonicalPlan, disableEnergyLimit, evaluation.scores);
+	}
 }
 
 int PlanCoverageEstimator::updateMemoisedEdges(
 		const std::vector<std::vector<std::vector<double> > >& allSolutions) {
+	stopSpeculativePrefetch();
 	//std::cout << "population is: " << std::endl;
 	//Finding all edges in the current population.
 	std::set<std::string> allEdgesInPopulation;
+	std::vector<std::vector<std::string> > allPlanPartNames; //The plans in the population, as used by the prefix trie.
 	for (std::vector<std::vector<std::vector<double> > >::const_iterator popItt =
 			allSolutions.begin(); popItt != allSolutions.end(); popItt++) {
 		//std::cout << "Next individual: ";
-		std::vector<std::vector<double> > currentSolution = *popItt;
+		//Looking at the plans as they are evaluated, so we also keep edges added by looping around.
+		std::vector<std::vector<double> > currentSolution = prepareForEvaluation(*popItt);
+		allPlanPartNames.push_back(std::vector<std::string>());
 		std::string previousPlanPartName = "start";
 		for (std::vector<std::vector<double> >::iterator planItt =
 				currentSolution.begin(); planItt < currentSolution.end();
@@ -300,6 +614,7 @@ int PlanCoverageEstimator::updateMemoisedEdges(
 			std::string memoizationIndex = previousPlanPartName + "-"
 					+ currentPlanPartName; //The string we use to store and look up the current edge.
 			allEdgesInPopulation.insert(memoizationIndex);
+			allPlanPartNames.back().push_back(currentPlanPartName);
 
 			//std::cout << memoizationIndex << " - ";
 			std::vector<double> prevStep = nextStep;
@@ -307,23 +622,607 @@ int PlanCoverageEstimator::updateMemoisedEdges(
 		}
 	}
 	//std::cout<<std::endl;
-	std::set<std::string> edgesToRemove;
 	//Removing any memoized edges not in the population.
-	for (std::map<std::string, boost::dynamic_bitset<> >::iterator memEdges2 =
-			memoisedEdgesBitset->begin();
-			memEdges2 != memoisedEdgesBitset->end(); memEdges2++) {
-		std::string edgeName = memEdges2->first;
-		if (allEdgesInPopulation.find(edgeName) == allEdgesInPopulation.end()) { //Find in set has logarithmic complexity.
-			edgesToRemove.insert(edgeName);
+	std::lock_guard<std::mutex> lock(memoMutex);
+	for (std::vector<EdgeCoverageMemo>::iterator shard = memoShards.begin(); shard != memoShards.end(); shard++) {
+		shard->retainOnly(allEdgesInPopulation);
+	}
+	planPrefixes.retainOnly(allPlanPartNames);
+
+	return numMemoisedEdges();
+}
+
+void PlanCoverageEstimator::updateObservationCounts(std::vector<uint8_t>& observationCounts, const boost::dynamic_bitset<>& edgeCoverage,
+		bool adding, boost::dynamic_bitset<>& coveredFaces) {
+	for (size_t faceId = edgeCoverage.find_first(); faceId != boost::dynamic_bitset<>::npos;
+			faceId = edgeCoverage.find_next(faceId)) {
+		updateObservationCount(faceId, observationCounts[faceId], adding, coveredFaces);
+	}
+}
+
+void PlanCoverageEstimator::updateObservationCounts(const std::vector<uint8_t>& observationCounts,
+		std::unordered_map<size_t, uint8_t>& changedCounts, const boost::dynamic_bitset<>& edgeCoverage, bool adding,
+		boost::dynamic_bitset<>& coveredFaces) {
+	for (size_t faceId = edgeCoverage.find_first(); faceId != boost::dynamic_bitset<>::npos;
+			faceId = edgeCoverage.find_next(faceId)) {
+		//Only inserted if the face has no changed count yet.
+		uint8_t& count = changedCounts.insert(std::make_pair(faceId, observationCounts[faceId])).first->second;
+		updateObservationCount(faceId, count, adding, coveredFaces);
+	}
+}
+
+void PlanCoverageEstimator::updateObservationCount(size_t faceId, uint8_t& count, bool adding, boost::dynamic_bitset<>& coveredFaces) {
+	if (count == std::numeric_limits<uint8_t>::max()) {
+		//We no longer know the exact count. The face stays covered.
+		return;
+	}
+	if (adding) {
+		count++;
+	} else {
+		assert(count > 0);
+		count--;
+	}
+	coveredFaces[faceId] = count > 0;
+}
+
+std::vector<std::vector<double> > PlanCoverageEstimator::applyPlanEdits(const std::vector<std::vector<double> >& plan,
+		const std::vector<std::vector<double> >& editOps) {
+	std::vector<std::vector<double> > editedPlan = plan;
+	for (std::vector<std::vector<double> >::const_iterator edit = editOps.begin(); edit != editOps.end(); edit++) {
+		if (edit->size() < 2 || (*edit)[1] < 0) {
+			throw std::invalid_argument("ERROR! Plan edits need an edit type and a non-negative position.");
+		}
+		int editType = (int) ((*edit)[0] + 0.5);
+		size_t position = (size_t) ((*edit)[1] + 0.5);
+		std::vector<double> gene(edit->begin() + 2, edit->end());
+		if (editType == remove_gene) {
+			if (position >= editedPlan.size()) {
+				throw std::invalid_argument("ERROR! Asked to remove a gene outside the plan.");
+			}
+			editedPlan.erase(editedPlan.begin() + position);
+		} else if (editType == replace_gene) {
+			if (position >= editedPlan.size() || gene.empty()) {
+				throw std::invalid_argument("ERROR! Asked to replace a gene outside the plan, or to replace it with nothing.");
+			}
+			editedPlan[position] = gene;
+		} else if (editType == insert_gene) {
+			if (position > editedPlan.size() || gene.empty()) {
+				throw std::invalid_argument("ERROR! Asked to insert a gene outside the plan, or to insert nothing.");
+			}
+			editedPlan.insert(editedPlan.begin() + position, gene);
+		} else {
+			throw std::invalid_argument("ERROR! Unknown plan edit type.");
+		}
+	}
+	return editedPlan;
+}
+
+int PlanCoverageEstimator::registerParentPlan(const std::vector<std::vector<double> >& plan) {
+	StatisticsScope statisticsScope(*this);
+	double stageStart = now();
+	ParentPlanState parent;
+	parent.genotype = plan;
+	parent.observationCounts.assign(numVisibleFaces, 0);
+	parent.coveredFaces.resize(numVisibleFaces);
+	std::vector<std::vector<double> > planCopy = prepareForEvaluation(plan);
+	for (size_t i = 0; i < planCopy.size(); i++) {
+		std::string edgeName = getEdgeName(planCopy, i, vectorToString(planCopy[i], planCopy[i].size()));
+		CoveragePattern edgeCoverage = getEdgeCoverage(planCopy, i, edgeName, mainContext);
+		parent.edgeNames.push_back(edgeName);
+		parent.edgeCoverages[edgeName] = edgeCoverage;
+		updateObservationCounts(parent.observationCounts, *edgeCoverage, true, parent.coveredFaces);
+	}
+	mainContext.statistics.edgeCoverageSeconds += now() - stageStart;
+	int handle = nextParentHandle++;
+	parentPlans[handle] = std::move(parent);
+	return handle;
+}
+
+std::vector<double> PlanCoverageEstimator::evaluateMutation(int parentHandle, const std::vector<std::vector<double> >& editOps) {
+	std::map<int, ParentPlanState>::iterator parentEntry = parentPlans.find(parentHandle);
+	if (parentEntry == parentPlans.end()) {
+		throw std::invalid_argument("ERROR! Asked to evaluate a mutation of an unknown parent plan.");
+	}
+	StatisticsScope statisticsScope(*this);
+	mainContext.statistics.plansEvaluated++;
+	ParentPlanState& parent = parentEntry->second;
+	std::vector<std::vector<double> > childGenotype = applyPlanEdits(parent.genotype, editOps);
+	if (childGenotype.empty()) {
+		return evaluateEmptyPlan();
+	}
+
+	//Energy is cheap to calculate, and depends on the whole plan. Calculating it as in evaluatePlan.
+	std::vector<std::vector<double> > childPlan = prepareForEvaluation(childGenotype);
+	CanonicalPlan canonicalPlan = PlanResultCache::canonicalForm(childPlan);
+	std::vector<double> scoreVector;
+	std::unique_lock<std::mutex> planResultCacheLock(planResultCacheMutex);
+	bool cached = planResultCache.find(canonicalPlan, false, scoreVector);
+	planResultCacheLock.unlock();
+	if (cached) {
+		mainContext.statistics.planCacheHits++;
+		return scoreVector;
+	}
+	double stageStart = now();
+	double energyUsed = energyEvaluator->decodeAndCalculateEnergyUsage(childPlan);
+	mainContext.statistics.energySeconds += now() - stageStart;
+	if (!energyEvaluator->energyWithinBounds(energyUsed)) {
+		double objectiveScores[] = {1, energyUsed}; //For both objectives: 0 is best score.
+		scoreVector.assign(objectiveScores, objectiveScores + sizeof(objectiveScores) / sizeof(double));
+		std::lock_guard<std::mutex> lock(planResultCacheMutex);
+		planResultCache.insert(canonicalPlan, false, scoreVector);
+		return scoreVector;
+	}
+
+	stageStart = now();
+	//Finding the edges the child has gained and lost compared to the parent. Plans may contain the same edge several times.
+	std::map<std::string, int> edgeCountChanges;
+	std::map<std::string, size_t> childEdgeIndices;
+	for (std::vector<std::string>::const_iterator edgeName = parent.edgeNames.begin(); edgeName != parent.edgeNames.end(); edgeName++) {
+		edgeCountChanges[*edgeName]--;
+	}
+	for (size_t i = 0; i < childPlan.size(); i++) {
+		std::string edgeName = getEdgeName(childPlan, i, vectorToString(childPlan[i], childPlan[i].size()));
+		edgeCountChanges[edgeName]++;
+		childEdgeIndices[edgeName] = i;
+	}
+	std::vector<CoveragePattern> removedEdges;
+	std::vector<CoveragePattern> addedEdges;
+	const uint8_t saturatedCount = std::numeric_limits<uint8_t>::max();
+	for (std::map<std::string, int>::const_iterator change = edgeCountChanges.begin(); change != edgeCountChanges.end(); change++) {
+		if (change->second < 0) {
+			CoveragePattern edgeCoverage = parent.edgeCoverages.at(change->first);
+			for (size_t triangleId = edgeCoverage->find_first(); triangleId != boost::dynamic_bitset<>::npos;
+					triangleId = edgeCoverage->find_next(triangleId)) {
+				if (parent.observationCounts[triangleId] == saturatedCount) {
+					//We cannot tell if removing this edge uncovers the triangle. Evaluating the child the normal way instead.
+					mainContext.statistics.plansEvaluated--; //evaluatePlan counts it.
+					return evaluatePlan(childGenotype, true, nothing);
+				}
+			}
+			removedEdges.insert(removedEdges.end(), -change->second, edgeCoverage);
+		} else if (change->second > 0) {
+			size_t i = childEdgeIndices.at(change->first);
+			addedEdges.insert(addedEdges.end(), change->second, getEdgeCoverage(childPlan, i, change->first, mainContext));
+		}
+	}
+
+	//Applying the changes to a scratch copy of the counts they touch, to find the child's covered faces. The parent's
+	//counts are left as they are, since counts saturating in the child could not be undone.
+	std::unordered_map<size_t, uint8_t> childCounts;
+	boost::dynamic_bitset<> coveredFaces = parent.coveredFaces;
+	for (std::vector<CoveragePattern>::const_iterator edge = removedEdges.begin(); edge != removedEdges.end(); edge++) {
+		updateObservationCounts(parent.observationCounts, childCounts, **edge, false, coveredFaces);
+	}
+	for (std::vector<CoveragePattern>::const_iterator edge = addedEdges.begin(); edge != addedEdges.end(); edge++) {
+		updateObservationCounts(parent.observationCounts, childCounts, **edge, true, coveredFaces);
+	}
+	mainContext.statistics.edgeCoverageSeconds += now() - stageStart;
+
+	//Scoring the covered faces like evaluatePlan does, rather than summing up the changes to the parent's area, since
+	//floating-point sums depend on their order. The child gets exactly the score evaluatePlan would give it.
+	stageStart = now();
+	double coverageScore = calculateCoverage(coveredFaces, mainContext);
+	mainContext.statistics.scoringSeconds += now() - stageStart;
+	double objectiveScores[] = { coverageScore, energyUsed }; //For both objectives: 0 is best score.
+	scoreVector.assign(objectiveScores, objectiveScores + sizeof(objectiveScores) / sizeof(double));
+	std::lock_guard<std::mutex> lock(planResultCacheMutex);
+	planResultCache.insert(canonicalPlan, false, scoreVector);
+	return scoreVector;
+}
+
+void PlanCoverageEstimator::releaseParentPlan(int parentHandle) {
+	parentPlans.erase(parentHandle);
+}
+
+void PlanCoverageEstimator::releaseWorkerContexts() {
+	if (postProcessing) {
+		planInterpreter->setDecodingWorkers(nullptr, std::vector<CameraEstimator*>(), std::vector<osg::ref_ptr<osg::Node> >());
+	}
+	delete threadPool;
+	threadPool = nullptr;
+	for (std::vector<EvaluationContext>::iterator context = workerContexts.begin(); context != workerContexts.end(); context++) {
+		delete context->camera;
+	}
+	workerContexts.clear();
+	nodeTriangleAreas.clear();
+}
+
+void PlanCoverageEstimator::prepareWorkerContexts() {
+	if (threadPool != nullptr) {
+		return;
+	}
+	size_t numNodes = numaTopology.numNodes();
+	if (numNodes == 1) {
+		threadPool = new ThreadPool(numThreads);
+	} else {
+		//Spreading the workers evenly over the nodes. Each may run on any CPU of its node.
+		size_t numWorkers = numThreads != 0 ? numThreads : numaTopology.numCpus();
+		std::vector<std::vector<int> > workerCpus;
+		for (size_t workerIndex = 0; workerIndex < numWorkers; workerIndex++) {
+			workerCpus.push_back(numaTopology.getCpus(workerIndex % numNodes));
+		}
+		threadPool = new ThreadPool(workerCpus);
+	}
+	workerContexts.resize(threadPool->size());
+	for (size_t workerIndex = 0; workerIndex < workerContexts.size(); workerIndex++) {
+		workerContexts[workerIndex].camera = new CameraEstimator(sensorSpecs);
+		workerContexts[workerIndex].node = workerIndex % numNodes;
+	}
+	//OSG lazily creates state (display lists, bounding volumes) while rendering, so each thread renders its own copy of the scene.
+	if (numNodes == 1) {
+		for (std::vector<EvaluationContext>::iterator context = workerContexts.begin(); context != workerContexts.end(); context++) {
+			context->scene = osg::clone(coloredScene.get(), osg::CopyOp::DEEP_COPY_ALL);
+		}
+	} else {
+		//The copies for each node are made by a thread pinned to that node, so the kernel places them in the node's memory.
+		//The nodes are done one at a time, as they all copy from the same scene.
+		nodeTriangleAreas.resize(numNodes);
+		for (size_t node = 0; node < numNodes; node++) {
+			std::exception_ptr error;
+			std::thread copier([&, node]() {
+				try {
+					NumaTopology::pinCurrentThread(numaTopology.getCpus(node));
+					std::vector<double>& triangleAreas = nodeTriangleAreas[node];
+					const AlignedVector<double>& sceneTriangleAreas = sceneKeeper->getTriangleAreas();
+					triangleAreas.assign(sceneTriangleAreas.begin(), sceneTriangleAreas.end());
+					for (std::vector<EvaluationContext>::iterator context = workerContexts.begin(); context != workerContexts.end(); context++) {
+						if (context->node == node) {
+							context->scene = osg::clone(coloredScene.get(), osg::CopyOp::DEEP_COPY_ALL);
+							context->triangleAreas = &triangleAreas;
+						}
+					}
+				} catch (...) {
+					error = std::current_exception();
+				}
+			});
+			copier.join();
+			if (error) {
+				releaseWorkerContexts();
+				std::rethrow_exception(error);
+			}
+		}
+	}
+	if (postProcessing) {
+		//Post-processing evaluates plans one at a time, but decodes the edges of each plan on the workers.
+		std::vector<CameraEstimator*> cameras;
+		std::vector<osg::ref_ptr<osg::Node> > scenes;
+		for (std::vector<EvaluationContext>::const_iterator context = workerContexts.begin(); context != workerContexts.end(); context++) {
+			cameras.push_back(context->camera);
+			scenes.push_back(context->scene);
+		}
+		planInterpreter->setDecodingWorkers(threadPool, cameras, scenes);
+	}
+}
+
+std::vector<std::vector<double> > PlanCoverageEstimator::evaluatePlans(const std::vector<std::vector<std::vector<double> > >& plans,
+		bool memoization, bool disableEnergyLimit/*=false*/) {
+	StatisticsScope statisticsScope(*this);
+	std::vector<std::vector<double> > results(plans.size());
+	if (postProcessing || numThreads == 1 || plans.size() < 2) {
+		for (size_t i = 0; i < plans.size(); i++) {
+			results[i] = evaluatePlanInContext(plans[i], memoization, nothing, disableEnergyLimit, nullptr, mainContext);
+		}
+		return results;
+	}
+
+	prepareWorkerContexts();
+	for (std::vector<EvaluationContext>::iterator context = workerContexts.begin(); context != workerContexts.end(); context++) {
+		context->statistics = EvaluationStatistics();
+		context->camera->resetRenderStatistics();
+	}
+	if (memoization) {
+		results = evaluateGeneration(plans, disableEnergyLimit);
+	} else {
+		threadPool->parallelFor(plans.size(), [&](size_t planIndex, size_t workerIndex) {
+			results[planIndex] = evaluatePlanInContext(plans[planIndex], memoization, nothing, disableEnergyLimit, nullptr,
+					workerContexts[workerIndex]);
+		});
+	}
+	//The statistics scope reports what was done on the main context, so the workers' work goes there.
+	for (std::vector<EvaluationContext>::const_iterator context = workerContexts.begin(); context != workerContexts.end(); context++) {
+		EvaluationStatistics workerStatistics = context->statistics;
+		addRenderStatistics(workerStatistics, context->camera->getRenderStatistics());
+		mainContext.statistics.add(workerStatistics);
+	}
+	return results;
+}
+
+std::vector<std::vector<double> > PlanCoverageEstimator::evaluateGeneration(const std::vector<std::vector<std::vector<double> > >& plans,
+		bool disableEnergyLimit) {
+	//Phase 1: Scoring the plans we can score without finding their coverage.
+	std::vector<PlanEvaluation> evaluations(plans.size());
+	std::vector<char> scored(plans.size());
+	threadPool->parallelFor(plans.size(), [&](size_t planIndex, size_t workerIndex) {
+		workerContexts[workerIndex].statistics.plansEvaluated++;
+		scored[planIndex] = startPlanEvaluation(plans[planIndex], true, disableEnergyLimit, evaluations[planIndex],
+				workerContexts[workerIndex]);
+	});
+
+	//Phase 2: Finding the edges we have to render. Plans in a generation share most of their edges, so each edge is
+	//scheduled once, however many plans contain it. Edges in plan prefixes with known coverage are not needed.
+	double stageStart = now();
+	std::map<std::string, std::pair<size_t, size_t> > missingEdges; //The plan and position each missing edge was first found in.
+	{
+		std::lock_guard<std::mutex> lock(memoMutex);
+		for (size_t planIndex = 0; planIndex < plans.size(); planIndex++) {
+			if (scored[planIndex]) {
+				continue;
+			}
+			const std::vector<std::vector<double> >& plan = evaluations[planIndex].plan;
+			std::vector<std::string> planPartNames;
+			planPartNames.reserve(plan.size());
+			for (size_t i = 0; i < plan.size(); i++) {
+				planPartNames.push_back(vectorToString(plan[i], plan[i].size()));
+			}
+			CoveragePattern knownPrefixCoverage;
+			for (size_t i = planPrefixes.findLongestKnownPrefix(planPartNames, knownPrefixCoverage); i < plan.size(); i++) {
+				std::string edgeName = getEdgeName(plan, i, planPartNames[i]);
+				if (!isMemoised(edgeName)) {
+					missingEdges.insert(std::make_pair(edgeName, std::make_pair(planIndex, i)));
+				}
+			}
 		}
 	}
+	std::vector<std::map<std::string, std::pair<size_t, size_t> >::const_iterator> edgeTasks;
+	edgeTasks.reserve(missingEdges.size());
+	for (std::map<std::string, std::pair<size_t, size_t> >::const_iterator edge = missingEdges.begin(); edge != missingEdges.end(); edge++) {
+		edgeTasks.push_back(edge);
+	}
+	renderMissingEdges(edgeTasks, evaluations);
+	mainContext.statistics.edgeCoverageSeconds += now() - stageStart;
 
-	for (std::set<std::string>::iterator deletedEdge = edgesToRemove.begin();
-			deletedEdge != edgesToRemove.end(); deletedEdge++) {
-		memoisedEdgesBitset->erase(*deletedEdge);
+	//Phase 3: Putting together the coverage of each remaining plan from the memo, and scoring it.
+	std::vector<std::vector<double> > results(plans.size());
+	threadPool->parallelFor(plans.size(), [&](size_t planIndex, size_t workerIndex) {
+		PlanEvaluation& evaluation = evaluations[planIndex];
+		if (!scored[planIndex]) {
+			EvaluationContext& context = workerContexts[workerIndex];
+			double stageStart = now();
+			boost::dynamic_bitset<> observedColors = evaluateMemoisedPlan(evaluation.plan, context);
+			context.statistics.edgeCoverageSeconds += now() - stageStart;
+			stageStart = now();
+			finishPlanEvaluation(evaluation, calculateCoverage(observedColors, context), disableEnergyLimit);
+			context.statistics.scoringSeconds += now() - stageStart;
+		}
+		results[planIndex].swap(evaluation.scores);
+	});
+	return results;
+}
+
+void PlanCoverageEstimator::renderMissingEdges(
+		const std::vector<std::map<std::string, std::pair<size_t, size_t> >::const_iterator>& edgeTasks,
+		const std::vector<PlanEvaluation>& evaluations) {
+	//Edges other evaluator processes already rendered need no work. The rest are claimed, so other processes wait for
+	//us to render them, rather than render them too. Edges others have claimed are waited for once ours are done.
+	std::vector<char> sharedClaims(edgeTasks.size());	//Whether we hold a claim on the edge, not yet published.
+	std::vector<size_t> sharedSlots(edgeTasks.size());
+	std::vector<size_t> edgesToRender;
+	std::vector<size_t> edgesRenderedElsewhere;
+	boost::dynamic_bitset<> sharedCoverage(numVisibleFaces);
+	for (size_t task = 0; task < edgeTasks.size(); task++) {
+		SharedEdgeCache::ClaimResult claim = SharedEdgeCache::claim_failed;
+		if (sharedEdgeCache != nullptr) {
+			claim = sharedEdgeCache->claim(hash128(edgeTasks[task]->first), sharedCoverage, sharedSlots[task]);
+		}
+		if (claim == SharedEdgeCache::claim_found) {
+			mainContext.statistics.sharedCacheHits++;
+			std::lock_guard<std::mutex> lock(memoMutex);
+			memoShards[mainContext.node].insert(edgeTasks[task]->first, sharedCoverage);
+		} else if (claim == SharedEdgeCache::claim_taken) {
+			edgesRenderedElsewhere.push_back(task);
+		} else {
+			sharedClaims[task] = claim == SharedEdgeCache::claim_granted;
+			edgesToRender.push_back(task);
+		}
 	}
 
-	return memoisedEdgesBitset->size();
+	auto renderEdges = [&](const std::vector<size_t>& tasks) {
+		//Splitting the edges into camera traversals, each a job of as many items as it has sampling positions.
+		std::vector<CameraTraversal> traversals;
+		std::vector<size_t> numSamples;
+		for (std::vector<size_t>::const_iterator task = tasks.begin(); task != tasks.end(); task++) {
+			mainContext.statistics.memoMisses++;
+			const std::pair<size_t, size_t>& occurrence = edgeTasks[*task]->second;
+			osg::ref_ptr<osg::Vec3dArray> decodedPositions = new osg::Vec3dArray;
+			osg::ref_ptr<osg::Vec3dArray> decodedAngles = new osg::Vec3dArray;
+			decodeEdge(evaluations[occurrence.first].plan, occurrence.second, *decodedPositions, *decodedAngles);
+			for (size_t edgeNr = 0; edgeNr < decodedAngles->size(); edgeNr++) {
+				CameraTraversal traversal = {*task, cam_estimator->getTraversalSamplingPositions(decodedPositions->at(edgeNr),
+						decodedPositions->at(edgeNr + 1)), decodedAngles->at(edgeNr)};
+				traversals.push_back(traversal);
+				numSamples.push_back(traversal.samplingPositions->size());
+			}
+		}
+
+		//Each thread collects what it sees of each edge by itself. The pieces are merged afterwards.
+		std::vector<std::map<size_t, PartialEdgeCoverage> > partialCoverages(workerContexts.size());
+		WorkStealingScheduler scheduler(*threadPool, EDGE_SUBTASK_SAMPLES);
+		SchedulingStatistics scheduling = scheduler.run(numSamples, [&](size_t job, size_t begin, size_t end, size_t workerIndex) {
+			const CameraTraversal& traversal = traversals[job];
+			EvaluationContext& context = workerContexts[workerIndex];
+			PartialEdgeCoverage& partial = partialCoverages[workerIndex][traversal.edgeTask];
+			if (partial.coverage.empty()) {
+				partial.coverage.resize(numVisibleFaces);
+			}
+			unsigned long framesRenderedBefore = context.camera->getRenderStatistics().framesRendered;
+			context.camera->GetColorsInSampleRange(*traversal.samplingPositions, traversal.heading, context.scene, partial.coverage, begin, end);
+			partial.numFrames += context.camera->getRenderStatistics().framesRendered - framesRenderedBefore;
+		});
+		mainContext.statistics.edgeSubtasks += scheduling.subtasksRun;
+		mainContext.statistics.subtaskSteals += scheduling.steals;
+		mainContext.statistics.maxQueueDepth = std::max(mainContext.statistics.maxQueueDepth, scheduling.maxQueueDepth);
+
+		for (std::vector<size_t>::const_iterator task = tasks.begin(); task != tasks.end(); task++) {
+			boost::dynamic_bitset<> edgeCoverage(numVisibleFaces);
+			unsigned int numFrames = 0;
+			for (std::vector<std::map<size_t, PartialEdgeCoverage> >::const_iterator workerPartials = partialCoverages.begin();
+					workerPartials != partialCoverages.end(); workerPartials++) {
+				std::map<size_t, PartialEdgeCoverage>::const_iterator partial = workerPartials->find(*task);
+				if (partial != workerPartials->end()) {
+					edgeCoverage |= partial->second.coverage;
+					numFrames += partial->second.numFrames;
+				}
+			}
+			if (sharedClaims[*task]) {
+				sharedEdgeCache->publish(sharedSlots[*task], edgeCoverage);
+				sharedClaims[*task] = false;
+			}
+			std::lock_guard<std::mutex> lock(memoMutex);
+			memoShards[mainContext.node].insert(edgeTasks[*task]->first, edgeCoverage, numFrames);
+		}
+	};
+
+	try {
+		renderEdges(edgesToRender);
+	} catch (...) {
+		//Letting processes waiting for our claims render the edges themselves.
+		for (size_t task = 0; task < edgeTasks.size(); task++) {
+			if (sharedClaims[task]) {
+				sharedEdgeCache->abandon(sharedSlots[task]);
+			}
+		}
+		throw;
+	}
+
+	//Collecting the edges other processes claimed. Those they gave up on are rendered here after all.
+	std::vector<size_t> abandonedEdges;
+	for (std::vector<size_t>::const_iterator task = edgesRenderedElsewhere.begin(); task != edgesRenderedElsewhere.end(); task++) {
+		if (sharedEdgeCache->waitForClaimed(sharedSlots[*task], sharedCoverage)) {
+			mainContext.statistics.sharedCacheHits++;
+			std::lock_guard<std::mutex> lock(memoMutex);
+			memoShards[mainContext.node].insert(edgeTasks[*task]->first, sharedCoverage);
+		} else {
+			abandonedEdges.push_back(*task);
+		}
+	}
+	if (!abandonedEdges.empty()) {
+		renderEdges(abandonedEdges);
+	}
+}
+
+void PlanCoverageEstimator::setNumThreads(int numThreads) {
+	if (numThreads < 0) {
+		throw std::invalid_argument("ERROR! The number of threads can not be negative.");
+	}
+	if ((size_t) numThreads == this->numThreads) {
+		return;
+	}
+	this->numThreads = numThreads;
+	releaseWorkerContexts();
+	if (postProcessing) {
+		//The plan interpreter decodes on the workers, so they are remade right away.
+		prepareWorkerContexts();
+	}
+}
+
+EvaluationStatistics PlanCoverageEstimator::getStatistics() const {
+	EvaluationStatistics statistics = cumulativeStatistics;
+	std::lock_guard<std::mutex> lock(memoMutex);
+	statistics.memoEdges = numMemoisedEdges();
+	statistics.memoPatterns = 0;
+	statistics.memoBytes = 0;
+	for (std::vector<EdgeCoverageMemo>::const_iterator shard = memoShards.begin(); shard != memoShards.end(); shard++) {
+		statistics.memoPatterns += shard->numDistinctPatterns();
+		statistics.memoBytes += shard->estimateBytes();
+	}
+	return statistics;
+}
+
+void PlanCoverageEstimator::resetStatistics() {
+	cumulativeStatistics = EvaluationStatistics();
+}
+
+void PlanCoverageEstimator::attachSharedEdgeCache(const std::string& name, int capacity) {
+	if (capacity <= 0) {
+		throw std::invalid_argument("ERROR! The shared edge cache needs room for at least one edge.");
+	}
+	stopSpeculativePrefetch();
+	delete sharedEdgeCache;
+	sharedEdgeCache = nullptr;
+	sharedEdgeCache = new SharedEdgeCache(name, capacity, numVisibleFaces, setupFingerprint);
+}
+
+bool PlanCoverageEstimator::removeSharedEdgeCache(const std::string& name) {
+	return SharedEdgeCache::remove(name);
+}
+
+void PlanCoverageEstimator::startSpeculativePrefetch(const std::vector<std::vector<std::vector<double> > >& elitePlans, int edgeBudget) {
+	if (postProcessing) {
+		throw std::logic_error("ERROR! Speculative prefetching is not available in post-processing, where nothing is memoized.");
+	}
+	if (edgeBudget < 0) {
+		throw std::invalid_argument("ERROR! The edge budget of speculative prefetching can not be negative.");
+	}
+	stopSpeculativePrefetch();
+	if (edgeBudget == 0 || elitePlans.empty()) {
+		return;
+	}
+	if (speculationContext.camera == nullptr) {
+		speculationContext.camera = new CameraEstimator(sensorSpecs);
+		speculationContext.scene = osg::clone(coloredScene.get(), osg::CopyOp::DEEP_COPY_ALL);
+	}
+	speculationContext.statistics = EvaluationStatistics();
+	stopSpeculation = false;
+	speculationThread = std::thread(&PlanCoverageEstimator::speculate, this, elitePlans, (size_t) edgeBudget);
+}
+
+void PlanCoverageEstimator::stopSpeculativePrefetch() {
+	if (!speculationThread.joinable()) {
+		return;
+	}
+	stopSpeculation = true;
+	speculationThread.join();
+	cumulativeStatistics.speculativeEdges += speculationContext.statistics.memoMisses;
+}
+
+void PlanCoverageEstimator::speculate(const std::vector<std::vector<std::vector<double> > >& elitePlans, size_t edgeBudget) {
+	//On Linux, each thread has its own niceness, so this only lowers the priority of the speculation.
+	setpriority(PRIO_PROCESS, syscall(SYS_gettid), SPECULATIVE_PREFETCH_NICENESS);
+	try {
+		std::set<std::string> consideredEdges;
+		size_t numRendered = 0;
+		for (std::vector<std::vector<std::vector<double> > >::const_iterator elite = elitePlans.begin(); elite != elitePlans.end(); elite++) {
+			std::vector<std::vector<double> > plan = prepareForEvaluation(*elite);
+			for (size_t i = 0; i < plan.size(); i++) {
+				std::vector<size_t> neighbors = planInterpreter->getNeighboringBoxes(PlanInterpreterBoxOrder::getPointID(plan[i]));
+				for (std::vector<size_t>::const_iterator neighbor = neighbors.begin(); neighbor != neighbors.end(); neighbor++) {
+					std::vector<double> movedPoint = plan[i];
+					movedPoint[0] = *neighbor;
+					//The edges made by moving point i to the neighbor, or by inserting the neighbor right before or after it.
+					//Each edge is given as a short plan, leading to its last point.
+					std::vector<std::vector<std::vector<double> > > candidateEdges;
+					candidateEdges.push_back(std::vector<std::vector<double> >());
+					if (i > 0) {
+						candidateEdges.back().push_back(plan[i - 1]);
+					}
+					candidateEdges.back().push_back(movedPoint);
+					if (i + 1 < plan.size()) {
+						candidateEdges.push_back({movedPoint, plan[i + 1]});
+					}
+					candidateEdges.push_back({movedPoint, plan[i]});
+					candidateEdges.push_back({plan[i], movedPoint});
+
+					for (size_t c = 0; c < candidateEdges.size(); c++) {
+						const std::vector<std::vector<double> >& edge = candidateEdges[c];
+						size_t last = edge.size() - 1;
+						std::string edgeName = getEdgeName(edge, last, vectorToString(edge[last], edge[last].size()));
+						if (!consideredEdges.insert(edgeName).second) {
+							continue;
+						}
+						if (stopSpeculation || numRendered >= edgeBudget) {
+							return;
+						}
+						unsigned long missesBefore = speculationContext.statistics.memoMisses;
+						getEdgeCoverage(edge, last, edgeName, speculationContext);
+						numRendered += speculationContext.statistics.memoMisses - missesBefore;
+					}
+				}
+			}
+		}
+	} catch (const std::exception& e) {
+		//Nothing depends on the speculation, so failing here only costs us the edges we did not get to.
+		std::cerr << "Speculative prefetching stopped: " << e.what() << std::endl;
+	}
 }
 
 std::vector<std::vector<std::vector<double> > > PlanCoverageEstimator::getSimplePlans() const {
@@ -347,4 +1246,8 @@ void PlanCoverageEstimator::interpretAndExportPlan(
 		return energyEvaluator->getMaxAllowedEnergy();
 	}
 
+	int PlanCoverageEstimator::getVisibilityMeshFaceCount() const {
+		return visibilityMesh != nullptr ? (int) numVisibleFaces : 0;
+	}
+
 } /* namespace evolutionary_inspection_plan_evaluation */
@@ -10,19 +10,35 @@
 #ifndef PLANCOVERAGEESTIMATOR_H_
 #define PLANCOVERAGEESTIMATOR_H_
 
+#include <atomic>
 #include <boost/dynamic_bitset/dynamic_bitset.hpp>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <osg/Array>
 #include <osg/Geode>
 #include <osg/Group>
 #include <osg/ref_ptr>
 #include <set>
+#include <stdint.h>
 #include <string>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
+#include "EdgeCoverageMemo.h"
+#include "EvaluationStatistics.h"
+#include "PlanPrefixTrie.h"
+#include "PlanResultCache.h"
+#include "../../Utility_Functions/src/Hash128.h"
+#include "../../Utility_Functions/src/NumaTopology.h"
+
 namespace utility_functions{
 	class SceneKeeper;
 	class CameraEstimator;
+	class SharedEdgeCache;
+	class ThreadPool;
+	class VisibilityMesh;
 }
 
 
@@ -33,12 +49,20 @@ enum plotting_style {
 	nothing //Plots nothing, stores nothing
 };
 
+//The ways a plan can be edited, when evaluating mutations of a plan through evaluateMutation.
+enum plan_edit_type {
+	remove_gene, //Removes the gene at the given position.
+	replace_gene, //Replaces the gene at the given position with the given gene.
+	insert_gene //Inserts the given gene before the given position.
+};
+
 
 namespace evolutionary_inspection_plan_evaluation {
 
 //Forward declarations
 class PlanEnergyEvaluator;
 class PlanInterpreterBoxOrder;
+struct SceneData;
 
 
 	std::vector<std::vector<double> > viewMatrixSelector(std::string sceneFileName);
@@ -53,8 +77,13 @@ class PlanCoverageEstimator {
 
 private:
 	const std::vector<double>* startLocation; 		///<The starting point in the scene of this plan.
+	std::shared_ptr<SceneData> sceneData;			///<The loaded scene, shared with all other estimators of the same scene. See SceneRegistry.
 	osg::ref_ptr<osg::Geode> coloredScene;			///<The inspection target, with each triangle colored differently. Used to estimate what triangles the camera covers.
-	utility_functions::SceneKeeper *sceneKeeper;						///<Helper class for methods related to operations on the scene graph.
+	///The simplified inspection target we render instead of the model outside post-processing. coloredScene then has each
+	///of its faces colored differently. Owned by sceneData. nullptr if we render the model itself.
+	const utility_functions::VisibilityMesh* visibilityMesh;
+	size_t numVisibleFaces;							///<The number of faces in coloredScene, and so the number of bits in the coverage of edges and plans.
+	utility_functions::SceneKeeper *sceneKeeper;						///<Helper class for methods related to operations on the scene graph. Owned by sceneData.
 	osg::ref_ptr<osg::Vec3dArray> boxes;			///<The "boxes" that we consider visiting around the inspection target. In other words, the candidate waypoints for plans.
 	PlanInterpreterBoxOrder* planInterpreter; 				///<The class that decodes our plan from the optimizers' representation into a sequence of positions and angles.
 	PlanEnergyEvaluator* energyEvaluator;			///The class that helps us calculate the energy spending of plans.
@@ -63,8 +92,213 @@ private:
 
 	///Parameters specific for camera-based coverage. This type accumulates a list of "colors", each one representing one covered triangle in the model.
 	utility_functions::CameraEstimator* cam_estimator;	///<An object estimating a camera, used to estimate what the camera sees while traversing an edge in the plan.
-	///This holds all the covered colors in all the edges in the current population, indexed by edge name. Helps us avoid many costly recalculations.
-	std::map<std::string,boost::dynamic_bitset<> >* memoisedEdgesBitset;
+	std::vector<double> sensorSpecs;				///<The specifications cam_estimator was made from. Needed to make one camera for each worker thread.
+	bool postProcessing;							///<If true, plans are interpreted in the slower, more accurate post-processing way.
+
+	/**
+	 * What one thread needs to evaluate plans: Its own camera (with its own rendering context) and its own copy of the
+	 * colored scene, so threads never share OSG state. Also collects the statistics of the work done with it.
+	 * On NUMA hosts, the scene copy and the triangle areas the thread reads are placed on the thread's own node.
+	 */
+	struct EvaluationContext {
+		utility_functions::CameraEstimator* camera;
+		osg::ref_ptr<osg::Node> scene;
+		EvaluationStatistics statistics;
+		size_t node;								///<The NUMA node the thread runs on, and the memo shard it uses.
+		const std::vector<double>* triangleAreas;	///<The node's copy of the triangle areas. nullptr to use sceneKeeper's.
+
+		EvaluationContext()
+		:camera(nullptr),
+		 node(0),
+		 triangleAreas(nullptr){}
+	};
+	EvaluationContext mainContext;					///<Used by all single-plan evaluations. Wraps cam_estimator and coloredScene.
+	std::vector<EvaluationContext> workerContexts;	///<One for each thread in threadPool. Made the first time we evaluate in parallel.
+	utility_functions::ThreadPool* threadPool;		///<The threads evaluatePlans runs on. nullptr until first needed.
+	size_t numThreads;								///<The number of threads evaluatePlans uses. 0 means one per hardware thread.
+	utility_functions::NumaTopology numaTopology;	///<The NUMA nodes of the host. Workers are spread over them, if there are several.
+	std::vector<std::vector<double> > nodeTriangleAreas;	///<A copy of the triangle areas on each NUMA node. Empty on single-node hosts.
+
+	EvaluationContext speculationContext;			///<Used by the speculative prefetch thread. Made the first time we speculate.
+	std::thread speculationThread;					///<Renders likely edges while we are idle. See startSpeculativePrefetch.
+	std::atomic<bool> stopSpeculation;				///<Tells speculationThread to finish.
+
+	///Guards memoShards and planPrefixes, which are read and written by all threads in evaluatePlans.
+	mutable std::mutex memoMutex;
+	///Guards planResultCache.
+	std::mutex planResultCacheMutex;
+	/**
+	 * This holds all the covered colors in all the edges in the current population, indexed by edge name. Helps us avoid many costly recalculations.
+	 * There is one shard for each NUMA node, filled by the threads of that node. Edges only found in another node's shard
+	 * are copied into the local one on first use, so the hot edges of each node end up in its own memory.
+	 */
+	std::vector<EdgeCoverageMemo> memoShards;
+	///The coverage of prefixes of the plans in the current population. Lets us skip the shared start of related plans.
+	PlanPrefixTrie planPrefixes;
+	///The scores of recently evaluated plans. Lets us answer re-evaluations of identical plans immediately.
+	PlanResultCache planResultCache;
+	///Optional table of edges shared with other evaluator processes on this host. nullptr unless attachSharedEdgeCache was called.
+	utility_functions::SharedEdgeCache* sharedEdgeCache;
+	///Identifies the scene and sensor setup of this estimator, so we never share edges with estimators that would compute them differently.
+	utility_functions::Hash128 setupFingerprint;
+
+	/**
+	 * Everything we need to know about a plan to rapidly evaluate small changes to it. See registerParentPlan.
+	 */
+	struct ParentPlanState {
+		std::vector<std::vector<double> > genotype;		///<The plan as given by the optimizer.
+		std::vector<std::string> edgeNames;				///<The names of all edges in the plan, as it is evaluated.
+		std::map<std::string, utility_functions::CoveragePattern> edgeCoverages;	///<The coverage of each edge in the plan.
+		///For each face of coloredScene, the number of edges in the plan that see it. Saturates at 255, after which the count never changes.
+		std::vector<uint8_t> observationCounts;
+		boost::dynamic_bitset<> coveredFaces;			///<The faces seen by the plan: Those with a positive count.
+	};
+	///All registered parent plans, indexed by their handle. Not guarded by a lock: See registerParentPlan.
+	std::map<int, ParentPlanState> parentPlans;
+	int nextParentHandle;
+
+	EvaluationStatistics cumulativeStatistics;	///<The work done since the last call to resetStatistics.
+	EvaluationStatistics lastCallStatistics;	///<The work done in the last evaluation call.
+	int statisticsCallDepth;					///<How deeply nested the current evaluation calls are. Statistics are per outermost call.
+	double statisticsCallStart;					///<When the current outermost evaluation call started, in seconds.
+
+	///Marks an evaluation call, gathering its statistics into lastCallStatistics and cumulativeStatistics when it ends.
+	class StatisticsScope;
+
+	/**
+	 * Adds or removes the observations of one edge to the per-face observation counts of a plan, keeping track of
+	 * the faces covered. Saturated counts are left untouched.
+	 * @param[in,out] observationCounts The per-face counts
+	 * @param edgeCoverage The faces the edge sees
+	 * @param adding true to add the edge's observations, false to remove them
+	 * @param[in,out] coveredFaces The faces with a positive count
+	 */
+	static void updateObservationCounts(std::vector<uint8_t>& observationCounts, const boost::dynamic_bitset<>& edgeCoverage,
+			bool adding, boost::dynamic_bitset<>& coveredFaces);
+
+	/**
+	 * As above, but leaves the plan's counts as they are, and records the changed counts in changedCounts instead.
+	 * For the faces it holds, changedCounts takes the place of observationCounts.
+	 */
+	static void updateObservationCounts(const std::vector<uint8_t>& observationCounts, std::unordered_map<size_t, uint8_t>& changedCounts,
+			const boost::dynamic_bitset<>& edgeCoverage, bool adding, boost::dynamic_bitset<>& coveredFaces);
+
+	///Adds or removes one observation of a face to its count, as described for updateObservationCounts.
+	static void updateObservationCount(size_t faceId, uint8_t& count, bool adding, boost::dynamic_bitset<>& coveredFaces);
+
+	/**
+	 * Applies a sequence of edits to a plan.
+	 * @throws std::invalid_argument if an edit is malformed, or refers to a position outside the plan.
+	 */
+	static std::vector<std::vector<double> > applyPlanEdits(const std::vector<std::vector<double> >& plan,
+			const std::vector<std::vector<double> >& editOps);
+
+	/**
+	 * Returns the name of an edge, as used to memoize it: the box ID of the previous plan point, and the full gene of the current one.
+	 * @param plan The plan the edge is part of
+	 * @param i The index of the gene the edge leads to
+	 * @param currentPlanPartName The name of the gene the edge leads to (vectorToString of the full gene)
+	 */
+	std::string getEdgeName(const std::vector<std::vector<double> >& plan, size_t i, const std::string& currentPlanPartName) const;
+
+	/**
+	 * Looks an edge up in the memo shard of the given node, and then in the other shards. Edges found in another shard
+	 * are copied into the node's shard. memoMutex must be held.
+	 * @param[out] numFrames As in EdgeCoverageMemo::find.
+	 * @return The memoized coverage, or an empty pointer if the edge is not memoized.
+	 */
+	utility_functions::CoveragePattern findMemoisedEdge(const std::string& edgeName, size_t node, unsigned int* numFrames = nullptr);
+
+	///@return true if the edge is memoized in any shard. memoMutex must be held.
+	bool isMemoised(const std::string& edgeName) const;
+
+	///@return The number of distinct edges in all memo shards. memoMutex must be held.
+	size_t numMemoisedEdges() const;
+
+	/**
+	 * Scores the coverage of a plan, like SceneKeeper::calculateCoverage, but with the triangle areas of the context's node.
+	 * @param observedColors The faces of coloredScene seen. When rendering visibilityMesh, the model's triangles behind
+	 * them are scored.
+	 */
+	double calculateCoverage(const boost::dynamic_bitset<>& observedColors, const EvaluationContext& context) const;
+
+	/**
+	 * Returns the coverage of the edge leading to gene i in the plan, fetching it from the memo if possible, and
+	 * calculating and memoizing it otherwise.
+	 * @param plan The plan the edge is part of
+	 * @param i The index of the gene the edge leads to
+	 * @param memoizationIndex The name of the edge, as given by getEdgeName.
+	 */
+	utility_functions::CoveragePattern getEdgeCoverage(const std::vector<std::vector<double> >& plan, size_t i,
+			const std::string& memoizationIndex, EvaluationContext& context);
+
+	/**
+	 * Interprets the part of the plan leading to position i into the camera traversals along it.
+	 * @param[out] decodedPositions The positions the AUV moves through, starting where the edge starts.
+	 * @param[out] decodedAngles The heading of the AUV between each pair of positions.
+	 */
+	void decodeEdge(const std::vector<std::vector<double> >& plan, size_t i, osg::Vec3dArray& decodedPositions,
+			osg::Vec3dArray& decodedAngles) const;
+
+	///Makes the thread pool and one evaluation context for each of its threads, if not already done.
+	///On NUMA hosts, the threads are spread over the nodes, and each node gets its own copy of the scene data.
+	///In post-processing, also lets the plan interpreter decode plans on them.
+	void prepareWorkerContexts();
+
+	///Stops the thread pool, and deletes the worker contexts.
+	void releaseWorkerContexts();
+
+	/**
+	 * The body of speculationThread: Renders edges that small mutations of the elite plans would create, until edgeBudget
+	 * edges have been rendered, all candidates are memoized, or stopSpeculation is set.
+	 */
+	void speculate(const std::vector<std::vector<std::vector<double> > >& elitePlans, size_t edgeBudget);
+
+	/**
+	 * Does the work of evaluatePlan using the given context. Safe to call from several threads at once, as long as
+	 * each uses its own context, and nothing is plotted.
+	 */
+	std::vector<double> evaluatePlanInContext(const std::vector<std::vector<double> > &plan, bool memoization,
+			plotting_style how_to_plot, bool disableEnergyLimit, osg::ref_ptr<osg::Group> returnedDrawable, EvaluationContext& context);
+
+	/**
+	 * A plan on its way through evaluation.
+	 */
+	struct PlanEvaluation {
+		std::vector<std::vector<double> > plan;	///<The plan as evaluated (see prepareForEvaluation).
+		bool usingPlanResultCache;
+		CanonicalPlan canonicalPlan;			///<Only set if usingPlanResultCache.
+		double energyUsed;
+		std::vector<double> scores;				///<Empty until the plan is scored.
+	};
+
+	/**
+	 * Does the cheap part of evaluating a plan: Catches empty plans, looks the plan up in the plan result cache, and
+	 * calculates its energy use.
+	 * @return true if that was enough to score the plan. Else, its coverage still has to be found, and given to finishPlanEvaluation.
+	 */
+	bool startPlanEvaluation(const std::vector<std::vector<double> > &plan, bool usingPlanResultCache, bool disableEnergyLimit,
+			PlanEvaluation& evaluation, EvaluationContext& context);
+
+	///Scores a plan whose coverage score is known, and remembers the score in the plan result cache.
+	void finishPlanEvaluation(PlanEvaluation& evaluation, double coverageScore, bool disableEnergyLimit);
+
+	/**
+	 * Evaluates plans with memoization in two phases: First, all edges of all plans that are not yet memoized are found,
+	 * and each of them is rendered once, in parallel. Then, each plan's coverage is put together from the memoized edges.
+	 * Used by evaluatePlans, so plans sharing edges never render them at the same time.
+	 */
+	std::vector<std::vector<double> > evaluateGeneration(const std::vector<std::vector<std::vector<double> > >& plans, bool disableEnergyLimit);
+
+	/**
+	 * Renders the given edges, and adds them to the memo. The sampling positions along the edges are spread over the
+	 * threads by a work-stealing scheduler, so long and short edges keep all threads busy. With a shared edge cache,
+	 * edges other processes have rendered are taken from it, and edges they are rendering are waited for.
+	 * @param edgeTasks The names of the edges, each with the plan and position it was found at.
+	 * @param evaluations The plans the edges were found in.
+	 */
+	void renderMissingEdges(const std::vector<std::map<std::string, std::pair<size_t, size_t> >::const_iterator>& edgeTasks,
+			const std::vector<PlanEvaluation>& evaluations);
 
 	/**
 	 * Evaluates the plan rapidly, by using memoized subparts. Also memoizes new subparts as it goes.
@@ -74,16 +308,25 @@ private:
 	 * @param plan The plan to be evaluated
 	 * @return The set of all colors the AUV saw carrying out this plan.
 	 */
-	boost::dynamic_bitset<> evaluateMemoisedPlan(const std::vector<std::vector<double> >& plan);
+	boost::dynamic_bitset<> evaluateMemoisedPlan(const std::vector<std::vector<double> >& plan, EvaluationContext& context);
 
 	/**
 	 * Evaluates the plan, storing a set of all the colors or primitives that were seen.
 	 * Note that the public interface towards this is through the evaluatePlan method.
 	 * @param plan The plan to be evaluated
 	 * @param geode A drawable that we store information about what the AUV saw into.
+	 * @param context The camera and scene to render with.
 	 * @return The set of all colors the AUV saw carrying out this plan. Only used when we "evaluate as camera".
 	 */
-	boost::dynamic_bitset<> evaluatePlanInternal(const std::vector<std::vector<double> >& plan, osg::ref_ptr<osg::Geode> geode) const;
+	boost::dynamic_bitset<> evaluatePlanInternal(const std::vector<std::vector<double> >& plan, osg::ref_ptr<osg::Geode> geode,
+			EvaluationContext& context) const;
+
+	/**
+	 * Makes the plan we actually evaluate from a genotype: Appends the first point if the plan loops around.
+	 * @param plan The plan as given by the optimizer. Not modified.
+	 * @return The copy of the plan to evaluate.
+	 */
+	std::vector<std::vector<double> > prepareForEvaluation(const std::vector<std::vector<double> >& plan) const;
 
 	/**
 	 * Gives the default score to an empty plan
@@ -94,14 +337,22 @@ private:
 public:
 	/**
 	 * Constructor for the plan coverage estimator. The external planner calls this constructor, which sets everything up and prepares everything for making each plan estimation
-	 * rapid. Should only be called once for the entire optimization run.
+	 * rapid. Should only be called once for the entire optimization run. Estimators of a scene that another living estimator
+	 * has already loaded reuse its preprocessing, and are made much faster.
 	 * @param sceneFileName The path of the 3D-model file containing scene we are generating a plan for. The file has to be in an OSG-compatible format.
 	 * @param startLocation The (x,y,z) location in the scene where the robot starts. Should be the spot where we assume the robot will "arrive".
 	 * @param sensorSpecs Specifications for our sensor. See CameraEstimator.h for details
 	 * @param printerFriendly If true, the color scheme is optimized for Black-and-White printing. If false, it is optimized for color view.
+	 * @param visibilityMeshFaceFraction Outside post-processing, coverage may be estimated by rendering a simplified copy of
+	 * the inspection target (see VisibilityMesh) with this fraction of the model's triangles, though never fewer than
+	 * VISIBILITY_MESH_MIN_FACES. The model's triangles behind the faces seen are then scored with their areas. This is
+	 * much faster on large models, but scores differ slightly from those of the model itself. 1 renders the model itself,
+	 * as post-processing always does.
+	 * @throws std::invalid_argument if visibilityMeshFaceFraction is not in (0, 1].
 	 */
 	PlanCoverageEstimator(const std::string& sceneFileName, const std::vector<double>& sensorSpecs, bool postProcessing = false,
-			const std::vector<double>* startLocation = nullptr, bool planLoopsAround = false, bool printerFriendly = true);
+			const std::vector<double>* startLocation = nullptr, bool planLoopsAround = false, bool printerFriendly = true,
+			double visibilityMeshFaceFraction = 1.0);
 
 
 	/**
@@ -111,6 +362,24 @@ public:
 	 */
 	int updateMemoisedEdges(const std::vector<std::vector<std::vector<double> > >& allSolutions);
 
+	/**
+	 * Attaches this estimator to a table of memoised edges in shared memory, which all estimators on this host that attach
+	 * to the same name will read from and write to. This way, parallel evaluator processes do not render the same edges over again.
+	 * The table is created if it does not exist. Only useful together with memoization.
+	 * Edges are claimed before they are rendered, so when several processes miss the same edge, one renders it while the others wait.
+	 * @param name The name of the shared memory segment, e.g. "/inspection_edges".
+	 * @param capacity The maximum number of edges the table holds. Only used if the table is created by this call.
+	 * @throws std::invalid_argument if capacity is not positive.
+	 */
+	void attachSharedEdgeCache(const std::string& name, int capacity);
+
+	/**
+	 * Removes the shared edge table with the given name from the system. Should be called once all evaluators are done with it,
+	 * since shared memory outlives the processes using it.
+	 * @return true if a table was removed.
+	 */
+	static bool removeSharedEdgeCache(const std::string& name);
+
 	/**
 	 * Returns the number of "boxes" our planner needs to consider, that is, the number of different locations we have discretized our planning space into.
 	 * This will ensure the planner can stick to only valid plans: As we have N different locations, the planner should only consider plans locations with ID between 0 and N-1.
@@ -136,6 +405,9 @@ public:
 	void storePlanImage(const std::vector<std::vector<double> >& plan, const std::vector<std::vector<double> >& viewMatrix, std::string& storagePath);
 
 	double getMaxAllowedEnergy() const;
+
+	///@return The number of faces of the simplified inspection target we render, or 0 if we render the model itself.
+	int getVisibilityMeshFaceCount() const;
 	/**
 	 * Evaluates the given plan, and returns its evaluation along all relevant objectives.
 	 * @param plan a vector of plan elements. The representation can vary, and this is handled by having a separate InterpretPlan class that translates
@@ -152,6 +424,87 @@ public:
 									 plotting_style how_to_plot, bool disableEnergyLimit = false,
 									 osg::ref_ptr<osg::Group> returnedDrawable = nullptr);
 
+	/**
+	 * Registers a plan as a parent, whose children (plans differing from it by a few edits) we will evaluate with evaluateMutation.
+	 * For the parent, we keep track of how many of its edges see each triangle. A child is then scored by only looking at the edges
+	 * it does not share with the parent, instead of the whole plan.
+	 * Uses the edge memo, whether or not memoization is used in evaluatePlan. Release the parent with releaseParentPlan when done with it.
+	 * Unlike evaluatePlans, registerParentPlan, evaluateMutation and releaseParentPlan are not safe to call from several
+	 * threads at once: They share the parent plans and the estimator's own camera without locking.
+	 * @param plan The parent plan
+	 * @return A handle to the registered parent.
+	 */
+	int registerParentPlan(const std::vector<std::vector<double> >& plan);
+
+	/**
+	 * Evaluates a plan made by editing a registered parent plan. Gives the same scores as evaluatePlan (with no plotting and
+	 * the energy limit enabled) would for the edited plan, but only the edges that changed are looked up or rendered, not
+	 * every edge of the plan. The covered faces are then scored like evaluatePlan scores them.
+	 * @param parentHandle The handle of the parent, as given by registerParentPlan.
+	 * @param editOps The edits to apply to the parent, in order. Each edit is a vector of [edit type (a plan_edit_type), position, gene...].
+	 * Positions refer to the plan as it is after all previous edits. The gene is omitted for remove_gene.
+	 * @return A tuple of (coverage, energy_usage), like evaluatePlan.
+	 * @throws std::invalid_argument if the handle is unknown, or an edit is malformed.
+	 */
+	std::vector<double> evaluateMutation(int parentHandle, const std::vector<std::vector<double> >& editOps);
+
+	/**
+	 * Forgets a parent plan registered with registerParentPlan. Unknown handles are ignored.
+	 */
+	void releaseParentPlan(int parentHandle);
+
+	/**
+	 * Returns statistics of all evaluations since the estimator was made, or since resetStatistics was last called.
+	 * The memo size fields describe the memo as it is now.
+	 */
+	EvaluationStatistics getStatistics() const;
+
+	///Returns statistics of the last call to evaluatePlan, evaluateMutation or registerParentPlan.
+	EvaluationStatistics getLastCallStatistics() const {
+		return lastCallStatistics;
+	}
+
+	///Sets all cumulative statistics to zero.
+	void resetStatistics();
+
+	/**
+	 * Evaluates a batch of plans (typically all new plans in a generation), spreading them over several threads.
+	 * Gives the same scores as calling evaluatePlan (without plotting) for each plan. When called from Python, the
+	 * interpreter lock is released while evaluating, so other Python threads may run meanwhile.
+	 * In post-processing mode, plans are evaluated one at a time, but the edges of each plan are decoded in parallel.
+	 * @param plans The plans to evaluate
+	 * @param memoization As in evaluatePlan
+	 * @param disableEnergyLimit As in evaluatePlan
+	 * @return The (coverage, energy_usage) of each plan, in the same order as the plans.
+	 */
+	std::vector<std::vector<double> > evaluatePlans(const std::vector<std::vector<std::vector<double> > >& plans, bool memoization,
+			bool disableEnergyLimit = false);
+
+	/**
+	 * Sets the number of threads evaluatePlans uses. Takes effect the next time evaluatePlans is called.
+	 * @param numThreads The number of threads. 0 means one for each hardware thread.
+	 */
+	void setNumThreads(int numThreads);
+
+	int getNumThreads() const {
+		return numThreads;
+	}
+
+	/**
+	 * Starts rendering edges the next generation is likely to need, in the background, while the optimizer does
+	 * selection and variation. These are the edges created by moving a point of an elite plan to a neighboring box,
+	 * or by inserting a neighboring box next to it. The edges go into the memo, where the next evaluation finds them.
+	 * Uses one thread with lowered priority, and stops as soon as the estimator is used again.
+	 * Should be called after updateMemoisedEdges, which would otherwise remove the edges again.
+	 * @param elitePlans The plans whose mutations are likely, such as the current Pareto front.
+	 * @param edgeBudget The most edges to render.
+	 * @throws std::logic_error in post-processing, where nothing is memoized.
+	 */
+	void startSpeculativePrefetch(const std::vector<std::vector<std::vector<double> > >& elitePlans, int edgeBudget);
+
+	///Stops speculative prefetching, if it runs, and waits for the thread to finish its current edge.
+	void stopSpeculativePrefetch();
+
 	/**
 	 * Interprets the encoded plan, and returns the resulting waypoint positions and AUV orientations.
 	 * This is useful when we want to export a plan to another program or store calculated waypoints and orientations to file.
@@ -11,6 +11,7 @@
 
 #include "../../Utility_Functions/src/Constants.h"
 #include "../../Utility_Functions/src/OsgHelpers.h"
+#include "BoxCollisionMatrix.h"
 #include "PlanCoverageEstimator.h"
 #include "../../Utility_Functions/src/SceneKeeper.h"
 #include "PlanInterpreterBoxOrder.h"
@@ -22,7 +23,26 @@ double PlanEnergyEvaluator::decodeAndCalculateEnergyUsage(const std::vector<std:
 	osg::ref_ptr<osg::Vec3dArray> plannedPositions = new osg::Vec3dArray(); //All points we will visit
 	osg::ref_ptr<osg::Vec3dArray> plannedAngles = new osg::Vec3dArray();  //The angle the AUV will point towards in those positions.
 	planInterpreter->InterpretPlan(plan,*plannedPositions,*plannedAngles);
-	return calculateEnergyUsageOfPlan(*plannedPositions, sceneKeeper.getScene(), sceneKeeper.getCollisionPenalty());
+	double collisionPenalty = sceneKeeper.getCollisionPenalty();
+	if(collisionMatrix==nullptr || GRADED_COLLISION_PENALTY || collisionPenalty<=0 || plannedPositions->size()<2){
+		return calculateEnergyUsageOfPlan(*plannedPositions, sceneKeeper.getScene(), collisionPenalty);
+	}
+
+	//The same sum as calculateEnergyUsageOfPlan makes, but the collisions of edges between boxes are looked up.
+	double energyUsage = calculateEnergyUsageOfPlan(*plannedPositions);
+	size_t firstBoxPosition = plannedPositions->size()-plan.size(); //1 if the plan starts from startLocation.
+	if(firstBoxPosition>0 && (*plannedPositions)[0]!=(*plannedPositions)[1]
+			&& edgeComesTooCloseToStructure((*plannedPositions)[0], (*plannedPositions)[1], *sceneKeeper.getScene())){
+		energyUsage += collisionPenalty;
+	}
+	for(size_t step = 1; step<plan.size(); step++){
+		size_t fromBox = PlanInterpreterBoxOrder::getPointID(plan[step-1]);
+		size_t toBox = PlanInterpreterBoxOrder::getPointID(plan[step]);
+		if(fromBox!=toBox && collisionMatrix->edgeCollides(fromBox, toBox)){
+			energyUsage += collisionPenalty;
+		}
+	}
+	return energyUsage;
 }
 
 bool PlanEnergyEvaluator::energyWithinBounds(double energyUsed){
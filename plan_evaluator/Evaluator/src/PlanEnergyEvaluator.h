@@ -23,6 +23,7 @@ namespace utility_functions {
 namespace evolutionary_inspection_plan_evaluation {
 
 //Forward declarations
+class BoxCollisionMatrix;
 class PlanCoverageEstimator;
 class PlanInterpreterBoxOrder;
 
@@ -40,6 +41,7 @@ private:
 	PlanCoverageEstimator* coverageEstimator;		///A pointer to the object estimating coverage for plans
 	PlanInterpreterBoxOrder* planInterpreter;				///The object interpreting our plan (from sequence of numbers to an actual plan)
 	const utility_functions::SceneKeeper& sceneKeeper;				///The inspection target
+	BoxCollisionMatrix* collisionMatrix;			///Which edges between boxes collide. If nullptr, edges are checked against the scene.
 
 
 	/**
@@ -65,12 +67,15 @@ public:
 	 * @param pe Pointer to the object giving estimates of coverage
 	 * @param pi Pointer to the object interpreting plans
 	 * @param structure Pointer to the inspection target
+	 * @param collisionMatrix Optional. If given, collisions of edges between boxes are looked up here. The caller keeps ownership.
 	 */
-	PlanEnergyEvaluator(bool useEnergyLimit, PlanCoverageEstimator* pe, PlanInterpreterBoxOrder* pi, const utility_functions::SceneKeeper& sceneKeeper)
+	PlanEnergyEvaluator(bool useEnergyLimit, PlanCoverageEstimator* pe, PlanInterpreterBoxOrder* pi, const utility_functions::SceneKeeper& sceneKeeper,
+			BoxCollisionMatrix* collisionMatrix = nullptr)
 	:energyLimitValid(useEnergyLimit),
 	 coverageEstimator(pe),
 	 planInterpreter(pi),
-	 sceneKeeper(sceneKeeper){
+	 sceneKeeper(sceneKeeper),
+	 collisionMatrix(collisionMatrix){
 		if(useEnergyLimit){
 			calculateMaxAllowedEnergyUsage(); //Sets maxAllowedEnergy
 		}
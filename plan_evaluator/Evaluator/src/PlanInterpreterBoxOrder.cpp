@@ -7,29 +7,32 @@
 
 #include "PlanInterpreterBoxOrder.h"
 
+#include <algorithm>
 #include <iostream>
 #include <osg/Polytope>
 #include <osg/ShapeDrawable>
+#include <stdexcept>
 
 #include "../../Utility_Functions/src/Constants.h"
 #include "ContourTracing.h"
 #include "../../Utility_Functions/src/OsgHelpers.h"
 #include "../../Utility_Functions/src/SceneKeeper.h"
 #include "../../Utility_Functions/src/HelperMethods.h"
+#include "../../Utility_Functions/src/ThreadPool.h"
 
 
 using namespace utility_functions;
 namespace evolutionary_inspection_plan_evaluation {
 
-bool PlanInterpreterBoxOrder::boxNeighborsObject(int x, int y, int z) const{
-	std::vector<std::vector<int> > currentlayer = boxVolume[z];
-	for(int xNeighbor = -1; xNeighbor < 2; xNeighbor++){
-		for(int yNeighbor = -1; yNeighbor <2; yNeighbor++){
-			if(x+xNeighbor<0||(unsigned)(x+xNeighbor)>=currentlayer[0].size()||
-					y+yNeighbor<0||(unsigned)(y+yNeighbor)>=currentlayer.size()){
-				continue;
-			}
-			if(currentlayer[y+yNeighbor][x+xNeighbor]==-1){
+bool PlanInterpreterBoxOrder::boxNeighborsObject(const std::vector<char>& intersectingBoxes, size_t numRows, size_t numColumns,
+		size_t x, size_t y){
+	size_t firstRow = y > 0 ? y-1 : 0;
+	size_t lastRow = std::min(y+1, numRows-1);
+	size_t firstColumn = x > 0 ? x-1 : 0;
+	size_t lastColumn = std::min(x+1, numColumns-1);
+	for(size_t row = firstRow; row <= lastRow; row++){
+		for(size_t column = firstColumn; column <= lastColumn; column++){
+			if(intersectingBoxes[row*numColumns+column]){
 				return true;
 			}
 		}
@@ -37,73 +40,84 @@ bool PlanInterpreterBoxOrder::boxNeighborsObject(int x, int y, int z) const{
 	return false;
 }
 
-void PlanInterpreterBoxOrder::ProduceSimpleCirclingPlans(){
-
-	for(unsigned int z = 0; z<boxVolume.size(); z++){
-		std::vector<std::vector<int> > currentlayer = boxVolume[z];
-
-		//Holding true for those boxes that are on the edge or intersecting the structure, false for the others.
-		//Thereby, we can later trace around the outer edge of "true" areas, to find edges.
-		std::vector<std::vector<bool> > currentLayerEdgeBoxes;
-		for(unsigned int y=0; y<currentlayer.size();y++){
-			std::vector<int> currentRow = currentlayer[y];
-			std::vector<bool> currentRowEdgeBoxes;
-			for(unsigned int x=0; x<currentRow.size();x++){
-				int currentBox = currentRow[x];
-				if(currentBox==-1 || boxNeighborsObject(x,y,z)){
-					//Means this waypoint intersects with the scene OR neighbors the scene.
-					//In other words, it is "on the edge".
-					currentRowEdgeBoxes.push_back(true);
-				}
-				else{ //The box is NOT a "neighbor of the scene". Not part of simple plan.
-					currentRowEdgeBoxes.push_back(false);
-				}
-			}
-			currentLayerEdgeBoxes.push_back(currentRowEdgeBoxes);
+bool PlanInterpreterBoxOrder::produceCirclingPlanForLevel(size_t z, std::vector<std::vector<double> >& circlingPlanForCurrentLevel) const{
+	const std::vector<std::vector<int> >& currentlayer = boxVolume[z];
+	if(currentlayer.empty() || currentlayer[0].empty()){
+		return false;
+	}
+	size_t numRows = currentlayer.size();
+	size_t numColumns = currentlayer[0].size();
+	std::vector<char> intersectingBoxes(numRows*numColumns);
+	for(size_t y=0; y<numRows; y++){
+		for(size_t x=0; x<numColumns; x++){
+			intersectingBoxes[y*numColumns+x] = currentlayer[y][x]==-1;
 		}
+	}
 
-		//Tracing around the areas we have found to be on or neighboring the target structure.
-		std::vector<std::pair<int,int> > traces = mooreNeighborTracing(&currentLayerEdgeBoxes);
-		if(traces.size()==0){
-			//If we don't have any plan parts on this level, we move on to the next without adding it to our set of plans
-			continue;
+	//Holding true for those boxes that are on the edge or intersecting the structure, false for the others.
+	//Thereby, we can later trace around the outer edge of "true" areas, to find edges.
+	std::vector<std::vector<bool> > currentLayerEdgeBoxes(numRows, std::vector<bool>(numColumns, false));
+	for(size_t y=0; y<numRows; y++){
+		for(size_t x=0; x<numColumns; x++){
+			//A box neighbors itself, so this also holds for boxes intersecting the scene.
+			//In other words, it is "on the edge".
+			currentLayerEdgeBoxes[y][x] = boxNeighborsObject(intersectingBoxes, numRows, numColumns, x, y);
 		}
-		std::vector<std::vector<double> > circlingPlanForCurrentLevel;
-		for(unsigned int i =0; i<traces.size();i++){
-			int x = traces[i].first;
-			int y = traces[i].second;
-			//Asserting that the computed plan part is available
-			assert(x>=0&&(unsigned)x<currentlayer[0].size()&&y>=0&&(unsigned)y<currentlayer.size());
-
-
-			//Only adding the necessarry points to the plan. Unnecessarry are those points that are
-			//on a straight line between other plan points: The robot will naturally visit these anyway.
-			bool prevXIsInPlan = false;
-			bool nextXIsInPlan = false;
-			bool prevYIsInPlan = false;
-			bool nextYIsInPlan = false;
-			if(std::find(traces.begin(),traces.end(),std::pair<int,int>(x+1,y))!=traces.end()){
-				nextXIsInPlan = true;
-			}
-			if(std::find(traces.begin(),traces.end(),std::pair<int,int>(x-1,y))!=traces.end()){
-				prevXIsInPlan = true;
-			}
-			if(std::find(traces.begin(),traces.end(),std::pair<int,int>(x,y+1))!=traces.end()){
-				nextYIsInPlan = true;
-			}
-			if(std::find(traces.begin(),traces.end(),std::pair<int,int>(x,y-1))!=traces.end()){
-				prevYIsInPlan = true;
-			}
-			if(!((prevXIsInPlan&& nextXIsInPlan)||(prevYIsInPlan&&nextYIsInPlan))){
-				//if we are not on a straight line between other plan points: add the current waypoint.
-				std::vector<double> planPart;
-				planPart.push_back(boxVolume[z][y][x]);
-				circlingPlanForCurrentLevel.push_back(planPart);
+	}
+
+	//Tracing around the areas we have found to be on or neighboring the target structure.
+	std::vector<std::pair<int,int> > traces = mooreNeighborTracing(&currentLayerEdgeBoxes);
+	if(traces.size()==0){
+		return false;
+	}
+	//Marking the traced boxes, so we can look up if a box is in the trace directly.
+	std::vector<char> tracedBoxes(numRows*numColumns);
+	for(unsigned int i =0; i<traces.size();i++){
+		int x = traces[i].first;
+		int y = traces[i].second;
+		//Asserting that the computed plan part is available
+		assert(x>=0&&(unsigned)x<numColumns&&y>=0&&(unsigned)y<numRows);
+		tracedBoxes[y*numColumns+x] = true;
+	}
+	auto isTraced = [&](int x, int y){
+		return x>=0 && (unsigned)x<numColumns && y>=0 && (unsigned)y<numRows && tracedBoxes[y*numColumns+x];
+	};
+
+	for(unsigned int i =0; i<traces.size();i++){
+		int x = traces[i].first;
+		int y = traces[i].second;
+
+		//Only adding the necessarry points to the plan. Unnecessarry are those points that are
+		//on a straight line between other plan points: The robot will naturally visit these anyway.
+		bool prevXIsInPlan = isTraced(x-1,y);
+		bool nextXIsInPlan = isTraced(x+1,y);
+		bool prevYIsInPlan = isTraced(x,y-1);
+		bool nextYIsInPlan = isTraced(x,y+1);
+		if(!((prevXIsInPlan&& nextXIsInPlan)||(prevYIsInPlan&&nextYIsInPlan))){
+			//if we are not on a straight line between other plan points: add the current waypoint.
+			std::vector<double> planPart;
+			planPart.push_back(currentlayer[y][x]);
+			circlingPlanForCurrentLevel.push_back(planPart);
 
-			}
 		}
-		singleLevelCirclingPlans.push_back(circlingPlanForCurrentLevel);
+	}
+	return true;
+}
 
+void PlanInterpreterBoxOrder::ProduceSimpleCirclingPlans(){
+	//The levels are independent, so we trace them in parallel.
+	std::vector<std::vector<std::vector<double> > > levelPlans(boxVolume.size());
+	std::vector<char> levelIsTraced(boxVolume.size());
+	ThreadPool threadPool(0);
+	threadPool.parallelFor(boxVolume.size(), [&](size_t z, size_t){
+		levelIsTraced[z] = produceCirclingPlanForLevel(z, levelPlans[z]);
+	});
+	for(unsigned int z = 0; z<levelPlans.size(); z++){
+		if(!levelIsTraced[z]){
+			//If we don't have any plan parts on this level, we move on to the next without adding it to our set of plans
+			continue;
+		}
+		singleLevelCirclingPlans.push_back(levelPlans[z]);
 	}
 
 }
@@ -172,12 +186,41 @@ PlanInterpreterBoxOrder::PlanInterpreterBoxOrder(SceneKeeper& sceneKeeper, osg::
  camEstimator(camEstimator),
 sceneKeeper(sceneKeeper),
 coloredScene(coloredScene),
-post_processing(post_processing)
+post_processing(post_processing),
+decodingThreadPool(nullptr)
 {
 	boxCenters = new osg::Vec3dArray();
 	divideIntoBoxes(boxes);
 }
 
+PlanInterpreterBoxOrder::PlanInterpreterBoxOrder(SceneKeeper& sceneKeeper, const BoxGrid& grid, CameraEstimator & camEstimator,
+		osg::ref_ptr<osg::Geode> coloredScene, const std::vector<double>* startLocation/* = nullptr*/, bool post_processing/*=false*/)
+:startLocation(startLocation),
+ sceneKeeper(sceneKeeper),
+ boxCenters(grid.boxCenters),
+ boxVolume(grid.boxVolume),
+ camEstimator(camEstimator),
+ coloredScene(coloredScene),
+ post_processing(post_processing),
+ decodingThreadPool(nullptr)
+{
+	if(boxCenters==nullptr){
+		throw std::invalid_argument("ERROR! Cannot make a plan interpreter from a box grid that has not been made yet.");
+	}
+	if(grid.hasCirclingPlans){
+		singleLevelCirclingPlans = grid.singleLevelCirclingPlans;
+	}
+}
+
+void PlanInterpreterBoxOrder::exportBoxGrid(BoxGrid& grid, bool includeCirclingPlans) const{
+	grid.boxVolume = boxVolume;
+	grid.boxCenters = boxCenters;
+	if(includeCirclingPlans){
+		grid.singleLevelCirclingPlans = singleLevelCirclingPlans;
+		grid.hasCirclingPlans = true;
+	}
+}
+
 void PlanInterpreterBoxOrder::drawAllBoxes(osg::ref_ptr<osg::Geode> draw_to_geode) const{
 
 	for(auto const& coord: *boxCenters){
@@ -206,41 +249,50 @@ void PlanInterpreterBoxOrder::divideIntoBoxes(osg::ref_ptr<osg::Vec3dArray> boxe
 	if(DOWNWARD_CAMERA_ACTIVE){
 		maxZ+=BOX_PADDING; //To allow plans going above structures, to inspect them.
 	}
+	//The grid coordinates, stepped exactly as when the grid was classified one cell at a time, so the boxes stay the same.
+	std::vector<double> zValues, xValues, yValues;
 	for(double z = minZ; z<maxZ; z+=viewpoint_interval){
+		zValues.push_back(z);
+	}
+	for(double x = bb._min.x()-BOX_PADDING; x<bb._max.x()+BOX_PADDING; x+=viewpoint_interval){
+		xValues.push_back(x);
+	}
+	for(double y = bb._min.y()-BOX_PADDING; y<bb._max.y()+BOX_PADDING; y+=viewpoint_interval){
+		yValues.push_back(y);
+	}
+
+	//Classifying the cells is independent for each cell, and takes two intersection tests against the whole scene.
+	//We spread the rows of the grid over a thread pool.
+	std::vector<int> cellClasses(zValues.size()*xValues.size()*yValues.size());
+	osg::Node& scene = *sceneKeeper.getScene();
+	prepareSceneForConcurrentIntersections(scene);
+	ThreadPool threadPool(0);
+	threadPool.parallelFor(zValues.size()*xValues.size(), [&](size_t rowIndex, size_t){
+		double z = zValues[rowIndex/xValues.size()];
+		double x = xValues[rowIndex%xValues.size()];
+		for(size_t yIndex = 0; yIndex<yValues.size(); yIndex++){
+			cellClasses[rowIndex*yValues.size()+yIndex] = classifyViewpoint(osg::Vec3d(x,yValues[yIndex],z), scene);
+		}
+	});
+
+	//Numbering the useful viewpoints in the same z/x/y order as always, so box IDs do not depend on the threads.
+	for(size_t zIndex = 0; zIndex<zValues.size(); zIndex++){
 		std::vector<std::vector<int> > currentLayer;
-		for(double x = bb._min.x()-BOX_PADDING; x<bb._max.x()+BOX_PADDING; x+=viewpoint_interval){
+		for(size_t xIndex = 0; xIndex<xValues.size(); xIndex++){
 			std::vector<int> currentRow;
-			for(double y = bb._min.y()-BOX_PADDING; y<bb._max.y()+BOX_PADDING; y+=viewpoint_interval){
-				osg::Vec3d viewpoint(x,y,z);
-				//Box used to check if viewpoints have sufficient distance from the target.
-				osg::Polytope distanceBox = generateBoxPolytope(viewpoint,BOX_SAFETY_MARGIN);
-				bool viewpointIsTooClose = checkPolytopeForIntersections(distanceBox,*sceneKeeper.getScene());
-				if(viewpointIsTooClose){
-					currentRow.push_back(-1);
-					continue;
-				}
-
-				//Box used to check if viewpoints are close enough to see the target
-				//TODO: This would be better approximated by a sphere, but OSG does not have a class for
-				//sphere intersections. Given that we don't need a 100% accuracy here, I don't know if implementing that is worth the cost.
-				//On second thought, a box is not so bad here - the camera does cover a rectangle at CAMERA_FAR_PLANE_DIST.
-				//Anyway, it should not be a problem that we overestimate here, as it will in the worst case lead us to
-				//consider some unnecessarry viewpoints in our planner. But visibility calculations will correctly tell us
-				//that we cannot see anything at this viewpoint.
-				osg::Polytope visibilityBox = generateBoxPolytope(viewpoint, CAMERA_FAR_PLANE_DIST);
-				bool anythingIsVisible = checkPolytopeForIntersections(visibilityBox,*sceneKeeper.getScene());
-
-				//bool anythingIsVisible = viewpointIsUseful(viewpoint); //Checks if we can see anything at all from that point. Otherwise, we don't consider it as a candidate viewpoint.
-				if(anythingIsVisible){
+			for(size_t yIndex = 0; yIndex<yValues.size(); yIndex++){
+				int cellClass = cellClasses[(zIndex*xValues.size()+xIndex)*yValues.size()+yIndex];
+				if(cellClass==USEFUL_VIEWPOINT){
+					osg::Vec3d viewpoint(xValues[xIndex],yValues[yIndex],zValues[zIndex]);
 					currentRow.push_back(boxCenters->size());
 
-					boxCenters->push_back(osg::Vec3d(x,y,z));
+					boxCenters->push_back(viewpoint);
 					if(boxes!=nullptr){
-						boxes->push_back(osg::Vec3d(x,y,z));
+						boxes->push_back(viewpoint);
 					}
 				}
-				else{//If nothing was visible here, we do not consider a waypoint.
-					currentRow.push_back(-2);
+				else{
+					currentRow.push_back(cellClass);
 				}
 			}//Iteration over current row done
 			currentLayer.push_back(currentRow);
@@ -250,18 +302,49 @@ void PlanInterpreterBoxOrder::divideIntoBoxes(osg::ref_ptr<osg::Vec3dArray> boxe
 	}
 }
 
+int PlanInterpreterBoxOrder::classifyViewpoint(const osg::Vec3d& viewpoint, osg::Node& scene){
+	//Box used to check if viewpoints have sufficient distance from the target.
+	bool viewpointIsTooClose = collisionCheckWithBuffer(viewpoint,scene,BOX_SAFETY_MARGIN);
+	if(viewpointIsTooClose){
+		return -1;
+	}
+
+	//Box used to check if viewpoints are close enough to see the target
+	//TODO: This would be better approximated by a sphere, but OSG does not have a class for
+	//sphere intersections. Given that we don't need a 100% accuracy here, I don't know if implementing that is worth the cost.
+	//On second thought, a box is not so bad here - the camera does cover a rectangle at CAMERA_FAR_PLANE_DIST.
+	//Anyway, it should not be a problem that we overestimate here, as it will in the worst case lead us to
+	//consider some unnecessarry viewpoints in our planner. But visibility calculations will correctly tell us
+	//that we cannot see anything at this viewpoint.
+	//collisionCheckWithBuffer checks the same box, but lets the scene's distance field answer viewpoints near the target.
+	bool anythingIsVisible = collisionCheckWithBuffer(viewpoint,scene,CAMERA_FAR_PLANE_DIST);
+
+	//bool anythingIsVisible = viewpointIsUseful(viewpoint); //Checks if we can see anything at all from that point. Otherwise, we don't consider it as a candidate viewpoint.
+	if(anythingIsVisible){
+		return USEFUL_VIEWPOINT;
+	}
+	else{//If nothing was visible here, we do not consider a waypoint.
+		return -2;
+	}
+}
+
 osg::Vec3d PlanInterpreterBoxOrder::getPositionFromGene(const std::vector<std::vector<double> >& genotype, size_t geneID) const{
 	size_t pointID = (size_t) (genotype[geneID][0]+0.5);
 	return getBoxPosition(pointID);
 }
 
 osg::Vec3d PlanInterpreterBoxOrder::calculateSensorDirectionAndNormalize(const osg::Vec3d& prevPosition, const osg::Vec3d& nextPosition, float offsetRadians/*=0*/) const{
+	return calculateSensorDirectionAndNormalize(prevPosition, nextPosition, offsetRadians, this->camEstimator, coloredScene.get());
+}
+
+osg::Vec3d PlanInterpreterBoxOrder::calculateSensorDirectionAndNormalize(const osg::Vec3d& prevPosition, const osg::Vec3d& nextPosition,
+		float offsetRadians, CameraEstimator& camera, osg::ref_ptr<osg::Node> scene) const{
 	//Calculating the direction the sensor will have when moving from previous to current point.
 	osg::Vec3d sensorDirection;
 	if(post_processing){
 		//Slow calculation - for post-processing
 		sensorDirection = calculateViewingDirectionTowardsPrimitives(prevPosition,nextPosition,sceneKeeper.getSceneCenter(),
-																	 this->camEstimator, coloredScene,sceneKeeper.getTriangleStore());
+																	 camera, scene,sceneKeeper.getTriangleStore());
 	}
 	else{
 		//Quick calculation - during optimization
@@ -278,7 +361,7 @@ osg::Vec3d PlanInterpreterBoxOrder::calculateSensorDirectionAndNormalize(const o
 void PlanInterpreterBoxOrder::InterpretOnePlanPoint(osg::Vec3d* prevPosition, const std::vector<double>& encodedPlanPoint, osg::Vec3dArray& positions,
 		osg::Vec3dArray& sensorDirections) const{
 
-	size_t pointID = (size_t) (encodedPlanPoint[0]+0.5);
+	size_t pointID = getPointID(encodedPlanPoint);
 	assert(pointID < boxCenters->size());
 	float sensor_dir_offset = 0;
 	if (encodedPlanPoint.size() > 1){
@@ -302,6 +385,10 @@ void PlanInterpreterBoxOrder::InterpretPlan(const std::vector<std::vector<double
 	if(plan.size()==0){
 		return;
 	}
+	if(post_processing && decodingThreadPool!=nullptr){
+		InterpretPlanInParallel(plan, plannedPositions, plannedAngles);
+		return;
+	}
 
 	if(startLocation!=nullptr){ //If given, the first point is equal to the startlocation.
 		plannedPositions.push_back(osg::Vec3d((*startLocation)[0], (*startLocation)[1], (*startLocation)[2]));
@@ -324,11 +411,78 @@ void PlanInterpreterBoxOrder::InterpretPlan(const std::vector<std::vector<double
 }
 
 
+void PlanInterpreterBoxOrder::InterpretPlanInParallel(const std::vector<std::vector<double> >& plan, osg::Vec3dArray& plannedPositions,
+		osg::Vec3dArray& plannedAngles) const{
+	//The positions are just box centers. Each edge then goes from one position to the next.
+	if(startLocation!=nullptr){ //If given, the first point is equal to the startlocation.
+		plannedPositions.push_back(osg::Vec3d((*startLocation)[0], (*startLocation)[1], (*startLocation)[2]));
+	}
+	std::vector<float> sensorDirectionOffsets; //For the edge leading to each new position.
+	for(std::vector<std::vector<double> >::const_iterator it = plan.begin(); it!=plan.end();it++){
+		size_t pointID = getPointID(*it);
+		assert(pointID < boxCenters->size());
+		if(plannedPositions.size()!=0){ //True for all but the first point in the plan.
+			sensorDirectionOffsets.push_back(it->size() > 1 ? (*it)[1] : 0);
+		}
+		plannedPositions.push_back(boxCenters->at(pointID));
+	}
+
+	//Finding the sensor direction of each edge, in parallel.
+	size_t firstEdgeStart = plannedPositions.size() - 1 - sensorDirectionOffsets.size();
+	std::vector<osg::Vec3d> sensorDirections(sensorDirectionOffsets.size());
+	decodingThreadPool->parallelFor(sensorDirections.size(), [&](size_t edge, size_t workerIndex){
+		sensorDirections[edge] = calculateSensorDirectionAndNormalize(plannedPositions[firstEdgeStart+edge],
+				plannedPositions[firstEdgeStart+edge+1], sensorDirectionOffsets[edge], *decodingCameras[workerIndex], decodingScenes[workerIndex]);
+	});
+	plannedAngles.insert(plannedAngles.end(), sensorDirections.begin(), sensorDirections.end());
+}
+
+void PlanInterpreterBoxOrder::setDecodingWorkers(ThreadPool* threadPool, const std::vector<CameraEstimator*>& cameras,
+		const std::vector<osg::ref_ptr<osg::Node> >& scenes){
+	if(threadPool!=nullptr && (cameras.size()!=threadPool->size() || scenes.size()!=threadPool->size())){
+		throw std::invalid_argument("ERROR! Need one camera and one scene for each decoding thread.");
+	}
+	decodingThreadPool = threadPool;
+	decodingCameras = cameras;
+	decodingScenes = scenes;
+}
+
 osg::Vec3d PlanInterpreterBoxOrder::getBoxPosition(size_t id) const{
 	assert(id<boxCenters->size());
 	return boxCenters->at(id);
 }
 
+std::vector<size_t> PlanInterpreterBoxOrder::getNeighboringBoxes(size_t id) const{
+	std::vector<size_t> neighbors;
+	//Finding the cell of the box. Only done for a few boxes at a time, so a plain search is fast enough.
+	for(size_t z = 0; z<boxVolume.size(); z++){
+		for(size_t x = 0; x<boxVolume[z].size(); x++){
+			const std::vector<int>& row = boxVolume[z][x];
+			std::vector<int>::const_iterator cell = std::find(row.begin(), row.end(), (int) id);
+			if(cell==row.end()){
+				continue;
+			}
+			size_t y = cell - row.begin();
+			for(int dz = -1; dz<=1; dz++){
+				for(int dx = -1; dx<=1; dx++){
+					for(int dy = -1; dy<=1; dy++){
+						size_t nz = z+dz, nx = x+dx, ny = y+dy; //Wrap around to huge values when stepping below 0.
+						if((dz==0 && dx==0 && dy==0) || nz>=boxVolume.size() || nx>=boxVolume[nz].size() || ny>=boxVolume[nz][nx].size()){
+							continue;
+						}
+						int neighbor = boxVolume[nz][nx][ny];
+						if(neighbor>=0){
+							neighbors.push_back(neighbor);
+						}
+					}
+				}
+			}
+			return neighbors;
+		}
+	}
+	return neighbors;
+}
+
 
 } /* namespace evolutionary_inspection_plan_evaluation */
 
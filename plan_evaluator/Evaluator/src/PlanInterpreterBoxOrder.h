@@ -15,16 +15,34 @@
 #include <osg/ref_ptr>
 #include <osg/Vec3d>
 #include <vector>
-#include <bits/unique_ptr.h>
+#include <memory>
 #include "../../Utility_Functions/src/CameraEstimator.h"
 
 //Forward declarations
 namespace utility_functions{
 	class SceneKeeper;
+	class ThreadPool;
 }
 
 namespace evolutionary_inspection_plan_evaluation {
 
+class BoxCollisionMatrix;
+
+/**
+ * The candidate viewpoints of a scene, and the circling plans through them. Only depends on the scene, so all
+ * interpreters of the same scene can share them. See SceneRegistry.
+ */
+struct BoxGrid {
+	std::vector<std::vector<std::vector<int> > > boxVolume;	///<As PlanInterpreterBoxOrder::boxVolume.
+	osg::ref_ptr<osg::Vec3dArray> boxCenters;				///<nullptr until the grid has been made. Never modified after that.
+	std::vector<std::vector<std::vector<double> > > singleLevelCirclingPlans;
+	bool hasCirclingPlans;									///<False until the circling plans have been traced.
+	std::shared_ptr<BoxCollisionMatrix> collisionMatrix;	///<Which edges between the boxes collide. nullptr until the grid has been made.
+
+	BoxGrid()
+	:hasCirclingPlans(false){}
+};
+
 /**
  * A plan interpreter which interprets a plan as a sequence of "Boxes" (approximate coordinates) to visit.
  */
@@ -57,14 +75,29 @@ private:
 	///When true, we do a more thorough post-evolution decoding.
 	bool post_processing;
 
+	///If set, post-processing decodes the sensor directions of all edges in a plan in parallel on these threads.
+	utility_functions::ThreadPool* decodingThreadPool;
+	std::vector<utility_functions::CameraEstimator*> decodingCameras;	///<One camera for each thread in decodingThreadPool.
+	std::vector<osg::ref_ptr<osg::Node> > decodingScenes;				///<One copy of the colored scene for each thread in decodingThreadPool.
+
 	/**
-	 * Tells us if a given box in boxVolume is a neighbor of the inspection target - that is, that there is no
+	 * Tells us if a given box in one level of boxVolume is a neighbor of the inspection target - that is, that there is no
 	 * other box between it and the inspection target. This is useful to know when we want to generate a plan
 	 * circling the target at close distance.
-	 * @param x, y, z The location of the queried box in our boxVolume structure
+	 * @param intersectingBoxes The level, flattened row by row, with true for the boxes intersecting the target (-1 in boxVolume).
+	 * @param numRows, numColumns The size of the level.
+	 * @param x, y The location of the queried box in the level. y is the row, and x the position in it.
 	 * @return true if box neighbors object, false otherwise
 	 */
-	bool boxNeighborsObject(int x, int y, int z) const;
+	static bool boxNeighborsObject(const std::vector<char>& intersectingBoxes, size_t numRows, size_t numColumns, size_t x, size_t y);
+
+	/**
+	 * Produces the plan circling the structure at a single level of boxVolume. See ProduceSimpleCirclingPlans.
+	 * @param z The level
+	 * @param[out] circlingPlanForCurrentLevel The plan, returned by reference.
+	 * @return false if nothing at this level is near the structure, so there is no plan for it.
+	 */
+	bool produceCirclingPlanForLevel(size_t z, std::vector<std::vector<double> >& circlingPlanForCurrentLevel) const;
 
 	/**
 	 * Divides the scene into boxes, following the parameters set in the constructor.
@@ -75,6 +108,16 @@ private:
 	 */
 	void divideIntoBoxes(osg::ref_ptr<osg::Vec3dArray> boxes);
 
+	///Returned by classifyViewpoint for viewpoints we keep as boxes. The other values are as in boxVolume.
+	static const int USEFUL_VIEWPOINT = 0;
+
+	/**
+	 * Decides if a grid point is a useful viewpoint. Only reads the scene, so several threads may classify viewpoints
+	 * at once, as long as prepareSceneForConcurrentIntersections has been called on the scene.
+	 * @return USEFUL_VIEWPOINT, or the value that boxVolume uses for viewpoints too far from or too close to the target.
+	 */
+	static int classifyViewpoint(const osg::Vec3d& viewpoint, osg::Node& scene);
+
 	//Preventing copying of this object.
 	//Here, I'm disallowing copy-constructors for this object. Since this is a large object, we want to avoid copies, and rather use pointers.
 	PlanInterpreterBoxOrder(const PlanInterpreterBoxOrder&) = delete;
@@ -83,6 +126,16 @@ private:
 
 	osg::Vec3d calculateSensorDirectionAndNormalize(const osg::Vec3d& prevPosition, const osg::Vec3d& nextPosition, float offsetRadians=0) const;
 
+	///As above, but post-processing renders with the given camera and scene instead of our own.
+	osg::Vec3d calculateSensorDirectionAndNormalize(const osg::Vec3d& prevPosition, const osg::Vec3d& nextPosition, float offsetRadians,
+			utility_functions::CameraEstimator& camera, osg::ref_ptr<osg::Node> scene) const;
+
+	/**
+	 * As InterpretPlan, but finds the sensor directions of all edges in parallel on decodingThreadPool. The directions
+	 * only depend on the two box positions of each edge, so they are independent of each other.
+	 */
+	void InterpretPlanInParallel(const std::vector<std::vector<double> >& plan, osg::Vec3dArray& plannedPositions, osg::Vec3dArray& plannedAngles) const;
+
 public:
 
 	/**
@@ -95,6 +148,19 @@ public:
 	PlanInterpreterBoxOrder(utility_functions::SceneKeeper& sceneKeeper, osg::ref_ptr<osg::Vec3dArray> boxes, utility_functions::CameraEstimator & camEstimator,
 			osg::ref_ptr<osg::Geode> coloredScene, const std::vector<double>* startLocation = nullptr, bool post_processing = false);
 
+	/**
+	 * As above, but takes the boxes (and circling plans, if traced) from a grid made earlier for the same scene,
+	 * instead of dividing the scene anew.
+	 */
+	PlanInterpreterBoxOrder(utility_functions::SceneKeeper& sceneKeeper, const BoxGrid& grid, utility_functions::CameraEstimator & camEstimator,
+			osg::ref_ptr<osg::Geode> coloredScene, const std::vector<double>* startLocation = nullptr, bool post_processing = false);
+
+	/**
+	 * Copies our boxes into a grid, so later interpreters of the same scene can be made from it.
+	 * @param includeCirclingPlans If true, ProduceSimpleCirclingPlans has been called, and the circling plans are copied too.
+	 */
+	void exportBoxGrid(BoxGrid& grid, bool includeCirclingPlans) const;
+
 
 	virtual ~PlanInterpreterBoxOrder();
 
@@ -131,6 +197,15 @@ public:
 
 	osg::Vec3d getPositionFromGene(const std::vector<std::vector<double> >& genotype, size_t geneID) const;
 
+	/**
+	 * Returns the ID of the box a plan point visits.
+	 * @param encodedPlanPoint The plan point. The first element is the box ID, possibly turned into a double by the Python-C type translation.
+	 * @return The box ID, rounded to the nearest integer.
+	 */
+	static size_t getPointID(const std::vector<double>& encodedPlanPoint) {
+		return (size_t) (encodedPlanPoint[0]+0.5);
+	}
+
 	/**
 	 * Returns the center location of a given box
 	 * @param id The box ID
@@ -138,6 +213,14 @@ public:
 	 */
 	osg::Vec3d getBoxPosition(size_t id) const;
 
+	/**
+	 * Returns the boxes next to the given box in boxVolume, in any of the 26 directions. Small mutations of a plan tend
+	 * to move its points to these.
+	 * @param id The box ID
+	 * @return The IDs of the neighboring boxes, leaving out grid cells that are not boxes.
+	 */
+	std::vector<size_t> getNeighboringBoxes(size_t id) const;
+
 	/**
 	 * Produces a set of simple plans circling around the current structure at various levels.
 	 * The plans are stored into member variable singleLevelCirclingPlans.
@@ -160,6 +243,16 @@ public:
 		post_processing = postProcessing;
 	}
 
+	/**
+	 * Lets post-processing decode the edges of a plan in parallel. Each thread needs its own camera and copy of the
+	 * colored scene to render with. The caller keeps ownership of all of them.
+	 * @param threadPool The threads to decode on, or nullptr to decode serially with our own camera.
+	 * @param cameras One camera for each thread in the pool
+	 * @param scenes One copy of the colored scene for each thread in the pool
+	 */
+	void setDecodingWorkers(utility_functions::ThreadPool* threadPool, const std::vector<utility_functions::CameraEstimator*>& cameras,
+			const std::vector<osg::ref_ptr<osg::Node> >& scenes);
+
 	void drawAllBoxes(osg::ref_ptr<osg::Geode> draw_to_geode) const;
 
 };
@@ -0,0 +1,97 @@
+/*
+ * PlanPrefixTrie.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include "PlanPrefixTrie.h"
+
+#include <stdexcept>
+
+using namespace utility_functions;
+
+namespace evolutionary_inspection_plan_evaluation {
+
+PlanPrefixTrie::PlanPrefixTrie(size_t snapshotInterval)
+:snapshotInterval(snapshotInterval),
+ numNodes(0),
+ currentMark(0){
+	if (snapshotInterval == 0) {
+		throw std::invalid_argument("The snapshot interval of a plan prefix trie has to be positive.");
+	}
+}
+
+size_t PlanPrefixTrie::findLongestKnownPrefix(const std::vector<std::string>& geneNames, CoveragePattern& coverage) const {
+	size_t longestPrefix = 0;
+	const Node* node = &root;
+	for (size_t depth = 1; depth <= geneNames.size(); depth++) {
+		std::map<std::string, std::unique_ptr<Node> >::const_iterator child = node->children.find(geneNames[depth - 1]);
+		if (child == node->children.end()) {
+			break;
+		}
+		node = child->second.get();
+		if (node->coverage) {
+			longestPrefix = depth;
+			coverage = node->coverage;
+		}
+	}
+	return longestPrefix;
+}
+
+void PlanPrefixTrie::storePrefix(const std::vector<std::string>& geneNames, size_t prefixLength, const boost::dynamic_bitset<>& coverage) {
+	Node* node = &root;
+	for (size_t depth = 1; depth <= prefixLength; depth++) {
+		std::unique_ptr<Node>& child = node->children[geneNames[depth - 1]];
+		if (!child) {
+			child.reset(new Node());
+			child->mark = currentMark; //New nodes survive until the next pruning.
+			numNodes++;
+		}
+		node = child.get();
+	}
+	if (!node->coverage) {
+		node->coverage = patterns.intern(coverage);
+	}
+}
+
+void PlanPrefixTrie::removeUnmarkedChildren(Node& node) {
+	for (std::map<std::string, std::unique_ptr<Node> >::iterator child = node.children.begin(); child != node.children.end();) {
+		if (child->second->mark != currentMark) {
+			//The whole subtree goes. Counting its nodes before freeing them.
+			std::vector<const Node*> subtree(1, child->second.get());
+			while (!subtree.empty()) {
+				const Node* removed = subtree.back();
+				subtree.pop_back();
+				numNodes--;
+				for (std::map<std::string, std::unique_ptr<Node> >::const_iterator grandChild = removed->children.begin();
+						grandChild != removed->children.end(); grandChild++) {
+					subtree.push_back(grandChild->second.get());
+				}
+			}
+			node.children.erase(child++);
+		} else {
+			removeUnmarkedChildren(*child->second);
+			child++;
+		}
+	}
+}
+
+size_t PlanPrefixTrie::retainOnly(const std::vector<std::vector<std::string> >& plansToKeep) {
+	currentMark++;
+	for (std::vector<std::vector<std::string> >::const_iterator plan = plansToKeep.begin(); plan != plansToKeep.end(); plan++) {
+		Node* node = &root;
+		for (std::vector<std::string>::const_iterator geneName = plan->begin(); geneName != plan->end(); geneName++) {
+			std::map<std::string, std::unique_ptr<Node> >::iterator child = node->children.find(*geneName);
+			if (child == node->children.end()) {
+				break;
+			}
+			node = child->second.get();
+			node->mark = currentMark;
+		}
+	}
+	removeUnmarkedChildren(root);
+	patterns.releaseUnused();
+	return numNodes;
+}
+
+} /* namespace evolutionary_inspection_plan_evaluation */
@@ -0,0 +1,99 @@
+/*
+ * PlanPrefixTrie.h
+ *
+ * A trie over the plans in the population, remembering the combined coverage of plan prefixes. Plans made by mutation
+ * and crossover share long prefixes with their parents, and with this, evaluating them only requires looking at the
+ * genes after the longest prefix we know the coverage of.
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef PLANPREFIXTRIE_H_
+#define PLANPREFIXTRIE_H_
+
+#include <boost/dynamic_bitset/dynamic_bitset.hpp>
+#include <map>
+#include <memory>
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+#include "../../Utility_Functions/src/CoveragePatternPool.h"
+
+namespace evolutionary_inspection_plan_evaluation {
+
+/**
+ * Each node in the trie is a plan prefix, and each edge from a node to a child is the next gene of the plan, indexed
+ * by the gene's name (as used in the edge memo). To limit memory use, coverages are only stored at every
+ * snapshotInterval'th depth. Coverages are pooled, so prefixes seeing the same primitives share one bitset.
+ */
+class PlanPrefixTrie {
+
+private:
+	struct Node {
+		std::map<std::string, std::unique_ptr<Node> > children;
+		utility_functions::CoveragePattern coverage;	///<The coverage of the whole prefix up to this node. Empty if not stored.
+		unsigned int mark;								///<The last pruning round in which this node was part of a plan we keep.
+
+		Node():mark(0){}
+	};
+
+	Node root;
+	size_t snapshotInterval;	///<We store the coverage of prefixes whose length is a multiple of this.
+	size_t numNodes;
+	unsigned int currentMark;
+	utility_functions::CoveragePatternPool patterns;
+
+	///Removes all children of node that were not marked in the current pruning round.
+	void removeUnmarkedChildren(Node& node);
+
+public:
+
+	/**
+	 * @param snapshotInterval We store the coverage of prefixes whose length is a multiple of this. Lower values speed up
+	 * evaluations, at the cost of memory.
+	 */
+	explicit PlanPrefixTrie(size_t snapshotInterval);
+
+	///@return true if we store the coverage of prefixes of the given length.
+	bool isSnapshotDepth(size_t depth) const {
+		return depth > 0 && depth % snapshotInterval == 0;
+	}
+
+	/**
+	 * Finds the longest prefix of a plan that we know the coverage of.
+	 * @param geneNames The names of the genes in the plan.
+	 * @param[out] coverage Set to the coverage of the prefix, if one was found.
+	 * @return The length of the prefix. 0 if we know no prefix of this plan.
+	 */
+	size_t findLongestKnownPrefix(const std::vector<std::string>& geneNames, utility_functions::CoveragePattern& coverage) const;
+
+	/**
+	 * Stores the coverage of the first prefixLength genes of a plan.
+	 * @param geneNames The names of the genes in the plan.
+	 * @param prefixLength The length of the prefix. Should be a snapshot depth.
+	 * @param coverage The combined coverage of all edges in the prefix.
+	 */
+	void storePrefix(const std::vector<std::string>& geneNames, size_t prefixLength, const boost::dynamic_bitset<>& coverage);
+
+	/**
+	 * Forgets all prefixes that are not part of any of the given plans.
+	 * @param plansToKeep The gene names of every plan we keep.
+	 * @return The number of prefixes (trie nodes) remaining.
+	 */
+	size_t retainOnly(const std::vector<std::vector<std::string> >& plansToKeep);
+
+	///@return The number of prefixes in the trie.
+	size_t size() const {
+		return numNodes;
+	}
+
+	///@return The number of distinct coverages stored in the trie.
+	size_t numDistinctPatterns() const {
+		return patterns.size();
+	}
+};
+
+} /* namespace evolutionary_inspection_plan_evaluation */
+
+#endif /* PLANPREFIXTRIE_H_ */
@@ -0,0 +1,59 @@
+/*
+ * PlanResultCache.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include "PlanResultCache.h"
+
+#include "PlanInterpreterBoxOrder.h"
+
+namespace evolutionary_inspection_plan_evaluation {
+
+PlanResultCache::PlanResultCache(size_t capacity)
+:capacity(capacity){
+}
+
+CanonicalPlan PlanResultCache::canonicalForm(const std::vector<std::vector<double> >& plan) {
+	CanonicalPlan canonicalPlan;
+	canonicalPlan.reserve(plan.size());
+	for (std::vector<std::vector<double> >::const_iterator planPoint = plan.begin(); planPoint != plan.end(); planPoint++) {
+		float sensorDirectionOffset = 0; //Same default and precision as in PlanInterpreterBoxOrder::InterpretOnePlanPoint
+		if (planPoint->size() > 1) {
+			sensorDirectionOffset = (*planPoint)[1];
+		}
+		canonicalPlan.push_back(std::make_pair(PlanInterpreterBoxOrder::getPointID(*planPoint), sensorDirectionOffset));
+	}
+	return canonicalPlan;
+}
+
+bool PlanResultCache::find(const CanonicalPlan& plan, bool disableEnergyLimit, std::vector<double>& planScores) const {
+	std::unordered_map<Key, std::vector<double> >::const_iterator entry = scores.find(Key(disableEnergyLimit, plan));
+	if (entry == scores.end()) {
+		return false;
+	}
+	planScores = entry->second;
+	return true;
+}
+
+void PlanResultCache::insert(const CanonicalPlan& plan, bool disableEnergyLimit, const std::vector<double>& planScores) {
+	if (capacity == 0) {
+		return;
+	}
+	Key key(disableEnergyLimit, plan);
+	if (!scores.insert(std::make_pair(key, planScores)).second) {
+		return; //Already cached.
+	}
+	insertionOrder.push_back(key);
+	if (insertionOrder.size() > capacity) {
+		scores.erase(insertionOrder.front());
+		insertionOrder.pop_front();
+	}
+}
+
+void PlanResultCache::clear() {
+	scores.clear();
+	insertionOrder.clear();
+}
+
+} /* namespace evolutionary_inspection_plan_evaluation */
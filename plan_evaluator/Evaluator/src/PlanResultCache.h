@@ -0,0 +1,78 @@
+/*
+ * PlanResultCache.h
+ *
+ * A cache of the scores of entire plans. The optimizer often re-evaluates plans it has seen before (clones, and
+ * crossover recreating earlier plans), and for those we can skip decoding, energy estimation and coverage completely.
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef PLANRESULTCACHE_H_
+#define PLANRESULTCACHE_H_
+
+#include <deque>
+#include <stddef.h>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "../../Utility_Functions/src/HelperMethods.h"
+
+namespace evolutionary_inspection_plan_evaluation {
+
+/**
+ * The canonical form of a plan: For each plan point, the box ID it visits and the sensor angle offset, rounded the same
+ * way PlanInterpreterBoxOrder interprets them. Plans with the same canonical form are evaluated identically.
+ */
+typedef std::vector<std::pair<size_t, float> > CanonicalPlan;
+
+/**
+ * Bounded cache of plan scores, indexed by canonical plan. When full, the oldest entries are forgotten first.
+ */
+class PlanResultCache {
+
+private:
+	///The key also says whether the energy limit was disabled, since that changes the scores of long plans.
+	typedef std::pair<bool, CanonicalPlan> Key;
+
+	std::unordered_map<Key, std::vector<double> > scores;
+	std::deque<Key> insertionOrder;		///<The keys of all cached plans, oldest first.
+	size_t capacity;					///<The max number of cached plans.
+
+public:
+
+	/**
+	 * @param capacity The max number of plans to store. A capacity of 0 disables the cache.
+	 */
+	explicit PlanResultCache(size_t capacity);
+
+	/**
+	 * Builds the canonical form of a plan.
+	 * @param plan The plan exactly as it is evaluated, with its loop-around point appended (see
+	 * PlanCoverageEstimator::prepareForEvaluation). Only the key is canonical: Plans differing in how their genes
+	 * are encoded, but not in the boxes and angles they are interpreted as, share an entry.
+	 */
+	static CanonicalPlan canonicalForm(const std::vector<std::vector<double> >& plan);
+
+	/**
+	 * Looks up the scores of a plan.
+	 * @param[out] planScores Set to the cached scores if found.
+	 * @return true if the plan was found.
+	 */
+	bool find(const CanonicalPlan& plan, bool disableEnergyLimit, std::vector<double>& planScores) const;
+
+	/**
+	 * Stores the scores of a plan, forgetting the oldest plan if the cache is full.
+	 */
+	void insert(const CanonicalPlan& plan, bool disableEnergyLimit, const std::vector<double>& planScores);
+
+	void clear();
+
+	size_t size() const {
+		return scores.size();
+	}
+};
+
+} /* namespace evolutionary_inspection_plan_evaluation */
+
+#endif /* PLANRESULTCACHE_H_ */
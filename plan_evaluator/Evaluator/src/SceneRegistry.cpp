@@ -0,0 +1,74 @@
+/*
+ * SceneRegistry.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include "SceneRegistry.h"
+
+#include <boost/filesystem.hpp>
+#include <iostream>
+
+#include "BoxCollisionMatrix.h"
+#include "../../Utility_Functions/src/SceneKeeper.h"
+#include "../../Utility_Functions/src/VisibilityMesh.h"
+
+using namespace utility_functions;
+
+namespace evolutionary_inspection_plan_evaluation {
+
+SceneData::~SceneData() {
+	//Keeping the edges checked during this run for the next.
+	if (boxGrid.collisionMatrix && !boxGrid.collisionMatrix->saveIfChanged()) {
+		std::cerr << "Warning: Could not store the collisions between boxes." << std::endl;
+	}
+}
+
+SceneRegistry& SceneRegistry::instance() {
+	static SceneRegistry registry;
+	return registry;
+}
+
+std::shared_ptr<SceneData> SceneRegistry::acquire(const std::string& sceneFileName) {
+	//Files we cannot resolve are left for SceneKeeper to complain about.
+	boost::system::error_code error;
+	std::string key = boost::filesystem::canonical(sceneFileName, error).string();
+	std::time_t lastWriteTime = 0;
+	if (error) {
+		key = sceneFileName;
+	} else {
+		lastWriteTime = boost::filesystem::last_write_time(key, error);
+	}
+
+	//Loading happens while holding the lock, so two estimators of the same scene made at once do not both load it.
+	std::lock_guard<std::mutex> lock(mutex);
+	std::map<std::string, Entry>::iterator entry = entries.find(key);
+	if (entry != entries.end() && entry->second.lastWriteTime == lastWriteTime) {
+		std::shared_ptr<SceneData> data = entry->second.data.lock();
+		if (data) {
+			std::cout << "Reusing the already loaded scene " << key << std::endl;
+			return data;
+		}
+	}
+
+	std::cout << "Loading scene" << std::endl;
+	std::shared_ptr<SceneData> data = std::make_shared<SceneData>();
+	data->sceneKeeper.reset(new SceneKeeper(sceneFileName));
+	data->sceneKeeper->countTriangles();
+	data->coloredScene = data->sceneKeeper->colorEachTriangleDifferently();
+
+	//Forgetting scenes no one uses any more, so the map does not grow with every scene we have seen.
+	for (entry = entries.begin(); entry != entries.end();) {
+		if (entry->second.data.expired()) {
+			entries.erase(entry++);
+		} else {
+			entry++;
+		}
+	}
+	Entry& newEntry = entries[key];
+	newEntry.data = data;
+	newEntry.lastWriteTime = lastWriteTime;
+	return data;
+}
+
+} /* namespace evolutionary_inspection_plan_evaluation */
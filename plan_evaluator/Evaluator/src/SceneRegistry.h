@@ -0,0 +1,90 @@
+/*
+ * SceneRegistry.h
+ *
+ * Lets all PlanCoverageEstimators of the same scene file in a process share the preprocessing of that scene, so
+ * only the first of them pays for loading it.
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef SCENEREGISTRY_H_
+#define SCENEREGISTRY_H_
+
+#include <ctime>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <osg/Geode>
+#include <osg/ref_ptr>
+#include <string>
+
+#include "PlanInterpreterBoxOrder.h"
+
+namespace utility_functions{
+	class SceneKeeper;
+	class VisibilityMesh;
+}
+
+namespace evolutionary_inspection_plan_evaluation {
+
+/**
+ * Everything about a scene that does not depend on how we evaluate plans in it. Estimators differing only in
+ * postProcessing, startLocation or planLoopsAround all use the same SceneData.
+ * Apart from the box grid and the visibility meshes, which are made by the first estimator needing them, nothing here
+ * changes after loading.
+ */
+struct SceneData {
+	std::unique_ptr<utility_functions::SceneKeeper> sceneKeeper;	///<The loaded scene, with its triangles counted.
+	osg::ref_ptr<osg::Geode> coloredScene;			///<The scene with each triangle colored differently.
+
+	///A simplified scene estimators may render outside post-processing.
+	struct VisibilityMeshData {
+		std::unique_ptr<utility_functions::VisibilityMesh> mesh;
+		osg::ref_ptr<osg::Geode> scene;				///<mesh with each face colored differently.
+	};
+	std::mutex visibilityMeshMutex;					///<Held while reading or making visibilityMeshes.
+	///The simplified scenes, by the number of faces they were made for. Each made by the first estimator needing it.
+	std::map<size_t, VisibilityMeshData> visibilityMeshes;
+
+	std::mutex boxGridMutex;						///<Held while reading or filling in boxGrid.
+	BoxGrid boxGrid;								///<Empty until the first interpreter of the scene has made it.
+
+	~SceneData();
+};
+
+/**
+ * Keeps track of the loaded scenes in this process. The registry only holds weak references, so a scene is unloaded
+ * as soon as the last estimator using it is deleted.
+ */
+class SceneRegistry {
+
+private:
+	struct Entry {
+		std::weak_ptr<SceneData> data;
+		std::time_t lastWriteTime;					///<When the scene file had last been written to, as we loaded it.
+	};
+
+	std::mutex mutex;
+	std::map<std::string, Entry> entries;			///<Indexed by the canonical path of the scene file.
+
+	SceneRegistry() {}
+
+	SceneRegistry(const SceneRegistry&) = delete;
+	SceneRegistry& operator=(const SceneRegistry&) = delete;
+
+public:
+
+	///The registry of this process.
+	static SceneRegistry& instance();
+
+	/**
+	 * Returns the preprocessed scene in the given file, loading it if no one uses it yet. A file that has been written to
+	 * since it was loaded is loaded anew, though estimators already using the old version keep it.
+	 * @param sceneFileName The path of the 3D-model file. Different paths to the same file give the same scene.
+	 */
+	std::shared_ptr<SceneData> acquire(const std::string& sceneFileName);
+};
+
+} /* namespace evolutionary_inspection_plan_evaluation */
+
+#endif /* SCENEREGISTRY_H_ */
@@ -0,0 +1,124 @@
+/*
+ * evaluationServiceRunner.cpp
+ *
+ * Starts an EvaluationService, so optimizer processes on this host can share one warm evaluator. Usage:
+ *   evaluationService <socket path> <scene file> [--sensor a,b,...] [--start x,y,z] [--loops-around] [--threads n]
+ *                     [--shared-edge-cache name capacity] [--visibility-mesh fraction]
+ * The sensor parameters default to those in Constants.h. Clients connect through EvaluationInterface.generateEvaluator,
+ * giving the same socket path, and have to use the same scene and settings. Stop the service with Ctrl-C or SIGTERM.
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+
+#include "EvaluationService.h"
+#include "PlanCoverageEstimator.h"
+#include "../../Utility_Functions/src/HelperMethods.h"
+#include "../../Utility_Functions/src/Constants.h"
+
+using namespace evolutionary_inspection_plan_evaluation;
+using namespace utility_functions;
+
+namespace {
+	EvaluationService* runningService = nullptr;
+
+	void stopService(int) {
+		if (runningService) {
+			runningService->stop();
+		}
+	}
+
+	std::vector<double> parseDoubles(const std::string& commaSeparated) {
+		std::vector<std::string> parts = splitString(commaSeparated, ',');
+		std::vector<double> values;
+		for (size_t i = 0; i < parts.size(); i++) {
+			values.push_back(std::stod(parts[i]));
+		}
+		return values;
+	}
+
+	void printUsage(const char* programName) {
+		std::cerr << "Usage: " << programName << " <socket path> <scene file> [--sensor a,b,...] [--start x,y,z] [--loops-around]"
+				<< " [--threads n] [--shared-edge-cache name capacity] [--visibility-mesh fraction]" << std::endl;
+	}
+}
+
+int main(int argc, char **argv)
+{
+	if (argc < 3) {
+		printUsage(argv[0]);
+		return 1;
+	}
+	std::string socketPath = argv[1];
+	std::string sceneFile = argv[2];
+
+	double camSpecs[] = {DEFAULT_SAMPLING_INTERVAL_CAM, FOV_HORIZONTAL, FOV_VERTICAL, DEFAULT_CAM_HEIGHT, CAMERA_NEAR_PLANE_DIST, CAMERA_FAR_PLANE_DIST, FORWARD_CAMERA_ACTIVE, DOWNWARD_CAMERA_ACTIVE};
+	std::vector<double> sensorSpecs(camSpecs, camSpecs + sizeof(camSpecs) / sizeof(double));
+	std::vector<double> startLocation;
+	bool planLoopsAround = false;
+	int numThreads = 0;
+	std::string sharedEdgeCacheName;
+	int sharedEdgeCacheCapacity = 0;
+	double visibilityMeshFaceFraction = 1.0;
+
+	try {
+		for (int i = 3; i < argc; i++) {
+			std::string option = argv[i];
+			bool hasValue = i + 1 < argc;
+			if (option == "--sensor" && hasValue) {
+				sensorSpecs = parseDoubles(argv[++i]);
+			} else if (option == "--start" && hasValue) {
+				startLocation = parseDoubles(argv[++i]);
+			} else if (option == "--loops-around") {
+				planLoopsAround = true;
+			} else if (option == "--threads" && hasValue) {
+				numThreads = std::stoi(argv[++i]);
+			} else if (option == "--shared-edge-cache" && i + 2 < argc) {
+				sharedEdgeCacheName = argv[++i];
+				sharedEdgeCacheCapacity = std::stoi(argv[++i]);
+			} else if (option == "--visibility-mesh" && hasValue) {
+				visibilityMeshFaceFraction = std::stod(argv[++i]);
+			} else {
+				printUsage(argv[0]);
+				return 1;
+			}
+		}
+	} catch (const std::logic_error& e) { //Thrown by stod and stoi on malformed numbers.
+		std::cerr << "Could not parse the arguments: " << e.what() << std::endl;
+		return 1;
+	}
+
+	const std::vector<double>* startLocationPointer = startLocation.empty() ? nullptr : &startLocation;
+	std::cout << "Loading " << sceneFile << std::endl;
+	PlanCoverageEstimator estimator(sceneFile, sensorSpecs, false, startLocationPointer, planLoopsAround, true, visibilityMeshFaceFraction);
+	if (!sharedEdgeCacheName.empty()) {
+		estimator.attachSharedEdgeCache(sharedEdgeCacheName, sharedEdgeCacheCapacity);
+	}
+	estimator.setNumThreads(numThreads);
+
+	EvaluationService service(estimator, sceneFile, sensorSpecs, startLocationPointer, planLoopsAround, visibilityMeshFaceFraction);
+	runningService = &service;
+	std::signal(SIGINT, stopService);
+	std::signal(SIGTERM, stopService);
+	int exitCode = 0;
+	try {
+		service.run(socketPath);
+	} catch (const std::runtime_error& e) {
+		std::cerr << e.what() << std::endl;
+		exitCode = 1;
+	}
+	runningService = nullptr;
+	if (!sharedEdgeCacheName.empty()) {
+		//Leaving no segment behind in /dev/shm. Other processes still attached keep their mapping.
+		PlanCoverageEstimator::removeSharedEdgeCache(sharedEdgeCacheName);
+	}
+	if (exitCode != 0) {
+		return exitCode;
+	}
+	std::cout << "Evaluation service stopped." << std::endl;
+	return 0;
+}
@@ -0,0 +1,134 @@
+/*
+ * intersectionBenchmarkRunner.cpp
+ *
+ * Compares the ways we can check plan edges for collisions. Usage:
+ *   intersectionBenchmark [--edges n] <scene file>...
+ * For instance with the bundled meshes: intersectionBenchmark 3d_models/luis1.obj 3d_models/simple_shapes/sphere.obj
+ * For each scene, the same random edges are checked with a new PolytopeIntersector per edge (the old way), with the
+ * reused any-hit intersector, and with a CollisionEngine. Prints the time per edge for each, and whether they agreed.
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include <chrono>
+#include <iostream>
+#include <osg/ComputeBoundsVisitor>
+#include <osgDB/ReadFile>
+#include <osgDB/Registry>
+#include <osgUtil/IntersectionVisitor>
+#include <osgUtil/PolytopeIntersector>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../../Utility_Functions/src/AnyHitPolytopeIntersector.h"
+#include "../../Utility_Functions/src/CollisionEngine.h"
+#include "../../Utility_Functions/src/OsgHelpers.h"
+#include "../../Utility_Functions/src/Constants.h"
+
+using namespace utility_functions;
+
+namespace {
+	void printUsage(const char* programName) {
+		std::cerr << "Usage: " << programName << " [--edges n] <scene file>..." << std::endl;
+	}
+
+	double now() {
+		return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	///The old check: A new intersector and visitor for each edge, collecting every intersection.
+	bool checkWithNewIntersector(const osg::Polytope& polytope, osg::Node& scene) {
+		osg::ref_ptr<osgUtil::PolytopeIntersector> polytopeIntersector = new osgUtil::PolytopeIntersector(polytope);
+		osgUtil::IntersectionVisitor intersectVisitor(polytopeIntersector.get());
+		scene.accept(intersectVisitor);
+		return polytopeIntersector->containsIntersections();
+	}
+
+	///Random edges of plan-like lengths, starting around the scene like candidate waypoints do. Made from a fixed seed.
+	std::vector<std::pair<osg::Vec3d, osg::Vec3d> > makeEdges(osg::Node& scene, int numEdges) {
+		osg::ComputeBoundsVisitor boundsVisitor;
+		scene.accept(boundsVisitor);
+		osg::BoundingBox bounds = boundsVisitor.getBoundingBox();
+		std::mt19937 generator(1);
+		std::uniform_real_distribution<double> unit(0, 1);
+		std::uniform_real_distribution<double> lengths(1, 15);
+		std::normal_distribution<double> direction(0, 1);
+		std::vector<std::pair<osg::Vec3d, osg::Vec3d> > edges;
+		for (int e = 0; e < numEdges; e++) {
+			osg::Vec3d start;
+			for (int axis = 0; axis < 3; axis++) {
+				start[axis] = bounds._min[axis] - BOX_PADDING + unit(generator) * (bounds._max[axis] - bounds._min[axis] + 2 * BOX_PADDING);
+			}
+			osg::Vec3d offset(direction(generator), direction(generator), direction(generator));
+			offset.normalize();
+			edges.push_back(std::make_pair(start, start + offset * lengths(generator)));
+		}
+		return edges;
+	}
+}
+
+int main(int argc, char **argv)
+{
+	int numEdges = 2000;
+	std::vector<std::string> sceneFiles;
+	for (int i = 1; i < argc; i++) {
+		std::string argument = argv[i];
+		if (argument == "--edges" && i + 1 < argc) {
+			numEdges = std::stoi(argv[++i]);
+		} else {
+			sceneFiles.push_back(argument);
+		}
+	}
+	if (sceneFiles.empty() || numEdges < 1) {
+		printUsage(argv[0]);
+		return 1;
+	}
+
+	//Built the same way as SceneKeeper::LoadScene builds them.
+	osgDB::Registry::instance()->setBuildKdTreesHint(osgDB::ReaderWriter::Options::BUILD_KDTREES);
+	for (std::vector<std::string>::const_iterator sceneFile = sceneFiles.begin(); sceneFile != sceneFiles.end(); sceneFile++) {
+		osg::ref_ptr<osg::Node> scene = osgDB::readNodeFile(*sceneFile);
+		if (!scene) {
+			std::cerr << "Could not load " << *sceneFile << std::endl;
+			return 1;
+		}
+		prepareSceneForConcurrentIntersections(*scene);
+		std::vector<std::pair<osg::Vec3d, osg::Vec3d> > edges = makeEdges(*scene, numEdges);
+		std::vector<osg::Polytope> polytopes;
+		for (size_t e = 0; e < edges.size(); e++) {
+			polytopes.push_back(generatePolytopeFromPlanEdge(edges[e].first, edges[e].second, nullptr));
+		}
+		osg::ref_ptr<CollisionEngine> collisionEngine = new CollisionEngine(*scene);
+
+		std::vector<bool> newIntersectorHits, anyHitHits, engineHits;
+		double start = now();
+		for (size_t e = 0; e < edges.size(); e++) {
+			newIntersectorHits.push_back(checkWithNewIntersector(polytopes[e], *scene));
+		}
+		double newIntersectorSeconds = now() - start;
+		start = now();
+		for (size_t e = 0; e < edges.size(); e++) {
+			anyHitHits.push_back(checkPolytopeForIntersections(polytopes[e], *scene));
+		}
+		double anyHitSeconds = now() - start;
+		start = now();
+		for (size_t e = 0; e < edges.size(); e++) {
+			engineHits.push_back(collisionEngine->edgeComesTooClose(edges[e].first, edges[e].second, EDGE_SAFETY_BUFFER));
+		}
+		double engineSeconds = now() - start;
+
+		size_t numHits = 0;
+		for (size_t e = 0; e < edges.size(); e++) {
+			numHits += newIntersectorHits[e];
+		}
+		std::cout << *sceneFile << ": " << collisionEngine->getTriangleCount() << " triangles, " << numHits << " of " << edges.size()
+				<< " edges collide" << std::endl;
+		std::cout << "  new intersector per edge: " << 1e6 * newIntersectorSeconds / edges.size() << " us/edge" << std::endl;
+		std::cout << "  reused any-hit intersector: " << 1e6 * anyHitSeconds / edges.size() << " us/edge, "
+				<< (anyHitHits == newIntersectorHits ? "same answers" : "DIFFERENT answers") << std::endl;
+		std::cout << "  collision engine: " << 1e6 * engineSeconds / edges.size() << " us/edge, "
+				<< (engineHits == newIntersectorHits ? "same answers" : "DIFFERENT answers") << std::endl;
+	}
+	return 0;
+}
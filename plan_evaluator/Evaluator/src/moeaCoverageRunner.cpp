@@ -87,7 +87,7 @@ int main(int argc, char **argv)
     std::cout << "Making estimator" << std::endl;
 
     std::cout << "Argument given: " << argv[1] << std::endl;
-    PlanCoverageEstimator estimator = PlanCoverageEstimator(argv[1], cameraSpecs, false, nullptr, false, true);
+    PlanCoverageEstimator estimator(argv[1], cameraSpecs, false, nullptr, false, true);
     //std::cout << "First plan: " << std::endl;
 
 
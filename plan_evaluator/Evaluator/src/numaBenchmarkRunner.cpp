@@ -0,0 +1,126 @@
+/*
+ * numaBenchmarkRunner.cpp
+ *
+ * Measures how the throughput of evaluatePlans scales with the number of NUMA nodes (sockets) it may use. Usage:
+ *   numaBenchmark <scene file> [--plans n] [--length n] [--generations n]
+ * For k = 1 up to the number of nodes, the process is restricted to the CPUs of the first k nodes, a fresh estimator is
+ * made, and the same random generations of plans are evaluated with memoization. Prints plans per second for each k,
+ * the speedup over one node, and whether the scores matched those found on one node.
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "PlanCoverageEstimator.h"
+#include "../../Utility_Functions/src/NumaTopology.h"
+#include "../../Utility_Functions/src/Constants.h"
+
+using namespace evolutionary_inspection_plan_evaluation;
+using namespace utility_functions;
+
+namespace {
+	void printUsage(const char* programName) {
+		std::cerr << "Usage: " << programName << " <scene file> [--plans n] [--length n] [--generations n]" << std::endl;
+	}
+
+	///Random plans of random boxes. Made from a fixed seed, so every run evaluates the same plans.
+	std::vector<std::vector<std::vector<std::vector<double> > > > makeGenerations(int numBoxes, int numGenerations, int numPlans,
+			int planLength) {
+		std::mt19937 generator(1);
+		std::uniform_int_distribution<int> boxes(0, numBoxes - 1);
+		std::uniform_int_distribution<int> lengths(1, planLength);
+		std::vector<std::vector<std::vector<std::vector<double> > > > generations(numGenerations);
+		for (int g = 0; g < numGenerations; g++) {
+			for (int p = 0; p < numPlans; p++) {
+				std::vector<std::vector<double> > plan;
+				for (int length = lengths(generator); length > 0; length--) {
+					plan.push_back(std::vector<double>(1, boxes(generator)));
+				}
+				generations[g].push_back(plan);
+			}
+		}
+		return generations;
+	}
+}
+
+int main(int argc, char **argv)
+{
+	if (argc < 2) {
+		printUsage(argv[0]);
+		return 1;
+	}
+	std::string sceneFile = argv[1];
+	int numPlans = 200;
+	int planLength = 20;
+	int numGenerations = 5;
+	for (int i = 2; i < argc; i++) {
+		std::string option = argv[i];
+		if (i + 1 >= argc) {
+			printUsage(argv[0]);
+			return 1;
+		}
+		if (option == "--plans") {
+			numPlans = std::stoi(argv[++i]);
+		} else if (option == "--length") {
+			planLength = std::stoi(argv[++i]);
+		} else if (option == "--generations") {
+			numGenerations = std::stoi(argv[++i]);
+		} else {
+			printUsage(argv[0]);
+			return 1;
+		}
+	}
+	if (numPlans < 1 || planLength < 1 || numGenerations < 1) {
+		std::cerr << "The number of plans, their length and the number of generations must be positive." << std::endl;
+		return 1;
+	}
+
+	double camSpecs[] = {DEFAULT_SAMPLING_INTERVAL_CAM, FOV_HORIZONTAL, FOV_VERTICAL, DEFAULT_CAM_HEIGHT, CAMERA_NEAR_PLANE_DIST, CAMERA_FAR_PLANE_DIST, FORWARD_CAMERA_ACTIVE, DOWNWARD_CAMERA_ACTIVE};
+	std::vector<double> sensorSpecs(camSpecs, camSpecs + sizeof(camSpecs) / sizeof(double));
+
+	NumaTopology topology;
+	std::cout << "Found " << topology.numNodes() << " NUMA node(s) with " << topology.numCpus() << " CPUs." << std::endl;
+
+	double singleNodeRate = 0;
+	std::vector<std::vector<std::vector<double> > > singleNodeScores;
+	for (size_t numNodes = 1; numNodes <= topology.numNodes(); numNodes++) {
+		//The estimator (and the workers it starts) only sees the CPUs we leave this thread.
+		std::vector<int> cpus;
+		for (size_t node = 0; node < numNodes; node++) {
+			cpus.insert(cpus.end(), topology.getCpus(node).begin(), topology.getCpus(node).end());
+		}
+		if (!NumaTopology::pinCurrentThread(cpus)) {
+			std::cerr << "Could not restrict the benchmark to " << numNodes << " node(s)." << std::endl;
+			return 1;
+		}
+
+		PlanCoverageEstimator estimator(sceneFile, sensorSpecs);
+		std::vector<std::vector<std::vector<std::vector<double> > > > generations =
+				makeGenerations(estimator.getNumberOfBoxes(), numGenerations, numPlans, planLength);
+		std::vector<std::vector<std::vector<double> > > scores;
+		double start = std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+		for (int g = 0; g < numGenerations; g++) {
+			std::vector<std::vector<double> > generationScores = estimator.evaluatePlans(generations[g], true);
+			estimator.updateMemoisedEdges(generations[g]);
+			scores.push_back(generationScores);
+		}
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count() - start;
+		double rate = numGenerations * numPlans / seconds;
+
+		std::cout << numNodes << " node(s), " << cpus.size() << " CPUs: " << rate << " plans/s";
+		if (numNodes == 1) {
+			singleNodeRate = rate;
+			singleNodeScores = scores;
+		} else {
+			std::cout << ", speedup " << rate / singleNodeRate << ", scores "
+					<< (scores == singleNodeScores ? "identical to" : "DIFFERENT from") << " one node";
+		}
+		std::cout << std::endl;
+	}
+	return 0;
+}
@@ -0,0 +1,155 @@
+/*
+ * precisionCheckRunner.cpp
+ *
+ * Checks that storing the geometry in single precision (see GeometryPrecision.h) does not change the scores of plans.
+ * Run it with a default build to write the reference scores, and with a build configured with -DFLOAT_GEOMETRY=ON to
+ * compare against them:
+ *   precisionCheck --write reference.txt [--plans n] [--length n] <scene file>...
+ *   precisionCheck --compare reference.txt [--plans n] [--length n] [--tolerance t] <scene file>...
+ * For instance with the bundled meshes: precisionCheck --write reference.txt 3d_models/luis1.obj 3d_models/mockup_only.stl
+ * The same random plans are evaluated in each scene. When comparing, prints the largest deviation in coverage and the
+ * largest relative deviation in energy for each scene, and fails if any is above the tolerance.
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "PlanCoverageEstimator.h"
+#include "../../Utility_Functions/src/GeometryPrecision.h"
+#include "../../Utility_Functions/src/Constants.h"
+
+using namespace evolutionary_inspection_plan_evaluation;
+using namespace utility_functions;
+
+namespace {
+	void printUsage(const char* programName) {
+		std::cerr << "Usage: " << programName << " (--write | --compare) <reference file> [--plans n] [--length n] [--tolerance t]"
+				<< " <scene file>..." << std::endl;
+	}
+
+	///Random plans of random boxes. Made from a fixed seed, so every build evaluates the same plans.
+	std::vector<std::vector<std::vector<double> > > makePlans(int numBoxes, int numPlans, int planLength) {
+		std::mt19937 generator(1);
+		std::uniform_int_distribution<int> boxes(0, numBoxes - 1);
+		std::uniform_int_distribution<int> lengths(1, planLength);
+		std::vector<std::vector<std::vector<double> > > plans;
+		for (int p = 0; p < numPlans; p++) {
+			std::vector<std::vector<double> > plan;
+			for (int length = lengths(generator); length > 0; length--) {
+				plan.push_back(std::vector<double>(1, boxes(generator)));
+			}
+			plans.push_back(plan);
+		}
+		return plans;
+	}
+}
+
+int main(int argc, char **argv)
+{
+	if (argc < 3 || (std::string(argv[1]) != "--write" && std::string(argv[1]) != "--compare")) {
+		printUsage(argv[0]);
+		return 1;
+	}
+	bool writing = std::string(argv[1]) == "--write";
+	std::string referenceFile = argv[2];
+	int numPlans = 100;
+	int planLength = 20;
+	double tolerance = 1e-6;
+	std::vector<std::string> sceneFiles;
+	for (int i = 3; i < argc; i++) {
+		std::string argument = argv[i];
+		if ((argument == "--plans" || argument == "--length" || argument == "--tolerance") && i + 1 >= argc) {
+			printUsage(argv[0]);
+			return 1;
+		}
+		if (argument == "--plans") {
+			numPlans = std::stoi(argv[++i]);
+		} else if (argument == "--length") {
+			planLength = std::stoi(argv[++i]);
+		} else if (argument == "--tolerance") {
+			tolerance = std::stod(argv[++i]);
+		} else {
+			sceneFiles.push_back(argument);
+		}
+	}
+	if (sceneFiles.empty() || numPlans < 1 || planLength < 1) {
+		printUsage(argv[0]);
+		return 1;
+	}
+	std::cout << "Geometry is stored in " << (sizeof(GeometryReal) == sizeof(float) ? "single" : "double") << " precision." << std::endl;
+
+	//The reference holds one line per plan: The scene, the plan's index, its coverage and its energy.
+	std::map<std::pair<std::string, int>, std::pair<double, double> > referenceScores;
+	std::ofstream out;
+	if (writing) {
+		out.open(referenceFile.c_str());
+		out.precision(17);
+	} else {
+		std::ifstream in(referenceFile.c_str());
+		std::string scene;
+		int plan;
+		double coverage, energy;
+		while (in >> scene >> plan >> coverage >> energy) {
+			referenceScores[std::make_pair(scene, plan)] = std::make_pair(coverage, energy);
+		}
+		if (referenceScores.empty()) {
+			std::cerr << "Could not read any scores from " << referenceFile << std::endl;
+			return 1;
+		}
+	}
+
+	double camSpecs[] = {DEFAULT_SAMPLING_INTERVAL_CAM, FOV_HORIZONTAL, FOV_VERTICAL, DEFAULT_CAM_HEIGHT, CAMERA_NEAR_PLANE_DIST, CAMERA_FAR_PLANE_DIST, FORWARD_CAMERA_ACTIVE, DOWNWARD_CAMERA_ACTIVE};
+	std::vector<double> sensorSpecs(camSpecs, camSpecs + sizeof(camSpecs) / sizeof(double));
+
+	bool withinTolerance = true;
+	for (std::vector<std::string>::const_iterator sceneFile = sceneFiles.begin(); sceneFile != sceneFiles.end(); sceneFile++) {
+		PlanCoverageEstimator estimator(*sceneFile, sensorSpecs);
+		std::vector<std::vector<std::vector<double> > > plans = makePlans(estimator.getNumberOfBoxes(), numPlans, planLength);
+		std::vector<std::vector<double> > scores = estimator.evaluatePlans(plans, false);
+
+		if (writing) {
+			for (size_t p = 0; p < scores.size(); p++) {
+				out << *sceneFile << " " << p << " " << scores[p][0] << " " << scores[p][1] << std::endl;
+			}
+			std::cout << *sceneFile << ": wrote the scores of " << scores.size() << " plans" << std::endl;
+			continue;
+		}
+
+		double maxCoverageDeviation = 0;
+		double maxEnergyDeviation = 0;
+		size_t numMissing = 0;
+		for (size_t p = 0; p < scores.size(); p++) {
+			std::map<std::pair<std::string, int>, std::pair<double, double> >::const_iterator reference =
+					referenceScores.find(std::make_pair(*sceneFile, (int) p));
+			if (reference == referenceScores.end()) {
+				numMissing++;
+				continue;
+			}
+			maxCoverageDeviation = std::max(maxCoverageDeviation, std::abs(scores[p][0] - reference->second.first));
+			double energyScale = std::max(std::abs(reference->second.second), 1.0);
+			maxEnergyDeviation = std::max(maxEnergyDeviation, std::abs(scores[p][1] - reference->second.second) / energyScale);
+		}
+		bool sceneOk = numMissing == 0 && maxCoverageDeviation <= tolerance && maxEnergyDeviation <= tolerance;
+		withinTolerance = withinTolerance && sceneOk;
+		std::cout << *sceneFile << ": largest coverage deviation " << maxCoverageDeviation << ", largest relative energy deviation "
+				<< maxEnergyDeviation;
+		if (numMissing > 0) {
+			std::cout << ", " << numMissing << " plans missing from the reference";
+		}
+		std::cout << (sceneOk ? "" : " - ABOVE TOLERANCE") << std::endl;
+	}
+	if (writing && !out.flush()) {
+		std::cerr << "Could not write " << referenceFile << std::endl;
+		return 1;
+	}
+	return withinTolerance ? 0 : 1;
+}
@@ -0,0 +1,76 @@
+/*
+ * AlignedAllocator.h
+ *
+ * An allocator for standard containers that places their elements at a given alignment, so arrays scanned in tight
+ * loops start on a cache line (and on a boundary vector instructions can load from).
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef ALIGNEDALLOCATOR_H_
+#define ALIGNEDALLOCATOR_H_
+
+#include <cstdlib>
+#include <new>
+#include <stddef.h>
+#include <vector>
+
+namespace utility_functions {
+
+///The alignment of AlignedVector: One cache line on the machines we run on.
+const size_t CACHE_LINE_SIZE = 64;
+
+template<typename T, size_t Alignment = CACHE_LINE_SIZE>
+class AlignedAllocator {
+public:
+	typedef T value_type;
+	typedef T* pointer;
+	typedef const T* const_pointer;
+	typedef T& reference;
+	typedef const T& const_reference;
+	typedef size_t size_type;
+	typedef ptrdiff_t difference_type;
+
+	template<typename U>
+	struct rebind {
+		typedef AlignedAllocator<U, Alignment> other;
+	};
+
+	AlignedAllocator() {}
+
+	template<typename U>
+	AlignedAllocator(const AlignedAllocator<U, Alignment>&) {}
+
+	T* allocate(size_t n) {
+		if (n == 0) {
+			return nullptr;
+		}
+		void* memory = nullptr;
+		if (n > size_t(-1) / sizeof(T) || posix_memalign(&memory, Alignment, n * sizeof(T)) != 0) {
+			throw std::bad_alloc();
+		}
+		return static_cast<T*>(memory);
+	}
+
+	void deallocate(T* p, size_t) {
+		free(p);
+	}
+
+	template<typename U>
+	bool operator==(const AlignedAllocator<U, Alignment>&) const {
+		return true;
+	}
+
+	template<typename U>
+	bool operator!=(const AlignedAllocator<U, Alignment>&) const {
+		return false;
+	}
+};
+
+///A vector whose elements start on a cache line.
+template<typename T>
+using AlignedVector = std::vector<T, AlignedAllocator<T> >;
+
+} /* namespace utility_functions */
+
+#endif /* ALIGNEDALLOCATOR_H_ */
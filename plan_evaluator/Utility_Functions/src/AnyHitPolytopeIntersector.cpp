@@ -0,0 +1,42 @@
+/*
+ * AnyHitPolytopeIntersector.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include "AnyHitPolytopeIntersector.h"
+
+namespace utility_functions {
+
+AnyHitPolytopeIntersector::AnyHitPolytopeIntersector()
+:osgUtil::PolytopeIntersector(osg::Polytope()){
+	setIntersectionLimit(osgUtil::Intersector::LIMIT_ONE);
+}
+
+void AnyHitPolytopeIntersector::setPolytope(const osg::Polytope& polytope) {
+	//The same as the constructor of PolytopeIntersector does with its polytope.
+	_polytope = polytope;
+	if (!_polytope.getPlaneList().empty()) {
+		_referencePlane = _polytope.getPlaneList().back();
+	}
+}
+
+PolytopeHitTester::PolytopeHitTester()
+:intersector(new AnyHitPolytopeIntersector()),
+ visitor(intersector.get()){
+	visitor.setUseKdTreeWhenAvailable(true);
+}
+
+bool PolytopeHitTester::intersects(const osg::Polytope& polytope, osg::Node& scene) {
+	intersector->setPolytope(polytope);
+	visitor.reset(); //Clears the intersections found by the last test, and any state left from an interrupted traversal.
+	scene.accept(visitor);
+	return intersector->containsIntersections();
+}
+
+PolytopeHitTester& PolytopeHitTester::forCurrentThread() {
+	static thread_local PolytopeHitTester tester;
+	return tester;
+}
+
+} /* namespace utility_functions */
@@ -0,0 +1,59 @@
+/*
+ * AnyHitPolytopeIntersector.h
+ *
+ * Yes/no intersection tests of polytopes against a scene graph, which stop at the first hit and reuse their intersector
+ * and visitor from call to call.
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef ANYHITPOLYTOPEINTERSECTOR_H_
+#define ANYHITPOLYTOPEINTERSECTOR_H_
+
+#include <osg/Node>
+#include <osg/Polytope>
+#include <osg/ref_ptr>
+#include <osgUtil/IntersectionVisitor>
+#include <osgUtil/PolytopeIntersector>
+
+namespace utility_functions {
+
+/**
+ * A polytope intersector that only finds out whether there is an intersection. Its limit is set to LIMIT_ONE, so the
+ * traversal skips the rest of the scene once something is found, and its polytope can be replaced between traversals.
+ */
+class AnyHitPolytopeIntersector : public osgUtil::PolytopeIntersector {
+public:
+	AnyHitPolytopeIntersector();
+
+	///Replaces the polytope tested. Call reset (or IntersectionVisitor::reset) before the next traversal.
+	void setPolytope(const osg::Polytope& polytope);
+};
+
+/**
+ * Tests polytopes against scenes with one AnyHitPolytopeIntersector and one visitor, instead of allocating them for each
+ * test. The visitor uses the scene's KD-trees (see SceneKeeper::LoadScene) where the installed OSG's polytope
+ * intersector supports them (OSG 3.6 and later). A tester must only be used by one thread at a time. Use
+ * forCurrentThread to get the calling thread's own.
+ */
+class PolytopeHitTester {
+private:
+	osg::ref_ptr<AnyHitPolytopeIntersector> intersector;
+	osgUtil::IntersectionVisitor visitor;
+
+public:
+	PolytopeHitTester();
+
+	PolytopeHitTester(const PolytopeHitTester&) = delete;
+	PolytopeHitTester& operator=(const PolytopeHitTester&) = delete;
+
+	///@return true if any part of the scene is inside the polytope.
+	bool intersects(const osg::Polytope& polytope, osg::Node& scene);
+
+	///@return A tester belonging to the calling thread, made on its first call.
+	static PolytopeHitTester& forCurrentThread();
+};
+
+} /* namespace utility_functions */
+
+#endif /* ANYHITPOLYTOPEINTERSECTOR_H_ */
@@ -8,11 +8,13 @@
 #include "CameraEstimator.h"
 
 #include <boost/filesystem.hpp>
+#include <chrono>
 #include <osg/Geode>
 #include <osg/Geometry>
 #include <osg/LightModel>
 #include <osg/Texture2D>
 #include <osgDB/WriteFile>
+#include <stdexcept>
 
 #include "Constants.h"
 #include "HelperMethods.h"
@@ -128,19 +130,28 @@ void CameraEstimator::getAllColorsInFrame(const osg::Image& image, boost::dynami
     //std::cout << "Time to read pixels: " << (std::clock() - start) / (double)(CLOCKS_PER_SEC / 1000) << " ms" << std::endl;
 }
 
+osg::ref_ptr<osg::Image> CameraEstimator::grabAndCountImage(const osg::ref_ptr<osg::Node> inspectionTarget) const{
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	osg::ref_ptr<osg::Image> osgImage = capture->grabImage(inspectionTarget);
+	renderStatistics.renderSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	renderStatistics.framesRendered++;
+	return osgImage;
+}
+
+void CameraEstimator::scanAndCountColorsInFrame(const osg::Image& image, boost::dynamic_bitset<>& observedColors) const{
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	getAllColorsInFrame(image, observedColors);
+	renderStatistics.pixelScanSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	renderStatistics.pixelsScanned += (unsigned long long) image.s() * image.t();
+}
+
 void CameraEstimator::GetColorsDuringTraversal(const osg::Vec3d& currentLocation, const osg::Vec3d& nextLocation,
 	const osg::Vec3d& robotHeading, const osg::ref_ptr<osg::Node> inspectionTarget, boost::dynamic_bitset<>& observedColors,
 											   double sampling_interval,
 											   osg::ref_ptr<osg::Group> drawCameraImageTo /*=nullptr*/)
 											    const{
 	osg::ref_ptr<osg::Vec3Array> samplingPositions = new osg::Vec3Array();
-	if(currentLocation==nextLocation){
-		//If we're only given a single waypoint, we just sample colors once, right at this waypoint.
-		samplingPositions->push_back(currentLocation);
-	}
-	else{
-		getSamplingPositions(currentLocation, nextLocation, *samplingPositions, sampling_interval);
-	}
+	getTraversalSamplingPositions(currentLocation, nextLocation, *samplingPositions, sampling_interval);
 	osg::ref_ptr<osg::Texture2D> tex; //Texture to draw the camera's image to, for testing/debugging.
 	if(drawCameraImageTo!=nullptr){
 		tex = new osg::Texture2D;
@@ -148,22 +159,11 @@ void CameraEstimator::GetColorsDuringTraversal(const osg::Vec3d& currentLocation
 	}
 	for(osg::Vec3Array::iterator it = samplingPositions->begin(); it<samplingPositions->end(); it++){
 		osg::Vec3 point = *it;
-		if(usingFrontCamera){
-			capture->setCameraPosition(point, point+robotHeading, UP_VECTOR);
-			osg::ref_ptr<osg::Image> osgImage = capture->grabImage(inspectionTarget);
-			getAllColorsInFrame(*osgImage, observedColors);
-			if(drawCameraImageTo!=nullptr){
-				tex->setTextureSize(osgImage->s(),osgImage->t());
-				tex->setInternalFormat(GL_RGB); //requests 8 bits per color component, which corresponds to 256 possible values each for R, G and B.
-				tex->setImage(0, osgImage);
-			}
-
-		}
-		if(usingBelowCamera){
-			//A camera looking down has lookAt straight down, and "up-vector" in front of the robot.
-			capture->setCameraPosition(point,point-UP_VECTOR, robotHeading);
-			osg::ref_ptr<osg::Image> osgImage = capture->grabImage(inspectionTarget);
-			getAllColorsInFrame(*osgImage, observedColors);
+		osg::ref_ptr<osg::Image> osgImage = observeFromPosition(point, robotHeading, inspectionTarget, observedColors);
+		if(drawCameraImageTo!=nullptr && osgImage!=nullptr){
+			tex->setTextureSize(osgImage->s(),osgImage->t());
+			tex->setInternalFormat(GL_RGB); //requests 8 bits per color component, which corresponds to 256 possible values each for R, G and B.
+			tex->setImage(0, osgImage);
 		}
 		//std::clock_t    start = std::clock();
 		//std::cout << "Time to render image: " << (std::clock() - start) / (double)(CLOCKS_PER_SEC / 1000) << " ms" << std::endl;
@@ -179,6 +179,52 @@ void CameraEstimator::GetColorsDuringTraversal(const osg::Vec3d& currentLocation
 
 
 
+void CameraEstimator::getTraversalSamplingPositions(const osg::Vec3d& currentLocation, const osg::Vec3d& nextLocation,
+		osg::Vec3Array& samplingPositions, double sampling_interval) const{
+	if(currentLocation==nextLocation){
+		//If we're only given a single waypoint, we just sample colors once, right at this waypoint.
+		samplingPositions.push_back(currentLocation);
+	}
+	else{
+		getSamplingPositions(currentLocation, nextLocation, samplingPositions, sampling_interval);
+	}
+}
+
+osg::ref_ptr<osg::Image> CameraEstimator::observeFromPosition(const osg::Vec3& point, const osg::Vec3d& robotHeading,
+		const osg::ref_ptr<osg::Node> inspectionTarget, boost::dynamic_bitset<>& observedColors) const{
+	osg::ref_ptr<osg::Image> frontImage;
+	if(usingFrontCamera){
+		capture->setCameraPosition(point, point+robotHeading, UP_VECTOR);
+		frontImage = grabAndCountImage(inspectionTarget);
+		scanAndCountColorsInFrame(*frontImage, observedColors);
+	}
+	if(usingBelowCamera){
+		//A camera looking down has lookAt straight down, and "up-vector" in front of the robot.
+		capture->setCameraPosition(point,point-UP_VECTOR, robotHeading);
+		osg::ref_ptr<osg::Image> osgImage = grabAndCountImage(inspectionTarget);
+		scanAndCountColorsInFrame(*osgImage, observedColors);
+	}
+	return frontImage;
+}
+
+osg::ref_ptr<osg::Vec3Array> CameraEstimator::getTraversalSamplingPositions(const osg::Vec3d& currentLocation,
+		const osg::Vec3d& nextLocation) const{
+	osg::ref_ptr<osg::Vec3Array> samplingPositions = new osg::Vec3Array();
+	getTraversalSamplingPositions(currentLocation, nextLocation, *samplingPositions, distanceBetweenCameraSnapshots);
+	return samplingPositions;
+}
+
+void CameraEstimator::GetColorsInSampleRange(const osg::Vec3Array& samplingPositions, const osg::Vec3d& robotHeading,
+		const osg::ref_ptr<osg::Node> inspectionTarget, boost::dynamic_bitset<>& observedColors,
+		size_t firstSample, size_t endSample) const{
+	if(firstSample > endSample || endSample > samplingPositions.size()){
+		throw std::out_of_range("ERROR! Asked to render sampling positions outside the edge.");
+	}
+	for(size_t sample = firstSample; sample < endSample; sample++){
+		observeFromPosition(samplingPositions[sample], robotHeading, inspectionTarget, observedColors);
+	}
+}
+
 void storeViewToFile(const osg::ref_ptr<osg::Node> scene, const osg::Matrixd& viewMatrix, std::string& fileName){
 
 	//Making sure all surfaces are lit from both sides, in case of wrongly flipped normals.
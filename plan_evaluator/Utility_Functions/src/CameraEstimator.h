@@ -35,6 +35,19 @@ namespace utility_functions {
  */
 void storeViewToFile(const osg::ref_ptr<osg::Node> scene, const osg::Matrixd& viewMatrix, std::string& fileName);
 
+/**
+ * Counts the rendering work done by a CameraEstimator, to let us see where evaluation time goes.
+ */
+struct RenderStatistics {
+	unsigned long framesRendered;		///<The number of camera images rendered.
+	unsigned long long pixelsScanned;	///<The number of pixels we have read colors from.
+	double renderSeconds;				///<Time spent rendering images.
+	double pixelScanSeconds;			///<Time spent reading colors from rendered images.
+
+	RenderStatistics()
+	:framesRendered(0), pixelsScanned(0), renderSeconds(0), pixelScanSeconds(0){}
+};
+
 class CameraEstimator {
 
 private:
@@ -55,6 +68,9 @@ private:
 	///An object we use to render and store images.
 	vizkit3d_normal_depth_map::ImageViewerCaptureTool* capture;
 
+	///The rendering work done since the last reset. Mutable, since counting does not change what the estimator computes.
+	mutable RenderStatistics renderStatistics;
+
 	/**
 	 * Calculates all the positions along the current edge where we should render images, for use in coverage estimates.
 	 * @param startLocation The start point of the edge
@@ -63,6 +79,17 @@ private:
 	 */
 	void getSamplingPositions(const osg::Vec3d& startLocation, const osg::Vec3d& endLocation, osg::Vec3Array& samplingPositions, double sampling_interval) const;// osg::ref_ptr<osg::Vec3Array> samplingPositions);
 
+	///As getSamplingPositions, but also handles traversals where we stay in place, which are sampled once.
+	void getTraversalSamplingPositions(const osg::Vec3d& currentLocation, const osg::Vec3d& nextLocation, osg::Vec3Array& samplingPositions,
+			double sampling_interval) const;
+
+	/**
+	 * Renders what each active camera sees from one sampling position, and records the observed colors.
+	 * @return The image from the front camera, or nullptr if that camera is not active.
+	 */
+	osg::ref_ptr<osg::Image> observeFromPosition(const osg::Vec3& point, const osg::Vec3d& robotHeading,
+			const osg::ref_ptr<osg::Node> inspectionTarget, boost::dynamic_bitset<>& observedColors) const;
+
 	/**
 	 * Finds and stores all unique colors present in a given image
 	 * @param image The input image
@@ -70,6 +97,12 @@ private:
 	 */
 	void getAllColorsInFrame(const osg::Image& image, boost::dynamic_bitset<>& ObservedColors) const;
 
+	///Renders an image with our capture tool, counting the frame and the time spent in renderStatistics.
+	osg::ref_ptr<osg::Image> grabAndCountImage(const osg::ref_ptr<osg::Node> inspectionTarget) const;
+
+	///Calls getAllColorsInFrame, counting the pixels and the time spent in renderStatistics.
+	void scanAndCountColorsInFrame(const osg::Image& image, boost::dynamic_bitset<>& observedColors) const;
+
 public:
 
 
@@ -125,6 +158,20 @@ public:
 	}
 
 
+	/**
+	 * @return The sampling positions GetColorsDuringTraversal renders from along the given edge, using the default sampling interval.
+	 */
+	osg::ref_ptr<osg::Vec3Array> getTraversalSamplingPositions(const osg::Vec3d& currentLocation, const osg::Vec3d& nextLocation) const;
+
+	/**
+	 * As GetColorsDuringTraversal, but only renders from samplingPositions firstSample up to (not including) endSample.
+	 * Lets long edges be split into pieces that are rendered separately, and later combined, without finding the
+	 * sampling positions of the edge again for each piece.
+	 * @param samplingPositions The sampling positions of the whole edge, from getTraversalSamplingPositions.
+	 */
+	void GetColorsInSampleRange(const osg::Vec3Array& samplingPositions, const osg::Vec3d& robotHeading,
+			const osg::ref_ptr<osg::Node> inspectionTarget, boost::dynamic_bitset<>& observedColors, size_t firstSample, size_t endSample) const;
+
 	void setDistanceBetweenCameraSnapshots(
 			double distanceBetweenCameraSnapshots) {
 		this->distanceBetweenCameraSnapshots = distanceBetweenCameraSnapshots;
@@ -133,6 +180,14 @@ public:
 	double getDistanceBetweenCameraSnapshots() const {
 		return distanceBetweenCameraSnapshots;
 	}
+
+	const RenderStatistics& getRenderStatistics() const {
+		return renderStatistics;
+	}
+
+	void resetRenderStatistics() {
+		renderStatistics = RenderStatistics();
+	}
 };
 
 } /* namespace utility_functions */
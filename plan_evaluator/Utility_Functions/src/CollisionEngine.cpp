@@ -0,0 +1,603 @@
+/*
+ * CollisionEngine.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include "CollisionEngine.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <osg/Geode>
+#include <osg/Geometry>
+#include <osg/Matrixd>
+#include <osg/TriangleFunctor>
+
+#include "DistanceField.h"
+#include "GeodeFinder.h"
+#include "Constants.h"
+
+namespace utility_functions {
+
+namespace {
+	const unsigned int MAX_LEAF_TRIANGLES = 4;	///<Nodes with this many triangles or fewer are not split further.
+	const size_t MAX_TREE_DEPTH = 64;			///<Median splits keep the depth near log2 of the number of leaves, far below this.
+
+	///Collects the triangles of a drawable, moved into world coordinates. Used through osg::TriangleFunctor.
+	struct TriangleCollector {
+		osg::Matrixd localToWorld;
+		std::vector<osg::Vec3d>* vertices;
+
+		void operator()(const osg::Vec3d v1, const osg::Vec3d v2, const osg::Vec3d v3, bool treatVertexDataAsTemporary) {
+			vertices->push_back(v1 * localToWorld);
+			vertices->push_back(v2 * localToWorld);
+			vertices->push_back(v3 * localToWorld);
+		}
+	};
+
+	///@return true if the intervals [min1, max1] and [min2, max2] do not overlap.
+	inline bool separated(double min1, double max1, double min2, double max2) {
+		return max1 < min2 || max2 < min1;
+	}
+
+	///@return The squared distance from the point to the axis-aligned box [min, max]. 0 inside the box.
+	inline double squaredDistanceToBox(const osg::Vec3d& point, const osg::Vec3d& min, const osg::Vec3d& max) {
+		double squaredDistance = 0;
+		for (int axis = 0; axis < 3; axis++) {
+			double outside = std::max(0.0, std::max(min[axis] - point[axis], point[axis] - max[axis]));
+			squaredDistance += outside * outside;
+		}
+		return squaredDistance;
+	}
+
+	///@return The point of the segment ab closest to p.
+	osg::Vec3d closestPointOnSegment(const osg::Vec3d& p, const osg::Vec3d& a, const osg::Vec3d& b) {
+		osg::Vec3d ab = b - a;
+		double squaredLength = ab.length2();
+		if (squaredLength == 0) {
+			return a;
+		}
+		return a + ab * std::max(0.0, std::min(1.0, ((p - a) * ab) / squaredLength));
+	}
+
+	///@return The squared distance between the segments p0p1 and q0q1. From Ericson, Real-Time Collision Detection, section 5.1.9.
+	double squaredDistanceBetweenSegments(const osg::Vec3d& p0, const osg::Vec3d& p1, const osg::Vec3d& q0, const osg::Vec3d& q1) {
+		osg::Vec3d d1 = p1 - p0;
+		osg::Vec3d d2 = q1 - q0;
+		osg::Vec3d r = p0 - q0;
+		double a = d1.length2();
+		double e = d2.length2();
+		double f = d2 * r;
+		double s, t;
+		if (a == 0 && e == 0) {
+			return r.length2();
+		}
+		if (a == 0) {
+			s = 0;
+			t = std::max(0.0, std::min(1.0, f / e));
+		} else {
+			double c = d1 * r;
+			if (e == 0) {
+				t = 0;
+				s = std::max(0.0, std::min(1.0, -c / a));
+			} else {
+				double b = d1 * d2;
+				double denominator = a * e - b * b;
+				s = denominator != 0 ? std::max(0.0, std::min(1.0, (b * f - c * e) / denominator)) : 0;
+				t = (b * s + f) / e;
+				if (t < 0) {
+					t = 0;
+					s = std::max(0.0, std::min(1.0, -c / a));
+				} else if (t > 1) {
+					t = 1;
+					s = std::max(0.0, std::min(1.0, (b - c) / a));
+				}
+			}
+		}
+		return ((p0 + d1 * s) - (q0 + d2 * t)).length2();
+	}
+
+	///@return The point of the triangle abc closest to p. From Ericson, Real-Time Collision Detection, section 5.1.5.
+	osg::Vec3d closestPointOnTriangle(const osg::Vec3d& p, const osg::Vec3d& a, const osg::Vec3d& b, const osg::Vec3d& c) {
+		osg::Vec3d ab = b - a;
+		osg::Vec3d ac = c - a;
+		osg::Vec3d ap = p - a;
+		double d1 = ab * ap;
+		double d2 = ac * ap;
+		if (d1 <= 0 && d2 <= 0) {
+			return a;
+		}
+		osg::Vec3d bp = p - b;
+		double d3 = ab * bp;
+		double d4 = ac * bp;
+		if (d3 >= 0 && d4 <= d3) {
+			return b;
+		}
+		double vc = d1 * d4 - d3 * d2;
+		if (vc <= 0 && d1 >= 0 && d3 <= 0) {
+			return a + ab * (d1 / (d1 - d3));
+		}
+		osg::Vec3d cp = p - c;
+		double d5 = ab * cp;
+		double d6 = ac * cp;
+		if (d6 >= 0 && d5 <= d6) {
+			return c;
+		}
+		double vb = d5 * d2 - d1 * d6;
+		if (vb <= 0 && d2 >= 0 && d6 <= 0) {
+			return a + ac * (d2 / (d2 - d6));
+		}
+		double va = d3 * d6 - d5 * d4;
+		if (va <= 0 && (d4 - d3) >= 0 && (d5 - d6) >= 0) {
+			return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+		}
+		double denominator = va + vb + vc;
+		if (denominator == 0) {
+			//A triangle without area. Its closest point is on one of its sides.
+			osg::Vec3d closest = closestPointOnSegment(p, a, b);
+			osg::Vec3d candidates[2] = {closestPointOnSegment(p, b, c), closestPointOnSegment(p, c, a)};
+			for (int i = 0; i < 2; i++) {
+				if ((candidates[i] - p).length2() < (closest - p).length2()) {
+					closest = candidates[i];
+				}
+			}
+			return closest;
+		}
+		return a + ab * (vb / denominator) + ac * (vc / denominator);
+	}
+
+	///@return The squared distance between the segment p0p1 and the triangle abc.
+	double squaredDistanceSegmentToTriangle(const osg::Vec3d& p0, const osg::Vec3d& p1, const osg::Vec3d& a, const osg::Vec3d& b,
+			const osg::Vec3d& c) {
+		//Unless the segment passes through the triangle, the closest points are at an end of the segment, or on a side of the triangle.
+		double best = std::min((closestPointOnTriangle(p0, a, b, c) - p0).length2(), (closestPointOnTriangle(p1, a, b, c) - p1).length2());
+		best = std::min(best, squaredDistanceBetweenSegments(p0, p1, a, b));
+		best = std::min(best, squaredDistanceBetweenSegments(p0, p1, b, c));
+		best = std::min(best, squaredDistanceBetweenSegments(p0, p1, c, a));
+		osg::Vec3d normal = (b - a) ^ (c - a);
+		double side0 = (p0 - a) * normal;
+		double side1 = (p1 - a) * normal;
+		if (best > 0 && ((side0 < 0 && side1 > 0) || (side0 > 0 && side1 < 0))) {
+			osg::Vec3d crossing = p0 + (p1 - p0) * (side0 / (side0 - side1));
+			best = std::min(best, (closestPointOnTriangle(crossing, a, b, c) - crossing).length2());
+		}
+		return best;
+	}
+}
+
+CollisionEngine::Parallelepiped::Parallelepiped(const osg::Vec3d& center, const osg::Vec3d& halfAxis0, const osg::Vec3d& halfAxis1,
+		const osg::Vec3d& halfAxis2)
+:center(center){
+	halfAxes[0] = halfAxis0;
+	halfAxes[1] = halfAxis1;
+	halfAxes[2] = halfAxis2;
+	faceNormals[0] = halfAxis1 ^ halfAxis2;
+	faceNormals[1] = halfAxis2 ^ halfAxis0;
+	faceNormals[2] = halfAxis0 ^ halfAxis1;
+	for (int i = 0; i < 3; i++) {
+		double extent = std::abs(halfAxis0[i]) + std::abs(halfAxis1[i]) + std::abs(halfAxis2[i]);
+		boundsMin[i] = center[i] - extent;
+		boundsMax[i] = center[i] + extent;
+	}
+}
+
+CollisionEngine::CollisionEngine(osg::Node& scene) {
+	std::vector<osg::Vec3d> vertices;
+	GeodeFinder geodeFinder;
+	scene.accept(geodeFinder);
+	std::vector<osg::Geode*> allGeodes = geodeFinder.getNodeList();
+	for (std::vector<osg::Geode*>::iterator geode = allGeodes.begin(); geode != allGeodes.end(); geode++) {
+		//A geode reached through several paths appears once for each, like in intersection visitors.
+		osg::NodePathList paths = (*geode)->getParentalNodePaths(&scene);
+		for (osg::NodePathList::const_iterator path = paths.begin(); path != paths.end(); path++) {
+			osg::TriangleFunctor<TriangleCollector> collector;
+			collector.localToWorld = osg::computeLocalToWorld(*path);
+			collector.vertices = &vertices;
+			for (unsigned int i = 0; i < (*geode)->getNumDrawables(); i++) {
+				(*geode)->getDrawable(i)->accept(collector);
+			}
+		}
+	}
+
+	std::vector<Triangle> unorderedTriangles(vertices.size() / 3);
+	std::vector<osg::Vec3d> centroids(unorderedTriangles.size());
+	std::vector<unsigned int> triangleIds(unorderedTriangles.size());
+	for (size_t t = 0; t < unorderedTriangles.size(); t++) {
+		for (int v = 0; v < 3; v++) {
+			unorderedTriangles[t].vertices[v] = vertices[3 * t + v];
+		}
+		centroids[t] = (vertices[3 * t] + vertices[3 * t + 1] + vertices[3 * t + 2]) / 3.0;
+		triangleIds[t] = t;
+	}
+	if (!unorderedTriangles.empty()) {
+		build(triangleIds, 0, triangleIds.size(), unorderedTriangles, centroids);
+	}
+	triangles.reserve(unorderedTriangles.size());
+	for (size_t t = 0; t < triangleIds.size(); t++) {
+		triangles.push_back(unorderedTriangles[triangleIds[t]]);
+	}
+}
+
+CollisionEngine::CollisionEngine() {
+}
+
+CollisionEngine::~CollisionEngine() {
+}
+
+size_t CollisionEngine::build(std::vector<unsigned int>& triangleIds, size_t begin, size_t end,
+		const std::vector<Triangle>& unorderedTriangles, const std::vector<osg::Vec3d>& centroids) {
+	size_t nodeIndex = nodes.size();
+	nodes.push_back(BvhNode());
+	osg::Vec3d min(unorderedTriangles[triangleIds[begin]].vertices[0]), max(min);
+	osg::Vec3d centroidMin(centroids[triangleIds[begin]]), centroidMax(centroidMin);
+	for (size_t i = begin; i < end; i++) {
+		const Triangle& triangle = unorderedTriangles[triangleIds[i]];
+		const osg::Vec3d& centroid = centroids[triangleIds[i]];
+		for (int axis = 0; axis < 3; axis++) {
+			for (int v = 0; v < 3; v++) {
+				min[axis] = std::min<double>(min[axis], triangle.vertices[v][axis]);
+				max[axis] = std::max<double>(max[axis], triangle.vertices[v][axis]);
+			}
+			centroidMin[axis] = std::min(centroidMin[axis], centroid[axis]);
+			centroidMax[axis] = std::max(centroidMax[axis], centroid[axis]);
+		}
+	}
+	nodes[nodeIndex].first = begin;
+	nodes[nodeIndex].count = end - begin;
+
+	size_t numTriangles = end - begin;
+	osg::Vec3d centroidExtent = centroidMax - centroidMin;
+	int splitAxis = 0;
+	if (centroidExtent.y() > centroidExtent[splitAxis]) {
+		splitAxis = 1;
+	}
+	if (centroidExtent.z() > centroidExtent[splitAxis]) {
+		splitAxis = 2;
+	}
+	if (numTriangles > MAX_LEAF_TRIANGLES && centroidExtent[splitAxis] > 0) {
+		//Splitting at the median centroid along the longest axis, which keeps the tree balanced.
+		size_t middle = begin + numTriangles / 2;
+		std::nth_element(triangleIds.begin() + begin, triangleIds.begin() + middle, triangleIds.begin() + end,
+				[&](unsigned int a, unsigned int b) { return centroids[a][splitAxis] < centroids[b][splitAxis]; });
+		build(triangleIds, begin, middle, unorderedTriangles, centroids);
+		size_t rightChild = build(triangleIds, middle, end, unorderedTriangles, centroids);
+		nodes[nodeIndex].first = rightChild;
+		nodes[nodeIndex].count = 0;
+	}
+	nodes[nodeIndex].min = min;
+	nodes[nodeIndex].max = max;
+	return nodeIndex;
+}
+
+bool CollisionEngine::mayIntersectNode(const Parallelepiped& volume, const BvhNode& node) {
+	for (int axis = 0; axis < 3; axis++) {
+		if (separated(volume.boundsMin[axis], volume.boundsMax[axis], node.min[axis], node.max[axis])) {
+			return false;
+		}
+	}
+	//Long, slanted edges fill little of their axis-aligned bounds, so the faces of the volume are tried as well.
+	osg::Vec3d nodeMin(node.min), nodeMax(node.max);
+	osg::Vec3d nodeCenter = (nodeMin + nodeMax) * 0.5;
+	osg::Vec3d nodeHalfExtent = (nodeMax - nodeMin) * 0.5;
+	for (int face = 0; face < 3; face++) {
+		const osg::Vec3d& normal = volume.faceNormals[face];
+		double volumeRadius = std::abs(volume.halfAxes[face] * normal);
+		double nodeRadius = nodeHalfExtent.x() * std::abs(normal.x()) + nodeHalfExtent.y() * std::abs(normal.y())
+				+ nodeHalfExtent.z() * std::abs(normal.z());
+		if (std::abs((nodeCenter - volume.center) * normal) > volumeRadius + nodeRadius) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool CollisionEngine::intersectsTriangle(const Parallelepiped& volume, const Triangle& triangle) {
+	osg::Vec3d vertices[3] = {triangle.vertices[0], triangle.vertices[1], triangle.vertices[2]};
+	//Any axis the shapes are apart along proves that they do not touch, so the cheap coordinate axes are tried first.
+	for (int axis = 0; axis < 3; axis++) {
+		double triangleMin = std::min(vertices[0][axis], std::min(vertices[1][axis], vertices[2][axis]));
+		double triangleMax = std::max(vertices[0][axis], std::max(vertices[1][axis], vertices[2][axis]));
+		if (separated(triangleMin, triangleMax, volume.boundsMin[axis], volume.boundsMax[axis])) {
+			return false;
+		}
+	}
+
+	//The convex shapes are apart if and only if they are apart along one of these axes: The face normals of each, and
+	//the cross product of each pair of edge directions. Degenerate axes project both shapes to 0, and separate nothing.
+	osg::Vec3d triangleEdges[3] = {vertices[1] - vertices[0], vertices[2] - vertices[1], vertices[0] - vertices[2]};
+	osg::Vec3d axes[13];
+	int numAxes = 0;
+	for (int face = 0; face < 3; face++) {
+		axes[numAxes++] = volume.faceNormals[face];
+	}
+	axes[numAxes++] = triangleEdges[0] ^ triangleEdges[1];
+	for (int volumeEdge = 0; volumeEdge < 3; volumeEdge++) {
+		for (int triangleEdge = 0; triangleEdge < 3; triangleEdge++) {
+			axes[numAxes++] = volume.halfAxes[volumeEdge] ^ triangleEdges[triangleEdge];
+		}
+	}
+	for (int a = 0; a < numAxes; a++) {
+		const osg::Vec3d& axis = axes[a];
+		double centerProjection = volume.center * axis;
+		double volumeRadius = std::abs(volume.halfAxes[0] * axis) + std::abs(volume.halfAxes[1] * axis) + std::abs(volume.halfAxes[2] * axis);
+		double p0 = vertices[0] * axis;
+		double p1 = vertices[1] * axis;
+		double p2 = vertices[2] * axis;
+		if (separated(std::min(p0, std::min(p1, p2)), std::max(p0, std::max(p1, p2)),
+				centerProjection - volumeRadius, centerProjection + volumeRadius)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool CollisionEngine::intersects(const Parallelepiped& volume) const {
+	if (nodes.empty()) {
+		return false;
+	}
+	size_t stack[MAX_TREE_DEPTH + 1];
+	size_t stackSize = 0;
+	stack[stackSize++] = 0;
+	while (stackSize > 0) {
+		const BvhNode& node = nodes[stack[--stackSize]];
+		if (!mayIntersectNode(volume, node)) {
+			continue;
+		}
+		if (node.count > 0) {
+			for (unsigned int t = node.first; t < node.first + node.count; t++) {
+				if (intersectsTriangle(volume, triangles[t])) {
+					return true;
+				}
+			}
+		} else {
+			stack[stackSize++] = node.first;
+			stack[stackSize++] = &node - &nodes[0] + 1;
+		}
+	}
+	return false;
+}
+
+double CollisionEngine::distanceToSurface(const osg::Vec3d& point, double maxDistance) const {
+	if (nodes.empty()) {
+		return maxDistance;
+	}
+	double bestSquaredDistance = maxDistance * maxDistance;
+	size_t stack[MAX_TREE_DEPTH + 1];
+	size_t stackSize = 0;
+	stack[stackSize++] = 0;
+	while (stackSize > 0) {
+		size_t nodeIndex = stack[--stackSize];
+		const BvhNode& node = nodes[nodeIndex];
+		if (squaredDistanceToBox(point, node.min, node.max) >= bestSquaredDistance) {
+			continue;
+		}
+		if (node.count > 0) {
+			for (unsigned int t = node.first; t < node.first + node.count; t++) {
+				const GeometryVec3* vertices = triangles[t].vertices;
+				double squaredDistance = (closestPointOnTriangle(point, vertices[0], vertices[1], vertices[2]) - point).length2();
+				bestSquaredDistance = std::min(bestSquaredDistance, squaredDistance);
+			}
+		} else {
+			//Visiting the nearer child first finds close triangles early, which lets us skip more of the other child.
+			size_t left = nodeIndex + 1;
+			size_t right = node.first;
+			if (squaredDistanceToBox(point, nodes[left].min, nodes[left].max) < squaredDistanceToBox(point, nodes[right].min, nodes[right].max)) {
+				std::swap(left, right);
+			}
+			stack[stackSize++] = left;
+			stack[stackSize++] = right;
+		}
+	}
+	return std::min(maxDistance, std::sqrt(bestSquaredDistance));
+}
+
+double CollisionEngine::edgeClearance(const osg::Vec3d& edgeStart, const osg::Vec3d& edgeEnd, double maxDistance) const {
+	if (nodes.empty() || (distanceField && distanceField->segmentIsClear(edgeStart, edgeEnd, maxDistance))) {
+		return maxDistance;
+	}
+	osg::Vec3d edgeMin(std::min(edgeStart.x(), edgeEnd.x()), std::min(edgeStart.y(), edgeEnd.y()), std::min(edgeStart.z(), edgeEnd.z()));
+	osg::Vec3d edgeMax(std::max(edgeStart.x(), edgeEnd.x()), std::max(edgeStart.y(), edgeEnd.y()), std::max(edgeStart.z(), edgeEnd.z()));
+	osg::Vec3d edgeCenter = (edgeStart + edgeEnd) * 0.5;
+	double halfLength = 0.5 * (edgeEnd - edgeStart).length();
+	//A lower bound on the squared distance from the edge to a node's box. The gap between the boxes is tight for edges
+	//along the axes, and the distance from the edge's center minus its half length is tight for short, slanted edges.
+	auto squaredDistanceToNode = [&](const BvhNode& node) {
+		double squaredBoxGap = 0;
+		for (int axis = 0; axis < 3; axis++) {
+			double gap = std::max(0.0, std::max(node.min[axis] - edgeMax[axis], edgeMin[axis] - node.max[axis]));
+			squaredBoxGap += gap * gap;
+		}
+		double centerGap = std::max(0.0, std::sqrt(squaredDistanceToBox(edgeCenter, node.min, node.max)) - halfLength);
+		return std::max(squaredBoxGap, centerGap * centerGap);
+	};
+
+	double bestSquaredDistance = maxDistance * maxDistance;
+	size_t stack[MAX_TREE_DEPTH + 1];
+	size_t stackSize = 0;
+	stack[stackSize++] = 0;
+	while (stackSize > 0 && bestSquaredDistance > 0) {
+		size_t nodeIndex = stack[--stackSize];
+		const BvhNode& node = nodes[nodeIndex];
+		if (squaredDistanceToNode(node) >= bestSquaredDistance) {
+			continue;
+		}
+		if (node.count > 0) {
+			for (unsigned int t = node.first; t < node.first + node.count && bestSquaredDistance > 0; t++) {
+				const GeometryVec3* vertices = triangles[t].vertices;
+				bestSquaredDistance = std::min(bestSquaredDistance,
+						squaredDistanceSegmentToTriangle(edgeStart, edgeEnd, vertices[0], vertices[1], vertices[2]));
+			}
+		} else {
+			size_t left = nodeIndex + 1;
+			size_t right = node.first;
+			if (squaredDistanceToNode(nodes[left]) < squaredDistanceToNode(nodes[right])) {
+				std::swap(left, right);
+			}
+			stack[stackSize++] = left;
+			stack[stackSize++] = right;
+		}
+	}
+	return std::min(maxDistance, std::sqrt(bestSquaredDistance));
+}
+
+osg::Vec3d CollisionEngine::getBoundsMin() const {
+	return nodes.empty() ? osg::Vec3d(0, 0, 0) : osg::Vec3d(nodes[0].min);
+}
+
+osg::Vec3d CollisionEngine::getBoundsMax() const {
+	return nodes.empty() ? osg::Vec3d(0, 0, 0) : osg::Vec3d(nodes[0].max);
+}
+
+Hash128 CollisionEngine::getFingerprint() const {
+	Hash128Builder builder;
+	for (size_t t = 0; t < triangles.size(); t++) {
+		for (int v = 0; v < 3; v++) {
+			builder.addBytes(triangles[t].vertices[v].ptr(), 3 * sizeof(GeometryReal));
+		}
+	}
+	return builder.finish();
+}
+
+void CollisionEngine::setDistanceField(DistanceField* field) {
+	distanceField.reset(field);
+}
+
+bool CollisionEngine::edgeComesTooClose(const osg::Vec3d& edgeStart, const osg::Vec3d& edgeEnd, double bufferSize) const {
+	//The same volume as generatePolytopeFromPlanEdge makes. Note that rightDirection is not normalized there either.
+	osg::Vec3d edgeDirection = (edgeEnd - edgeStart);
+	edgeDirection.normalize();
+	osg::Vec3d upDirection = UP_VECTOR;
+	if (edgeEnd.x() == edgeStart.x() && edgeEnd.y() == edgeStart.y()) {
+		//The special case of a waypoint that is directly above another
+		upDirection = osg::Vec3d(1, 0, 0);
+	}
+	osg::Vec3d rightDirection = edgeDirection ^ upDirection;
+	Parallelepiped volume((edgeStart + edgeEnd) * 0.5, (edgeEnd - edgeStart) * 0.5, upDirection * bufferSize, rightDirection * bufferSize);
+	if (distanceField) {
+		//The volume lies within the sweep of a ball around the edge, with the radius of its corners (the up and right axes
+		//are perpendicular). If nothing is that close to the edge, nothing is in the volume.
+		double sweepRadius = std::sqrt(volume.halfAxes[1].length2() + volume.halfAxes[2].length2());
+		if (distanceField->segmentIsClear(edgeStart, edgeEnd, sweepRadius)) {
+			return false;
+		}
+		//And the volume holds the ball around its center that reaches its nearest face.
+		double lower, upper;
+		distanceField->getDistanceBounds(volume.center, lower, upper);
+		double inscribedRadius = std::numeric_limits<double>::infinity();
+		for (int face = 0; face < 3; face++) {
+			double normalLength = volume.faceNormals[face].length();
+			if (normalLength > 0) {
+				inscribedRadius = std::min(inscribedRadius, std::abs(volume.halfAxes[face] * volume.faceNormals[face]) / normalLength);
+			}
+		}
+		if (upper <= inscribedRadius) {
+			return true;
+		}
+	}
+	return intersects(volume);
+}
+
+bool CollisionEngine::pointComesTooClose(const osg::Vec3d& point, double bufferRadius) const {
+	if (distanceField) {
+		//The cube holds the ball of radius bufferRadius, and is held by the ball of radius bufferRadius*sqrt(3).
+		double lower, upper;
+		distanceField->getDistanceBounds(point, lower, upper);
+		if (lower > bufferRadius * std::sqrt(3.0)) {
+			return false;
+		}
+		if (upper <= bufferRadius) {
+			return true;
+		}
+	}
+	Parallelepiped volume(point, osg::Vec3d(bufferRadius, 0, 0), osg::Vec3d(0, bufferRadius, 0), osg::Vec3d(0, 0, bufferRadius));
+	return intersects(volume);
+}
+
+void CollisionEngine::attachTo(osg::Node& scene, const std::string& distanceFieldCacheFile/*=""*/) {
+	if (scene.getUserData() != nullptr && getAttached(scene) == nullptr) {
+		return;
+	}
+	attachTo(scene, new CollisionEngine(scene), distanceFieldCacheFile);
+}
+
+void CollisionEngine::attachTo(osg::Node& scene, CollisionEngine* newEngine, const std::string& distanceFieldCacheFile/*=""*/) {
+	osg::ref_ptr<CollisionEngine> engine = newEngine;
+	if (scene.getUserData() != nullptr && getAttached(scene) == nullptr) {
+		return;
+	}
+	if (DISTANCE_FIELD_VOXEL_SIZE > 0 && engine->getTriangleCount() > 0) {
+		DistanceField* field = nullptr;
+		if (!distanceFieldCacheFile.empty()) {
+			field = DistanceField::load(distanceFieldCacheFile, engine->getFingerprint(), DISTANCE_FIELD_VOXEL_SIZE, DISTANCE_FIELD_BAND);
+		}
+		if (field != nullptr) {
+			std::cout << "Loaded the distance field from " << distanceFieldCacheFile << std::endl;
+		} else {
+			field = new DistanceField(*engine, DISTANCE_FIELD_VOXEL_SIZE, DISTANCE_FIELD_BAND);
+			std::cout << "Made a distance field of " << field->getNumStoredBricks() << " bricks (" << field->estimateBytes() / (1024 * 1024)
+					<< " MB)" << std::endl;
+			if (!distanceFieldCacheFile.empty() && !field->save(distanceFieldCacheFile)) {
+				std::cerr << "Warning: Could not store the distance field in " << distanceFieldCacheFile << std::endl;
+			}
+		}
+		engine->setDistanceField(field);
+	}
+	scene.setUserData(engine.get());
+}
+
+void CollisionEngine::writeTo(SceneCache::Writer& writer) const {
+	writer.add(SceneCache::COLLISION_TRIANGLES, triangles.data(), triangles.size());
+	writer.add(SceneCache::COLLISION_NODES, nodes.data(), nodes.size());
+}
+
+osg::ref_ptr<CollisionEngine> CollisionEngine::readFrom(const SceneCache& cache) {
+	const Triangle* storedTriangles;
+	const BvhNode* storedNodes;
+	size_t numTriangles, numNodes;
+	if (!cache.get(SceneCache::COLLISION_TRIANGLES, storedTriangles, numTriangles) || !cache.get(SceneCache::COLLISION_NODES, storedNodes, numNodes)
+			|| (numNodes == 0) != (numTriangles == 0)) {
+		return nullptr;
+	}
+	//Checking that the hierarchy is one build could have made: Children come after their parents, leaves hold
+	//triangles we have, and the tree is no deeper than the searches can handle.
+	std::vector<size_t> depths(numNodes, 0);
+	for (size_t n = 0; n < numNodes; n++) {
+		const BvhNode& node = storedNodes[n];
+		if (node.count == 0) {
+			if (node.first <= n + 1 || node.first >= numNodes || depths[n] + 1 >= MAX_TREE_DEPTH) {
+				return nullptr;
+			}
+			depths[n + 1] = depths[node.first] = depths[n] + 1;
+		} else if (node.first > numTriangles || node.count > numTriangles - node.first) {
+			return nullptr;
+		}
+	}
+	osg::ref_ptr<CollisionEngine> engine = new CollisionEngine();
+	engine->triangles.assign(storedTriangles, storedTriangles + numTriangles);
+	engine->nodes.assign(storedNodes, storedNodes + numNodes);
+	return engine;
+}
+
+osg::ref_ptr<osg::Geode> CollisionEngine::makeGeode() const {
+	osg::ref_ptr<osg::Vec3Array> vertices = new osg::Vec3Array();
+	vertices->reserve(3 * triangles.size());
+	for (size_t t = 0; t < triangles.size(); t++) {
+		for (int v = 0; v < 3; v++) {
+			vertices->push_back(triangles[t].vertices[v]);
+		}
+	}
+	osg::ref_ptr<osg::Geometry> geometry = new osg::Geometry();
+	geometry->setVertexArray(vertices.get());
+	geometry->addPrimitiveSet(new osg::DrawArrays(osg::PrimitiveSet::TRIANGLES, 0, vertices->size()));
+	osg::ref_ptr<osg::Geode> geode = new osg::Geode();
+	geode->addDrawable(geometry.get());
+	return geode;
+}
+
+const CollisionEngine* CollisionEngine::getAttached(const osg::Node& scene) {
+	return dynamic_cast<const CollisionEngine*>(scene.getUserData());
+}
+
+} /* namespace utility_functions */
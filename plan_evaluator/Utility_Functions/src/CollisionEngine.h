@@ -0,0 +1,184 @@
+/*
+ * CollisionEngine.h
+ *
+ * Fast checks of whether the safety volume around a plan edge (or a viewpoint) touches the inspection target, using a
+ * bounding volume hierarchy over the scene's triangles instead of a scene graph traversal.
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef COLLISIONENGINE_H_
+#define COLLISIONENGINE_H_
+
+#include <osg/Geode>
+#include <osg/Node>
+#include <osg/Referenced>
+#include <osg/Vec3d>
+#include <memory>
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+#include "GeometryPrecision.h"
+#include "Hash128.h"
+#include "SceneCache.h"
+
+namespace utility_functions {
+
+class DistanceField;
+
+/**
+ * Holds the triangles of a scene (in world coordinates) in a bounding volume hierarchy, and tests parallelepipeds
+ * (such as the box-shaped volume generatePolytopeFromPlanEdge makes around an edge) against them with the separating
+ * axis theorem. Tests stop at the first triangle found, as we only need to know whether there is a collision.
+ * Tests the same volumes as the osgUtil::PolytopeIntersector checks in OsgHelpers.cpp, but the answers have only been
+ * compared against clipping each triangle by the volume's planes, not against OSG itself. OSG stores the corners as float
+ * osg::Vec3, so triangles that barely touch a face of the volume may be answered differently (intersectionBenchmarkRunner
+ * compares the two on real models). The scene must not be changed after the engine is made. Read-only after
+ * construction, so any number of threads may test against it at once.
+ * An engine may also carry a DistanceField, which answers most tests with a few lookups. Only the tests it cannot
+ * settle for certain go on to the triangles, so the answers stay the same.
+ */
+class CollisionEngine : public osg::Referenced {
+
+private:
+	struct Triangle {
+		GeometryVec3 vertices[3];
+	};
+
+	/**
+	 * A node of the hierarchy. Leaves hold the triangles [first, first+count). The children of an inner node are the
+	 * node right after it, and the node at index first.
+	 */
+	struct BvhNode {
+		GeometryVec3 min;	///<Found from the stored triangles, so it holds them in either precision.
+		GeometryVec3 max;
+		unsigned int first;
+		unsigned int count;	///<0 for inner nodes.
+	};
+
+	/**
+	 * A parallelepiped: All points center + s0*halfAxes[0] + s1*halfAxes[1] + s2*halfAxes[2], with each s in [-1, 1].
+	 * Along with what the tests need to know about it.
+	 */
+	struct Parallelepiped {
+		osg::Vec3d center;
+		osg::Vec3d halfAxes[3];
+		osg::Vec3d faceNormals[3];	///<Not normalized.
+		osg::Vec3d boundsMin;		///<The axis-aligned box around the parallelepiped.
+		osg::Vec3d boundsMax;
+
+		Parallelepiped(const osg::Vec3d& center, const osg::Vec3d& halfAxis0, const osg::Vec3d& halfAxis1, const osg::Vec3d& halfAxis2);
+	};
+
+	std::vector<Triangle> triangles;	///<Ordered so the triangles of each leaf are consecutive.
+	std::vector<BvhNode> nodes;			///<The root is nodes[0].
+	std::unique_ptr<DistanceField> distanceField;	///<nullptr until setDistanceField is called.
+
+	/**
+	 * Builds the hierarchy over the triangles triangleIds[begin, end), reordering that part of triangleIds so each leaf's triangles are consecutive.
+	 * @return The index of the subtree's root in nodes.
+	 */
+	size_t build(std::vector<unsigned int>& triangleIds, size_t begin, size_t end, const std::vector<Triangle>& unorderedTriangles,
+			const std::vector<osg::Vec3d>& centroids);
+
+	///@return true if the parallelepiped may touch the node's bounding box. Never false if it does.
+	static bool mayIntersectNode(const Parallelepiped& volume, const BvhNode& node);
+
+	///@return true if the triangle and the parallelepiped share a point.
+	static bool intersectsTriangle(const Parallelepiped& volume, const Triangle& triangle);
+
+	///@return true if any triangle of the scene shares a point with the parallelepiped.
+	bool intersects(const Parallelepiped& volume) const;
+
+	///Makes an engine without triangles, for readFrom to fill in.
+	CollisionEngine();
+
+public:
+
+	///Collects the triangles of all geodes in the scene, and builds the hierarchy.
+	explicit CollisionEngine(osg::Node& scene);
+
+	/**
+	 * Checks the safety volume edgeComesTooCloseToStructure (see OsgHelpers.h) checks without an engine. Answers may differ
+	 * from that for triangles touching the volume's faces (see above).
+	 * @param bufferSize How far the volume reaches from the edge, upwards, downwards and sideways.
+	 */
+	bool edgeComesTooClose(const osg::Vec3d& edgeStart, const osg::Vec3d& edgeEnd, double bufferSize) const;
+
+	///Checks the axis-aligned cube around the point that collisionCheckWithBuffer (see OsgHelpers.h) checks without an engine.
+	bool pointComesTooClose(const osg::Vec3d& point, double bufferRadius) const;
+
+	/**
+	 * Finds the distance from the point to the nearest triangle, by searching the hierarchy.
+	 * @param maxDistance Returned if no triangle is closer than this. Lower values let the search skip more of the hierarchy.
+	 */
+	double distanceToSurface(const osg::Vec3d& point, double maxDistance) const;
+
+	size_t getTriangleCount() const {
+		return triangles.size();
+	}
+
+	/**
+	 * Finds the clearance of an edge: The distance from the segment between the points to the nearest triangle. In other
+	 * words, the radius of the largest capsule around the edge that holds no part of the target. Unlike the safety box
+	 * of edgeComesTooClose, the capsule does not depend on the direction of the edge.
+	 * @param maxDistance Returned if no triangle is closer than this. Lower values let the search skip more of the hierarchy.
+	 */
+	double edgeClearance(const osg::Vec3d& edgeStart, const osg::Vec3d& edgeEnd, double maxDistance) const;
+
+	///@return The corners of the bounding box of all triangles. Both are (0,0,0) if there are no triangles.
+	osg::Vec3d getBoundsMin() const;
+	osg::Vec3d getBoundsMax() const;
+
+	///@return A hash of the triangles. Differs between scenes (and between versions of a model) with different triangles.
+	Hash128 getFingerprint() const;
+
+	///Lets the distance field speed up the tests. It must have been made from this engine's triangles. The engine takes ownership.
+	void setDistanceField(DistanceField* field);
+
+	const DistanceField* getDistanceField() const {
+		return distanceField.get();
+	}
+
+	/**
+	 * Makes an engine for the scene, and attaches it to the scene as its user data, where edgeComesTooCloseToStructure
+	 * and collisionCheckWithBuffer find it. Scenes that already have other user data are left alone.
+	 * Unless DISTANCE_FIELD_VOXEL_SIZE is 0, the engine also gets a distance field. It is loaded from
+	 * distanceFieldCacheFile if that holds one made from the same triangles. Otherwise it is made, and stored there.
+	 * @param distanceFieldCacheFile Where to keep the distance field between runs. If empty, the field is made each time.
+	 */
+	static void attachTo(osg::Node& scene, const std::string& distanceFieldCacheFile = "");
+
+	/**
+	 * Like attachTo above, with an engine made beforehand, such as one read from a SceneCache. The engine must hold the
+	 * triangles of the scene.
+	 */
+	static void attachTo(osg::Node& scene, CollisionEngine* engine, const std::string& distanceFieldCacheFile = "");
+
+	///Stores the triangles and the hierarchy in the cache.
+	void writeTo(SceneCache::Writer& writer) const;
+
+	/**
+	 * Makes an engine from the triangles and hierarchy stored in the cache by writeTo, without building anything.
+	 * @return The engine, or nullptr if the cache holds no valid hierarchy.
+	 */
+	static osg::ref_ptr<CollisionEngine> readFrom(const SceneCache& cache);
+
+	/**
+	 * Makes a geode holding the engine's triangles, in world coordinates. Can stand in for the scene the engine was made
+	 * from where only its shape matters, such as in intersection tests.
+	 */
+	osg::ref_ptr<osg::Geode> makeGeode() const;
+
+	///@return The engine attached to the scene by attachTo, or nullptr if there is none.
+	static const CollisionEngine* getAttached(const osg::Node& scene);
+
+protected:
+	///Like other osg::Referenced objects, engines are deleted when the last reference to them is dropped.
+	virtual ~CollisionEngine();
+};
+
+} /* namespace utility_functions */
+
+#endif /* COLLISIONENGINE_H_ */
@@ -47,6 +47,17 @@ namespace utility_functions {
 	const double maxEnergyMultiplier = 1.0;//0.5;//1.5;
 	const double COLLISION_PENALTY_MODIFIER = 2.0; //0.5
 	const double EDGE_SAFETY_BUFFER = 1.5; ///<The closest we want the center of any edge to be to the inspection target. Used for collision detection.
+	///If true, edges are penalized by how close they come to the target, measured exactly (see edgeClearanceFromStructure):
+	///Edges closer than EDGE_SAFETY_BUFFER get half the collision penalty at that distance, growing to the full penalty at contact.
+	///If false, edges whose safety box touches the target get the full penalty (see edgeComesTooCloseToStructure).
+	const bool GRADED_COLLISION_PENALTY = false;
+	///Grids with at most this many pairs of boxes have the collisions of all edges between them checked up front, in
+	///parallel, and are stored as one array of bits (see BoxCollisionMatrix). Larger grids check each edge the first time a
+	///plan uses it, and only store the answers found.
+	const size_t BOX_COLLISION_MATRIX_EAGER_PAIRS = 1000000;
+	///Larger grids store the answers of at most this many words of 32 pairs (each word takes about 40 bytes), and check
+	///other edges against the scene each time.
+	const size_t BOX_COLLISION_MATRIX_MAX_SPARSE_WORDS = 4000000;
 	const osg::Vec3d UP_VECTOR = osg::Vec3d(0,0,1); ///< A vector showing the up-direction.
 
 	///Default parameters for estimates evaluating as if the sensor was a camera. Can be overridden in the constructor to CameraEstimator.
@@ -59,6 +70,34 @@ namespace utility_functions {
 	const double FOV_VERTICAL = 46.0;
 	const double FOV_HORIZONTAL = 46.0;
 
+	///The spacing of the distance field (see DistanceField) that speeds up collision checks. 0 turns the field off.
+	const double DISTANCE_FIELD_VOXEL_SIZE = 0.5;
+	///The largest distance the field stores. A few voxels beyond the corners of the boxes viewpoints must keep clear
+	///(BOX_SAFETY_MARGIN*sqrt(3)) and of the safety volumes around edges (EDGE_SAFETY_BUFFER*sqrt(2)), so those checks
+	///are mostly answered by the field. Farther queries, like whether the target is within CAMERA_FAR_PLANE_DIST of a
+	///viewpoint, get a lower bound of about the band from it, and are checked exactly when that is not enough.
+	const double DISTANCE_FIELD_BAND = 2 * BOX_SAFETY_MARGIN + 2 * DISTANCE_FIELD_VOXEL_SIZE;
+
+	///If true, SceneKeeper stores what it computes from a model in a file next to it (with the extension .scenecache
+	///added, see SceneCache), and later runs on the unchanged model load that instead of the model.
+	const bool USE_SCENE_CACHE = true;
+
+	///When estimators render a simplified copy of the inspection target (see VisibilityMesh and the visibilityMeshFaceFraction
+	///of PlanCoverageEstimator), models with at most this many triangles are rendered as they are, and larger models are
+	///not simplified below it.
+	const size_t VISIBILITY_MESH_MIN_FACES = 10000;
+
+	///The max number of whole-plan scores we remember, to answer re-evaluations of identical plans without evaluating them.
+	const size_t PLAN_RESULT_CACHE_CAPACITY = 50000;
+	///We remember the combined coverage of every plan prefix whose length is a multiple of this. See PlanPrefixTrie.
+	const size_t PLAN_PREFIX_SNAPSHOT_INTERVAL = 3;
+	///When evaluating plans on several threads, long edges are split into pieces of at most this many sampling positions,
+	///which idle threads can steal. Smaller pieces balance the threads better, but each piece has some overhead.
+	const size_t EDGE_SUBTASK_SAMPLES = 4;
+	///The niceness of the thread doing speculative prefetching (see PlanCoverageEstimator::startSpeculativePrefetch),
+	///so it gives way to the optimizer and to other processes.
+	const int SPECULATIVE_PREFETCH_NICENESS = 10;
+
 
 }
 
@@ -0,0 +1,95 @@
+/*
+ * CoveragePatternPool.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include "CoveragePatternPool.h"
+
+#include <iterator>
+
+namespace utility_functions {
+
+namespace {
+	///Output iterator feeding every block written to it into a hash, so boost::to_block_range can hash a bitset in place.
+	class BlockHashingIterator : public std::iterator<std::output_iterator_tag, void, void, void, void> {
+	private:
+		Hash128Builder* builder;
+	public:
+		explicit BlockHashingIterator(Hash128Builder& builder)
+		:builder(&builder){}
+
+		BlockHashingIterator& operator=(boost::dynamic_bitset<>::block_type block) {
+			builder->addWord(block);
+			return *this;
+		}
+		BlockHashingIterator& operator*() {
+			return *this;
+		}
+		BlockHashingIterator& operator++() {
+			return *this;
+		}
+		BlockHashingIterator& operator++(int) {
+			return *this;
+		}
+	};
+}
+
+Hash128 hashCoverage(const boost::dynamic_bitset<>& coverage) {
+	Hash128Builder builder;
+	builder.addWord(coverage.size()); //Bitsets of different lengths with the same blocks should not collide.
+	boost::to_block_range(coverage, BlockHashingIterator(builder));
+	return builder.finish();
+}
+
+CoveragePatternPool::CoveragePatternPool()
+:numPatterns(0),
+ numPatternBytes(0){
+}
+
+CoveragePattern CoveragePatternPool::intern(const boost::dynamic_bitset<>& coverage) {
+	std::vector<CoveragePattern>& candidates = patterns[hashCoverage(coverage)];
+	for (std::vector<CoveragePattern>::const_iterator candidate = candidates.begin(); candidate != candidates.end(); candidate++) {
+		if (**candidate == coverage) {
+			return *candidate;
+		}
+	}
+	CoveragePattern newPattern = std::make_shared<const boost::dynamic_bitset<> >(coverage);
+	candidates.push_back(newPattern);
+	numPatterns++;
+	numPatternBytes += coverage.num_blocks() * sizeof(boost::dynamic_bitset<>::block_type);
+	return newPattern;
+}
+
+size_t CoveragePatternPool::releaseUnused() {
+	size_t numReleased = 0;
+	for (std::map<Hash128, std::vector<CoveragePattern> >::iterator entry = patterns.begin(); entry != patterns.end();) {
+		std::vector<CoveragePattern>& candidates = entry->second;
+		for (std::vector<CoveragePattern>::iterator candidate = candidates.begin(); candidate != candidates.end();) {
+			if (candidate->use_count() == 1) {
+				//Only the pool holds this pattern.
+				numPatternBytes -= (*candidate)->num_blocks() * sizeof(boost::dynamic_bitset<>::block_type);
+				candidate = candidates.erase(candidate);
+				numReleased++;
+			} else {
+				candidate++;
+			}
+		}
+		if (candidates.empty()) {
+			patterns.erase(entry++);
+		} else {
+			entry++;
+		}
+	}
+	numPatterns -= numReleased;
+	return numReleased;
+}
+
+size_t CoveragePatternPool::estimateBytes() const {
+	//Payloads, plus the bookkeeping of each pattern: a map node, a vector and the shared_ptr control block.
+	const size_t perPatternOverhead = sizeof(Hash128) + sizeof(std::vector<CoveragePattern>) + 4 * sizeof(void*)
+			+ sizeof(CoveragePattern) + sizeof(boost::dynamic_bitset<>) + 2 * sizeof(long);
+	return numPatternBytes + numPatterns * perPatternOverhead;
+}
+
+} /* namespace utility_functions */
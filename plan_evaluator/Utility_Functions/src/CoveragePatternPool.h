@@ -0,0 +1,70 @@
+/*
+ * CoveragePatternPool.h
+ *
+ * A pool of immutable coverage bitsets, stored once per distinct content. Many edges see exactly the same primitives
+ * (most commonly none at all, for edges far away from or hidden behind the structure), so storing each distinct
+ * pattern only once saves a lot of memory.
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef COVERAGEPATTERNPOOL_H_
+#define COVERAGEPATTERNPOOL_H_
+
+#include <boost/dynamic_bitset/dynamic_bitset.hpp>
+#include <map>
+#include <memory>
+#include <stddef.h>
+#include <vector>
+
+#include "Hash128.h"
+
+namespace utility_functions {
+
+///A shared, immutable coverage bitset. All users holding the same pattern point to the same payload.
+typedef std::shared_ptr<const boost::dynamic_bitset<> > CoveragePattern;
+
+/**
+ * Hashes the contents of a bitset. The blocks are fed straight into the hash, without copying the bitset.
+ */
+Hash128 hashCoverage(const boost::dynamic_bitset<>& coverage);
+
+/**
+ * Content-addressed storage of coverage bitsets. Interning a bitset returns the pooled copy with the same
+ * content, creating it if needed. Patterns stay in the pool until releaseUnused is called while nobody else holds them.
+ */
+class CoveragePatternPool {
+
+private:
+	///All pooled patterns, indexed by the hash of their contents. Collisions are astronomically unlikely, but
+	///we still compare contents on lookup, so several patterns may share a hash.
+	std::map<Hash128, std::vector<CoveragePattern> > patterns;
+	size_t numPatterns;
+	size_t numPatternBytes;	///<The memory used by all pooled payloads.
+
+public:
+	CoveragePatternPool();
+
+	/**
+	 * Returns the pooled pattern equal to the given bitset, adding a copy of it to the pool if no such pattern exists.
+	 */
+	CoveragePattern intern(const boost::dynamic_bitset<>& coverage);
+
+	/**
+	 * Removes all patterns that are no longer referenced from outside the pool.
+	 * @return The number of removed patterns.
+	 */
+	size_t releaseUnused();
+
+	///@return The number of distinct patterns in the pool.
+	size_t size() const {
+		return numPatterns;
+	}
+
+	///@return An estimate of the memory used by the pool, in bytes.
+	size_t estimateBytes() const;
+};
+
+} /* namespace utility_functions */
+
+#endif /* COVERAGEPATTERNPOOL_H_ */
@@ -0,0 +1,285 @@
+/*
+ * DistanceField.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include "DistanceField.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <unistd.h>
+
+#include "CollisionEngine.h"
+#include "ThreadPool.h"
+
+namespace utility_functions {
+
+namespace {
+	const char FILE_MAGIC[8] = {'I', 'P', 'P', 'D', 'F', 'L', 'D', '\0'};
+	const uint32_t FILE_FORMAT_VERSION = 1;
+	const int BRICK_VOXELS = DistanceField::BRICK_SIZE * DistanceField::BRICK_SIZE * DistanceField::BRICK_SIZE;
+	///Allowance for distances being stored as floats, and for rounding in the interpolation, relative to the band.
+	const double RELATIVE_SLACK = 1e-6;
+
+	template<typename T>
+	void writeValue(std::ostream& out, const T& value) {
+		out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+	}
+
+	template<typename T>
+	bool readValue(std::istream& in, T& value) {
+		return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+	}
+
+	void writeVec(std::ostream& out, const osg::Vec3d& vec) {
+		for (int axis = 0; axis < 3; axis++) {
+			writeValue(out, vec[axis]);
+		}
+	}
+
+	bool readVec(std::istream& in, osg::Vec3d& vec) {
+		for (int axis = 0; axis < 3; axis++) {
+			if (!readValue(in, vec[axis])) {
+				return false;
+			}
+		}
+		return true;
+	}
+}
+
+DistanceField::DistanceField()
+:voxelSize(0),
+ band(0){
+	sceneKey.low = sceneKey.high = 0;
+	for (int axis = 0; axis < 3; axis++) {
+		dims[axis] = brickDims[axis] = 0;
+	}
+}
+
+DistanceField::DistanceField(const CollisionEngine& engine, double voxelSize, double band, size_t numThreads/*=0*/)
+:sceneKey(engine.getFingerprint()),
+ voxelSize(voxelSize),
+ band(band),
+ surfaceMin(engine.getBoundsMin()),
+ surfaceMax(engine.getBoundsMax()){
+	if (!(voxelSize > 0) || !(band > 0)) {
+		throw std::invalid_argument("The voxel size and band of a distance field must be positive.");
+	}
+	//The grid reaches band beyond the target on all sides. Farther out, the distance to the target's bounding box is enough.
+	size_t numBricks = 1;
+	for (int axis = 0; axis < 3; axis++) {
+		origin[axis] = surfaceMin[axis] - band;
+		dims[axis] = (int32_t) std::ceil((surfaceMax[axis] - surfaceMin[axis] + 2 * band) / voxelSize) + 1;
+		brickDims[axis] = (dims[axis] + BRICK_SIZE - 1) / BRICK_SIZE;
+		numBricks *= brickDims[axis];
+	}
+
+	//A brick is left out if all its voxels are at least band away. Its center tells us that for most bricks.
+	const double brickHalfDiagonal = 0.5 * std::sqrt(3.0) * (BRICK_SIZE - 1) * voxelSize;
+	std::vector<std::vector<float> > brickVoxels(numBricks);
+	ThreadPool threadPool(numThreads);
+	threadPool.parallelFor(numBricks, [&](size_t brick, size_t) {
+		int brickCoordinates[3] = {(int) (brick % brickDims[0]), (int) ((brick / brickDims[0]) % brickDims[1]),
+				(int) (brick / ((size_t) brickDims[0] * brickDims[1]))};
+		osg::Vec3d brickCenter;
+		for (int axis = 0; axis < 3; axis++) {
+			brickCenter[axis] = origin[axis] + voxelSize * (brickCoordinates[axis] * BRICK_SIZE + 0.5 * (BRICK_SIZE - 1));
+		}
+		if (engine.distanceToSurface(brickCenter, band + brickHalfDiagonal) >= band + brickHalfDiagonal) {
+			return;
+		}
+		std::vector<float> values(BRICK_VOXELS, (float) band);
+		bool anyWithinBand = false;
+		for (int z = 0; z < BRICK_SIZE; z++) {
+			for (int y = 0; y < BRICK_SIZE; y++) {
+				for (int x = 0; x < BRICK_SIZE; x++) {
+					int voxelCoordinates[3] = {brickCoordinates[0] * BRICK_SIZE + x, brickCoordinates[1] * BRICK_SIZE + y,
+							brickCoordinates[2] * BRICK_SIZE + z};
+					if (voxelCoordinates[0] >= dims[0] || voxelCoordinates[1] >= dims[1] || voxelCoordinates[2] >= dims[2]) {
+						continue; //Past the edge of the grid. Never looked up.
+					}
+					osg::Vec3d position = origin + osg::Vec3d(voxelCoordinates[0], voxelCoordinates[1], voxelCoordinates[2]) * voxelSize;
+					double distance = engine.distanceToSurface(position, band);
+					values[(z * BRICK_SIZE + y) * BRICK_SIZE + x] = (float) distance;
+					anyWithinBand = anyWithinBand || distance < band;
+				}
+			}
+		}
+		if (anyWithinBand) {
+			brickVoxels[brick].swap(values);
+		}
+	});
+
+	brickOffsets.assign(numBricks, -1);
+	for (size_t brick = 0; brick < numBricks; brick++) {
+		if (!brickVoxels[brick].empty()) {
+			brickOffsets[brick] = voxels.size();
+			voxels.insert(voxels.end(), brickVoxels[brick].begin(), brickVoxels[brick].end());
+		}
+	}
+}
+
+float DistanceField::voxel(int x, int y, int z) const {
+	size_t brick = ((size_t) (z / BRICK_SIZE) * brickDims[1] + y / BRICK_SIZE) * brickDims[0] + x / BRICK_SIZE;
+	int32_t offset = brickOffsets[brick];
+	if (offset < 0) {
+		return band;
+	}
+	return voxels[offset + ((z % BRICK_SIZE) * BRICK_SIZE + y % BRICK_SIZE) * BRICK_SIZE + x % BRICK_SIZE];
+}
+
+double DistanceField::distanceToSurfaceBounds(const osg::Vec3d& point) const {
+	osg::Vec3d outside;
+	for (int axis = 0; axis < 3; axis++) {
+		outside[axis] = std::max(0.0, std::max(surfaceMin[axis] - point[axis], point[axis] - surfaceMax[axis]));
+	}
+	return outside.length();
+}
+
+void DistanceField::getDistanceBounds(const osg::Vec3d& point, double& lower, double& upper) const {
+	lower = distanceToSurfaceBounds(point);
+	upper = std::numeric_limits<double>::infinity();
+	int cell[3];
+	double fraction[3];
+	for (int axis = 0; axis < 3; axis++) {
+		double gridCoordinate = (point[axis] - origin[axis]) / voxelSize;
+		cell[axis] = (int) std::floor(gridCoordinate);
+		if (!(cell[axis] >= 0 && cell[axis] < dims[axis] - 1)) {
+			return; //Outside the grid, so farther than band from the target.
+		}
+		fraction[axis] = gridCoordinate - cell[axis];
+	}
+
+	//The distance at the point is at least the distance at each corner minus how far the corner is from the point,
+	//and at most the distance at the corner plus that. We interpolate these bounds from the eight corners.
+	double interpolated = 0;
+	double spread = 0;
+	bool beyondBand = false;
+	for (int corner = 0; corner < 8; corner++) {
+		int offset[3] = {corner & 1, (corner >> 1) & 1, (corner >> 2) & 1};
+		double weight = 1;
+		osg::Vec3d cornerPosition;
+		for (int axis = 0; axis < 3; axis++) {
+			weight *= offset[axis] ? fraction[axis] : 1 - fraction[axis];
+			cornerPosition[axis] = origin[axis] + voxelSize * (cell[axis] + offset[axis]);
+		}
+		float value = voxel(cell[0] + offset[0], cell[1] + offset[1], cell[2] + offset[2]);
+		beyondBand = beyondBand || value >= band;
+		interpolated += weight * value;
+		spread += weight * (point - cornerPosition).length();
+	}
+	double slack = RELATIVE_SLACK * (band + voxelSize);
+	lower = std::max(lower, interpolated - spread - slack);
+	if (!beyondBand) {
+		upper = interpolated + spread + slack;
+	}
+}
+
+bool DistanceField::segmentIsClear(const osg::Vec3d& start, const osg::Vec3d& end, double radius) const {
+	//Sphere tracing: If the target is at least lower away from a point, nothing within lower - radius of the point along
+	//the segment comes within radius of it, so we may jump that far. We give up once the jumps get short.
+	double length = (end - start).length();
+	osg::Vec3d direction = length > 0 ? (end - start) / length : osg::Vec3d(0, 0, 0);
+	double minStep = 0.5 * voxelSize;
+	double travelled = 0;
+	while (true) {
+		double lower, upper;
+		getDistanceBounds(start + direction * travelled, lower, upper);
+		if (lower <= radius + minStep) {
+			return false;
+		}
+		travelled += lower - radius;
+		if (travelled >= length) {
+			return true;
+		}
+	}
+}
+
+DistanceField* DistanceField::load(const std::string& fileName, const Hash128& sceneKey, double voxelSize, double band) {
+	std::ifstream in(fileName.c_str(), std::ios::binary);
+	char magic[sizeof(FILE_MAGIC)];
+	uint32_t version;
+	if (!in.read(magic, sizeof(magic)) || memcmp(magic, FILE_MAGIC, sizeof(magic)) != 0 || !readValue(in, version)
+			|| version != FILE_FORMAT_VERSION) {
+		return nullptr;
+	}
+	DistanceField field;
+	uint64_t numBricks, numVoxels;
+	if (!readValue(in, field.sceneKey.low) || !readValue(in, field.sceneKey.high) || !readValue(in, field.voxelSize)
+			|| !readValue(in, field.band) || !readVec(in, field.origin) || !readVec(in, field.surfaceMin) || !readVec(in, field.surfaceMax)) {
+		return nullptr;
+	}
+	if (field.sceneKey != sceneKey || field.voxelSize != voxelSize || field.band != band) {
+		return nullptr; //Made for another version of the model, or with other settings.
+	}
+	size_t expectedBricks = 1;
+	for (int axis = 0; axis < 3; axis++) {
+		if (!readValue(in, field.dims[axis]) || !readValue(in, field.brickDims[axis]) || field.dims[axis] < 2
+				|| field.brickDims[axis] != (field.dims[axis] + BRICK_SIZE - 1) / BRICK_SIZE) {
+			return nullptr;
+		}
+		expectedBricks *= field.brickDims[axis];
+	}
+	if (!readValue(in, numBricks) || numBricks != expectedBricks) {
+		return nullptr;
+	}
+	field.brickOffsets.resize(numBricks);
+	if (!in.read(reinterpret_cast<char*>(field.brickOffsets.data()), numBricks * sizeof(int32_t)) || !readValue(in, numVoxels)
+			|| numVoxels % BRICK_VOXELS != 0 || numVoxels > numBricks * BRICK_VOXELS) {
+		return nullptr;
+	}
+	field.voxels.resize(numVoxels);
+	if (!in.read(reinterpret_cast<char*>(field.voxels.data()), numVoxels * sizeof(float))) {
+		return nullptr;
+	}
+	for (size_t brick = 0; brick < numBricks; brick++) {
+		int32_t offset = field.brickOffsets[brick];
+		if (offset != -1 && (offset < 0 || offset % BRICK_VOXELS != 0 || (uint64_t) offset >= numVoxels)) {
+			return nullptr;
+		}
+	}
+	return new DistanceField(field);
+}
+
+bool DistanceField::save(const std::string& fileName) const {
+	//Writing to a file of our own first, so a field is never seen half written, even if several processes make it at once.
+	std::ostringstream temporaryName;
+	temporaryName << fileName << ".tmp" << getpid();
+	{
+		std::ofstream out(temporaryName.str().c_str(), std::ios::binary | std::ios::trunc);
+		out.write(FILE_MAGIC, sizeof(FILE_MAGIC));
+		writeValue(out, FILE_FORMAT_VERSION);
+		writeValue(out, sceneKey.low);
+		writeValue(out, sceneKey.high);
+		writeValue(out, voxelSize);
+		writeValue(out, band);
+		writeVec(out, origin);
+		writeVec(out, surfaceMin);
+		writeVec(out, surfaceMax);
+		for (int axis = 0; axis < 3; axis++) {
+			writeValue(out, dims[axis]);
+			writeValue(out, brickDims[axis]);
+		}
+		writeValue(out, (uint64_t) brickOffsets.size());
+		out.write(reinterpret_cast<const char*>(brickOffsets.data()), brickOffsets.size() * sizeof(int32_t));
+		writeValue(out, (uint64_t) voxels.size());
+		out.write(reinterpret_cast<const char*>(voxels.data()), voxels.size() * sizeof(float));
+		if (!out.flush()) {
+			std::remove(temporaryName.str().c_str());
+			return false;
+		}
+	}
+	if (std::rename(temporaryName.str().c_str(), fileName.c_str()) != 0) {
+		std::remove(temporaryName.str().c_str());
+		return false;
+	}
+	return true;
+}
+
+} /* namespace utility_functions */
@@ -0,0 +1,118 @@
+/*
+ * DistanceField.h
+ *
+ * A sparse voxel grid holding the distance to the inspection target, used to answer most clearance queries
+ * ("is the target within d of this point or edge?") with a few lookups.
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef DISTANCEFIELD_H_
+#define DISTANCEFIELD_H_
+
+#include <osg/Vec3d>
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "Hash128.h"
+
+namespace utility_functions {
+
+class CollisionEngine;
+
+/**
+ * The distance from the corners of a regular voxel grid to the nearest triangle of the scene. Only distances below the
+ * band are stored. The grid is split into bricks of BRICK_SIZE^3 voxels, and bricks that are all farther away than the
+ * band are left out, so the memory used grows with the area of the target rather than with the volume around it.
+ *
+ * Since the distance changes by at most the distance moved, each lookup gives a lower and an upper bound on the true
+ * distance, and queries built on them are never wrong: They either answer for certain, or say they cannot tell.
+ * Our models are open surfaces without an inside, so the distance is unsigned.
+ */
+class DistanceField {
+
+public:
+	static const int BRICK_SIZE = 8;	///<The number of voxels along each side of a brick.
+
+private:
+	Hash128 sceneKey;			///<Identifies the triangles the field was made from. See CollisionEngine::getFingerprint.
+	double voxelSize;
+	double band;				///<Distances are only stored up to this. Voxels farther away hold band.
+	osg::Vec3d origin;			///<The position of voxel (0,0,0).
+	osg::Vec3d surfaceMin;		///<The bounding box of the scene's triangles.
+	osg::Vec3d surfaceMax;
+	int32_t dims[3];			///<The number of voxels along each axis.
+	int32_t brickDims[3];		///<The number of bricks along each axis.
+	std::vector<int32_t> brickOffsets;	///<For each brick, the index of its first voxel in voxels, or -1 if the brick is left out.
+	std::vector<float> voxels;	///<The distances in the stored bricks, brick by brick, each in x, y, z order (x fastest).
+
+	DistanceField();
+
+	///@return The stored distance at the given voxel, or band if its brick is left out.
+	float voxel(int x, int y, int z) const;
+
+	///@return The distance from the point to the bounding box of the triangles. A lower bound on the distance to them.
+	double distanceToSurfaceBounds(const osg::Vec3d& point) const;
+
+public:
+
+	/**
+	 * Makes the field by asking the collision engine for the distance from each voxel near the target.
+	 * @param voxelSize The spacing of the grid. Smaller voxels answer more queries for certain, but take more memory and time to make.
+	 * @param band The largest distance we need to tell apart. Queries about larger distances are passed on to the collision engine.
+	 * @param numThreads The number of threads to make the field with. 0 means one per hardware thread.
+	 */
+	DistanceField(const CollisionEngine& engine, double voxelSize, double band, size_t numThreads = 0);
+
+	/**
+	 * Loads a field stored by save.
+	 * @return The field, or nullptr if the file cannot be read, or holds a field of other triangles or settings.
+	 * The caller owns the returned field.
+	 */
+	static DistanceField* load(const std::string& fileName, const Hash128& sceneKey, double voxelSize, double band);
+
+	/**
+	 * Stores the field, so later runs on the same model can load it instead of making it. The file is replaced in one
+	 * step, so processes loading it at the same time never see half a file.
+	 * @return false if the file could not be written.
+	 */
+	bool save(const std::string& fileName) const;
+
+	/**
+	 * Bounds the distance from the point to the nearest triangle, from the trilinear interpolation of the surrounding voxels.
+	 * Beyond the band, or outside the grid, only the lower bound is known: About the band, or the distance to the
+	 * target's bounding box if that is larger.
+	 * @param[out] upper Set to infinity if the distance may be beyond the band.
+	 */
+	void getDistanceBounds(const osg::Vec3d& point, double& lower, double& upper) const;
+
+	/**
+	 * Marches along the segment, checking that no triangle comes within radius of it. Takes long steps where the target is far away.
+	 * @return true if no triangle is within radius of any point on the segment. false if one may be.
+	 */
+	bool segmentIsClear(const osg::Vec3d& start, const osg::Vec3d& end, double radius) const;
+
+	double getVoxelSize() const {
+		return voxelSize;
+	}
+
+	double getBand() const {
+		return band;
+	}
+
+	///@return The number of bricks holding distances, out of all bricks in the grid.
+	size_t getNumStoredBricks() const {
+		return voxels.size() / (BRICK_SIZE * BRICK_SIZE * BRICK_SIZE);
+	}
+
+	///@return The memory used by the field, in bytes.
+	size_t estimateBytes() const {
+		return brickOffsets.size() * sizeof(int32_t) + voxels.size() * sizeof(float);
+	}
+};
+
+} /* namespace utility_functions */
+
+#endif /* DISTANCEFIELD_H_ */
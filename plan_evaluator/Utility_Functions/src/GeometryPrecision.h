@@ -0,0 +1,34 @@
+/*
+ * GeometryPrecision.h
+ *
+ * The precision the scene's triangles are stored in by the collision engine and the triangle store.
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef GEOMETRYPRECISION_H_
+#define GEOMETRYPRECISION_H_
+
+#include <osg/Vec3d>
+#include <osg/Vec3f>
+
+namespace utility_functions {
+
+/**
+ * Double by default. Building with FLOAT_GEOMETRY defined (cmake -DFLOAT_GEOMETRY=ON) stores the triangles in single
+ * precision instead, which halves the memory the collision tests stream through. The models are read from float
+ * vertices, so for scenes without transforms the stored triangles are the same either way. The tests themselves, and
+ * all sums such as areas and coverage, are still computed in double.
+ * Compare the two builds over the bundled models with the precisionCheck program.
+ */
+#ifdef FLOAT_GEOMETRY
+typedef float GeometryReal;
+typedef osg::Vec3f GeometryVec3;
+#else
+typedef double GeometryReal;
+typedef osg::Vec3d GeometryVec3;
+#endif
+
+} /* namespace utility_functions */
+
+#endif /* GEOMETRYPRECISION_H_ */
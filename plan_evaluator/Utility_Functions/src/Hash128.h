@@ -0,0 +1,136 @@
+/*
+ * Hash128.h
+ *
+ * A small, fast 128-bit hash (the MurmurHash3 x64_128 construction). Used wherever we need keys that are
+ * practically collision-free, but are still compact and of fixed size - for instance when edges are stored in
+ * shared memory, where we cannot store variable-length strings.
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef HASH128_H_
+#define HASH128_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <cstring>
+#include <string>
+
+namespace utility_functions {
+
+///A 128-bit hash value.
+struct Hash128 {
+	uint64_t low;
+	uint64_t high;
+
+	bool operator==(const Hash128& other) const {
+		return low == other.low && high == other.high;
+	}
+	bool operator!=(const Hash128& other) const {
+		return !(*this == other);
+	}
+	bool operator<(const Hash128& other) const {
+		return high < other.high || (high == other.high && low < other.low);
+	}
+};
+
+namespace hash128_detail {
+	inline uint64_t rotl64(uint64_t x, int8_t r) {
+		return (x << r) | (x >> (64 - r));
+	}
+
+	inline uint64_t fmix64(uint64_t k) {
+		k ^= k >> 33;
+		k *= 0xff51afd7ed558ccdULL;
+		k ^= k >> 33;
+		k *= 0xc4ceb9fe1a85ec53ULL;
+		k ^= k >> 33;
+		return k;
+	}
+
+	const uint64_t c1 = 0x87c37b91114253d5ULL;
+	const uint64_t c2 = 0x4cf5ad432745937fULL;
+}
+
+/**
+ * Incremental version of the hash, fed with 64-bit words. This lets us hash data that is not stored contiguously
+ * (such as the blocks of a boost::dynamic_bitset) without first copying it into a temporary buffer.
+ */
+class Hash128Builder {
+private:
+	uint64_t h1, h2;
+	uint64_t pendingWord;	///<The first half of a 128-bit chunk, waiting for its second half.
+	bool hasPendingWord;
+	uint64_t numBytes;
+
+	void mixChunk(uint64_t k1, uint64_t k2) {
+		using namespace hash128_detail;
+		k1 *= c1; k1 = rotl64(k1, 31); k1 *= c2; h1 ^= k1;
+		h1 = rotl64(h1, 27); h1 += h2; h1 = h1 * 5 + 0x52dce729;
+		k2 *= c2; k2 = rotl64(k2, 33); k2 *= c1; h2 ^= k2;
+		h2 = rotl64(h2, 31); h2 += h1; h2 = h2 * 5 + 0x38495ab5;
+	}
+
+public:
+	explicit Hash128Builder(uint64_t seed = 0)
+	:h1(seed), h2(seed), pendingWord(0), hasPendingWord(false), numBytes(0){}
+
+	void addWord(uint64_t word) {
+		numBytes += 8;
+		if (hasPendingWord) {
+			mixChunk(pendingWord, word);
+			hasPendingWord = false;
+		} else {
+			pendingWord = word;
+			hasPendingWord = true;
+		}
+	}
+
+	void addBytes(const void* data, size_t len) {
+		const unsigned char* bytes = static_cast<const unsigned char*>(data);
+		size_t i = 0;
+		for (; i + 8 <= len; i += 8) {
+			uint64_t word;
+			std::memcpy(&word, bytes + i, 8);
+			addWord(word);
+		}
+		if (i < len) {
+			//The tail is zero-padded. The length is mixed in at the end, so padding cannot cause collisions between lengths.
+			uint64_t word = 0;
+			std::memcpy(&word, bytes + i, len - i);
+			addWord(word);
+			numBytes -= 8 - (len - i);
+		}
+	}
+
+	Hash128 finish() const {
+		using namespace hash128_detail;
+		uint64_t f1 = h1, f2 = h2;
+		if (hasPendingWord) {
+			uint64_t k1 = pendingWord;
+			k1 *= c1; k1 = rotl64(k1, 31); k1 *= c2; f1 ^= k1;
+		}
+		f1 ^= numBytes; f2 ^= numBytes;
+		f1 += f2; f2 += f1;
+		f1 = fmix64(f1); f2 = fmix64(f2);
+		f1 += f2; f2 += f1;
+		Hash128 result;
+		result.low = f1;
+		result.high = f2;
+		return result;
+	}
+};
+
+inline Hash128 hash128(const void* data, size_t len, uint64_t seed = 0) {
+	Hash128Builder builder(seed);
+	builder.addBytes(data, len);
+	return builder.finish();
+}
+
+inline Hash128 hash128(const std::string& s, uint64_t seed = 0) {
+	return hash128(s.data(), s.size(), seed);
+}
+
+} /* namespace utility_functions */
+
+#endif /* HASH128_H_ */
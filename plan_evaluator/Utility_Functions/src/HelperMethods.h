@@ -66,17 +66,7 @@ namespace std {
 	template<typename... T>
 	struct hash<map<T...>> : hash_container<map<T...>> {
 };
-
-//Hash for dynamic-bitset.
-template<typename B, typename A>
-struct hash<boost::dynamic_bitset<B, A> > {
-	size_t operator()(const boost::dynamic_bitset<B, A> &bs) {
-		//Slightly inefficient hashing method, but unfortunately, dynamic_bitset does not offer a nice alternative.
-		std::vector<B, A> v;
-		boost::to_block_range(bs, std::back_inserter(v));
-		return boost::hash_range(v.begin(), v.end());
-	}
-};
+//Bitsets are hashed with utility_functions::hashCoverage (CoveragePatternPool.h), which hashes the blocks in place.
 }
 
 #define SSTR( x ) dynamic_cast< std::ostringstream & >( \
@@ -0,0 +1,127 @@
+/*
+ * NumaTopology.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include "NumaTopology.h"
+
+#include <boost/filesystem.hpp>
+#include <fstream>
+#include <map>
+#include <pthread.h>
+#include <sched.h>
+#include <stdexcept>
+
+#include "HelperMethods.h"
+
+namespace utility_functions {
+
+namespace {
+	const char* NODE_DIRECTORY = "/sys/devices/system/node";
+
+	///@return The CPUs the process may run on.
+	std::vector<int> getAllowedCpus() {
+		std::vector<int> cpus;
+		cpu_set_t allowed;
+		CPU_ZERO(&allowed);
+		if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+			return cpus;
+		}
+		for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+			if (CPU_ISSET(cpu, &allowed)) {
+				cpus.push_back(cpu);
+			}
+		}
+		return cpus;
+	}
+}
+
+NumaTopology::NumaTopology() {
+	std::vector<int> allowedCpus = getAllowedCpus();
+	std::vector<char> isAllowed(CPU_SETSIZE, false);
+	for (size_t i = 0; i < allowedCpus.size(); i++) {
+		isAllowed[allowedCpus[i]] = true;
+	}
+
+	//Indexed by node number, so the nodes come out in order even though the directory listing is unordered.
+	std::map<int, std::vector<int> > cpusByNode;
+	boost::system::error_code error;
+	for (boost::filesystem::directory_iterator entry(NODE_DIRECTORY, error), end; !error && entry != end; entry.increment(error)) {
+		std::string name = entry->path().filename().string();
+		if (name.compare(0, 4, "node") != 0 || name.size() == 4 || name.find_first_not_of("0123456789", 4) != std::string::npos) {
+			continue;
+		}
+		std::ifstream cpuListFile((entry->path() / "cpulist").string().c_str());
+		std::string cpuList;
+		if (!std::getline(cpuListFile, cpuList)) {
+			continue;
+		}
+		std::vector<int> usableCpus;
+		try {
+			std::vector<int> cpus = parseCpuList(cpuList);
+			for (size_t i = 0; i < cpus.size(); i++) {
+				if (cpus[i] >= 0 && cpus[i] < CPU_SETSIZE && isAllowed[cpus[i]]) {
+					usableCpus.push_back(cpus[i]);
+				}
+			}
+		} catch (const std::invalid_argument&) {
+			continue;
+		}
+		if (!usableCpus.empty()) { //Memory-only nodes have no CPUs to run on.
+			cpusByNode[std::stoi(name.substr(4))] = usableCpus;
+		}
+	}
+	for (std::map<int, std::vector<int> >::const_iterator node = cpusByNode.begin(); node != cpusByNode.end(); node++) {
+		nodeCpus.push_back(node->second);
+	}
+	if (nodeCpus.empty()) {
+		nodeCpus.push_back(allowedCpus);
+	}
+}
+
+size_t NumaTopology::numCpus() const {
+	size_t numCpus = 0;
+	for (size_t node = 0; node < nodeCpus.size(); node++) {
+		numCpus += nodeCpus[node].size();
+	}
+	return numCpus;
+}
+
+std::vector<int> NumaTopology::parseCpuList(const std::string& cpuList) {
+	std::vector<int> cpus;
+	std::vector<std::string> ranges = splitString(cpuList, ',');
+	for (size_t i = 0; i < ranges.size(); i++) {
+		const std::string& range = ranges[i];
+		size_t dash = range.find('-');
+		try {
+			int first = std::stoi(range.substr(0, dash));
+			int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+			if (last < first) {
+				throw std::invalid_argument("Empty range");
+			}
+			for (int cpu = first; cpu <= last; cpu++) {
+				cpus.push_back(cpu);
+			}
+		} catch (const std::logic_error&) { //stoi throws invalid_argument or out_of_range.
+			throw std::invalid_argument("ERROR! Malformed CPU list: " + cpuList);
+		}
+	}
+	return cpus;
+}
+
+bool NumaTopology::pinCurrentThread(const std::vector<int>& cpus) {
+	cpu_set_t cpuSet;
+	CPU_ZERO(&cpuSet);
+	for (size_t i = 0; i < cpus.size(); i++) {
+		if (cpus[i] >= 0 && cpus[i] < CPU_SETSIZE) {
+			CPU_SET(cpus[i], &cpuSet);
+		}
+	}
+	if (CPU_COUNT(&cpuSet) == 0) {
+		return false;
+	}
+	return pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet) == 0;
+}
+
+} /* namespace utility_functions */
@@ -0,0 +1,63 @@
+/*
+ * NumaTopology.h
+ *
+ * The NUMA nodes (sockets, on our machines) of the host, and the CPUs belonging to each. Used to keep evaluator
+ * threads and the data they read on the same node.
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef NUMATOPOLOGY_H_
+#define NUMATOPOLOGY_H_
+
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+namespace utility_functions {
+
+/**
+ * Reads the NUMA layout of the host from /sys/devices/system/node, so we do not depend on libnuma.
+ * Only CPUs the process may run on (see sched_getaffinity) are included, so a process started with taskset or in a
+ * restricted cgroup only sees the nodes it can use. Hosts without NUMA information look like a single node.
+ */
+class NumaTopology {
+
+private:
+	std::vector<std::vector<int> > nodeCpus;	///<The usable CPUs of each node. Nodes without usable CPUs are left out.
+
+public:
+
+	///Detects the topology of the host.
+	NumaTopology();
+
+	///@return The number of nodes with CPUs we may use. At least 1.
+	size_t numNodes() const {
+		return nodeCpus.size();
+	}
+
+	///@return The CPUs of the given node, in increasing order.
+	const std::vector<int>& getCpus(size_t node) const {
+		return nodeCpus[node];
+	}
+
+	///@return The number of CPUs on all nodes.
+	size_t numCpus() const;
+
+	/**
+	 * Parses a CPU list as written by the kernel, such as "0-3,8,10-11".
+	 * @throws std::invalid_argument if the list is malformed.
+	 */
+	static std::vector<int> parseCpuList(const std::string& cpuList);
+
+	/**
+	 * Restricts the calling thread to the given CPUs. Memory the thread allocates and touches first afterwards is then
+	 * placed on their node by the kernel.
+	 * @return false if the CPUs could not be set, in which case the thread keeps running where it did.
+	 */
+	static bool pinCurrentThread(const std::vector<int>& cpus);
+};
+
+} /* namespace utility_functions */
+
+#endif /* NUMATOPOLOGY_H_ */
@@ -8,6 +8,7 @@
 #include "OsgHelpers.h"
 
 #include <assert.h>
+#include <stdexcept>
 #include <osg/ComputeBoundsVisitor>
 #include <osg/Geometry>
 #include <osg/LineWidth>
@@ -19,7 +20,10 @@
 #include <osg/LightModel>
 #include <osgGA/OrbitManipulator>
 
+#include "AnyHitPolytopeIntersector.h"
+#include "CollisionEngine.h"
 #include "Constants.h"
+#include "GeodeFinder.h"
 #include "CameraEstimator.h"
 #include "HelperMethods.h"
 #include "SceneKeeper.h"
@@ -156,7 +160,14 @@ double calculateEnergyUsageOneMove(const osg::Vec3d &start, const osg::Vec3d &en
 		return energyUsage;
 	}
 	// Energy calculation including collision checks.
-	if(edgeComesTooCloseToStructure(start,end,*potential_colliders)){
+	if(GRADED_COLLISION_PENALTY){
+		//Nothing beyond the buffer matters, so the search may skip all parts of the structure farther away.
+		double clearance = edgeClearanceFromStructure(start,end,*potential_colliders,EDGE_SAFETY_BUFFER);
+		if(clearance<EDGE_SAFETY_BUFFER){
+			energyUsage += collision_penalty*(1.0-0.5*clearance/EDGE_SAFETY_BUFFER);
+		}
+	}
+	else if(edgeComesTooCloseToStructure(start,end,*potential_colliders)){
 		energyUsage += collision_penalty;
 	}
 	return energyUsage;
@@ -244,7 +255,16 @@ osg::Polytope generatePolytopeFromPlanEdge(const osg::Vec3d& edgeStart, const os
 }
 
 bool edgeComesTooCloseToStructure(const osg::Vec3d& edgeStart, const osg::Vec3d& edgeEnd, osg::Node& structure, const osg::ref_ptr<osg::Geode> g/*=nullptr*/){
+	//Scenes loaded by a SceneKeeper carry a collision engine, which answers without traversing the scene graph.
+	//When plotting, we still use the intersector, as it tells us where the collision is.
+	const CollisionEngine* collisionEngine = CollisionEngine::getAttached(structure);
+	if(collisionEngine!=nullptr && g==nullptr){
+		return collisionEngine->edgeComesTooClose(edgeStart, edgeEnd, EDGE_SAFETY_BUFFER);
+	}
 	osg::Polytope edgeWithBuffer = generatePolytopeFromPlanEdge(edgeStart, edgeEnd,g); //A box representing the edge with safety margin.
+	if(g==nullptr){
+		return checkPolytopeForIntersections(edgeWithBuffer, structure);
+	}
 
 	osgUtil::PolytopeIntersector* polytopeIntersector = new osgUtil::PolytopeIntersector(edgeWithBuffer);
 	osgUtil::IntersectionVisitor intersectVisitor( polytopeIntersector);
@@ -320,18 +340,35 @@ osg::Polytope generateBoxPolytope(const osg::Vec3d& center, double side_length){
 
 //Checks the given polytope for intersections with the given scene.
 bool checkPolytopeForIntersections(const osg::Polytope& polytope, osg::Node& scene){
-	osgUtil::PolytopeIntersector* polytopeIntersector = new osgUtil::PolytopeIntersector(polytope);
-	osgUtil::IntersectionVisitor intersectVisitor( polytopeIntersector);
-	scene.accept(intersectVisitor);
-	if(polytopeIntersector->containsIntersections()){
-		return true;
+	//We only need to know if there is a hit, so the traversal stops at the first one.
+	return PolytopeHitTester::forCurrentThread().intersects(polytope, scene);
+}
+
+void prepareSceneForConcurrentIntersections(osg::Node& scene){
+	GeodeFinder geodeFinder;
+	scene.accept(geodeFinder);
+	std::vector<osg::Geode*> allGeodes = geodeFinder.getNodeList();
+	for(std::vector<osg::Geode*>::iterator geode = allGeodes.begin(); geode != allGeodes.end(); geode++){
+		for(unsigned int i = 0; i < (*geode)->getNumDrawables(); i++){
+			(*geode)->getDrawable(i)->getBound();
+		}
 	}
-	else{
-		return false;
+	scene.getBound(); //Computes the bounds of all groups on the way down to the geodes.
+}
+
+double edgeClearanceFromStructure(const osg::Vec3d& edgeStart, const osg::Vec3d& edgeEnd, const osg::Node& structure, double maxDistance){
+	const CollisionEngine* collisionEngine = CollisionEngine::getAttached(structure);
+	if(collisionEngine==nullptr){
+		throw std::invalid_argument("Edge clearances need a CollisionEngine attached to the structure. Load it with a SceneKeeper.");
 	}
+	return collisionEngine->edgeClearance(edgeStart, edgeEnd, maxDistance);
 }
 
 bool collisionCheckWithBuffer(const osg::Vec3d& point, osg::Node& structure, double bufferRadius){
+	const CollisionEngine* collisionEngine = CollisionEngine::getAttached(structure);
+	if(collisionEngine!=nullptr){
+		return collisionEngine->pointComesTooClose(point, bufferRadius);
+	}
 	osg::Polytope distanceBox = generateBoxPolytope(point,bufferRadius);
 	return checkPolytopeForIntersections(distanceBox,structure);
 
@@ -50,7 +50,7 @@ namespace utility_functions {
  * @param start The coordinate of the start position
  * @param end The coordinate of the end position
  * @param potential_colliders (optional) An OSG node containing any 3D structures the plan may collide with (typically the inspection target).
- * @param collision_penalty (optional) The penalty for colliding with any object in potential_colliders.
+ * @param collision_penalty (optional) The penalty for colliding with any object in potential_colliders. See GRADED_COLLISION_PENALTY.
  * @param previousPoint The point we visited BEFORE start. If this is given, we add to the translation energy the rotation energy that needs to be applied in start
  * in order to change the vehicle's direction to go towards end.
  * @return A number representing the energy usage
@@ -66,6 +66,7 @@ namespace utility_functions {
  * This is a simplified collision check for edges. We want to avoid a real collision check, for performance reasons, and since we only need a rough estimate
  * at this point: Actual collision detection and avoidance will of course be carried out by other parts of the AUV.
  * The method checks if an edge in the plan comes too close to the structure, by testing if any parts of the structure are inside a box surrounding the edge.
+ * If the structure has a CollisionEngine attached (SceneKeeper does this), it answers the test, without traversing the scene graph.
  * @param edgeStart The starting coordinate of the edge
  * @param edgeEnd The end coordinate of the edge
  * @param structure The inspection target
@@ -74,9 +75,24 @@ namespace utility_functions {
  */
 bool edgeComesTooCloseToStructure(const osg::Vec3d& edgeStart, const osg::Vec3d& edgeEnd, osg::Node& structure, const osg::ref_ptr<osg::Geode> g=nullptr);
 
+/**
+ * Generates the box-shaped safety volume around a plan edge, which edgeComesTooCloseToStructure checks for intersections.
+ * @param g Optional. If given, the corners of the volume are plotted to it.
+ */
+osg::Polytope generatePolytopeFromPlanEdge(const osg::Vec3d& edgeStart, const osg::Vec3d& edgeEnd, osg::ref_ptr<osg::Geode> g = nullptr);
+
+/**
+ * Finds the distance from an edge to the nearest part of the structure, which unlike edgeComesTooCloseToStructure does not
+ * depend on the direction of the edge. Needs the CollisionEngine attached to the structure by SceneKeeper.
+ * @param maxDistance The search stops looking at parts of the structure farther away than this.
+ * @return The distance, or maxDistance if nothing is closer.
+ */
+double edgeClearanceFromStructure(const osg::Vec3d& edgeStart, const osg::Vec3d& edgeEnd, const osg::Node& structure, double maxDistance);
+
 /**
  * Checks if a given xyz-position is in collision with the inspection target. A buffer can be given, if we want to check if we are no
  * closer than N meters from the target.
+ * Like edgeComesTooCloseToStructure, uses the structure's CollisionEngine if it has one.
  * @param point The point we want to check for collision
  * @param structure The structure we want to check for collisions with
  * @param bufferRadius The closest we can be to the target without being in collision.
@@ -103,13 +119,22 @@ osg::Plane getPlane(const osg::Vec3d&  point1, const osg::Vec3d&  point2, const
 osg::Polytope generateBoxPolytope(const osg::Vec3d& center, double half_side_length);
 
 /**
- * Checks the given polytope for intersections with the given scene.
+ * Checks the given polytope for intersections with the given scene. Stops at the first intersection found, using the
+ * calling thread's PolytopeHitTester.
  * @param polytope A volume we want to check for intersections
  * @param scene The scene we want to check if intersects with our volume
  * @return True if there is an intersection, false otherwise.
  */
 bool checkPolytopeForIntersections(const osg::Polytope& polytope, osg::Node& scene);
 
+/**
+ * Computes the bounding volumes of all nodes and drawables in the scene. OSG otherwise computes and stores them during
+ * the first traversal that needs them, so this has to be called before several threads run intersection tests on the
+ * same scene at once. After that, checkPolytopeForIntersections only reads the scene, and is safe to call concurrently.
+ * @param scene The scene we will run concurrent intersection tests on.
+ */
+void prepareSceneForConcurrentIntersections(osg::Node& scene);
+
 /*
  * Draws a single viewpoint as a large sphere (the point) with a smaller sphere pointing in the viewing direction.
  */
@@ -0,0 +1,163 @@
+/*
+ * SceneCache.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include "SceneCache.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <sstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace utility_functions {
+
+namespace {
+	const char FILE_MAGIC[8] = {'I', 'P', 'P', 'S', 'C', 'N', 'C', '\0'};
+	///Raised whenever the sections, or what is stored in them, change.
+	const uint32_t FILE_FORMAT_VERSION = 2;
+	///Sections start on a cache line, so arrays of any of our types are aligned in the mapping.
+	const uint64_t SECTION_ALIGNMENT = 64;
+
+	struct FileHeader {
+		char magic[8];
+		uint32_t version;
+		uint32_t numSections;
+		uint64_t keyLow;
+		uint64_t keyHigh;
+	};
+
+	///Maps the whole file read-only. @return nullptr if it cannot be mapped, or is empty.
+	void* mapFile(const std::string& fileName, size_t& bytes) {
+		int fd = ::open(fileName.c_str(), O_RDONLY);
+		if (fd < 0) {
+			return nullptr;
+		}
+		struct stat status;
+		void* mapping = nullptr;
+		if (fstat(fd, &status) == 0 && status.st_size > 0) {
+			bytes = status.st_size;
+			mapping = mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+			if (mapping == MAP_FAILED) {
+				mapping = nullptr;
+			}
+		}
+		close(fd); //The mapping stays valid after the file is closed.
+		return mapping;
+	}
+}
+
+SceneCache::SceneCache(void* mapping, size_t mappedBytes)
+:mapping(mapping),
+ mappedBytes(mappedBytes){
+}
+
+SceneCache::~SceneCache() {
+	munmap(mapping, mappedBytes);
+}
+
+SceneCache* SceneCache::open(const std::string& fileName, const Hash128& modelKey) {
+	size_t bytes = 0;
+	void* mapping = mapFile(fileName, bytes);
+	if (mapping == nullptr) {
+		return nullptr;
+	}
+	SceneCache* cache = new SceneCache(mapping, bytes);
+	FileHeader header;
+	if (bytes < sizeof(header)) {
+		delete cache;
+		return nullptr;
+	}
+	memcpy(&header, mapping, sizeof(header));
+	if (memcmp(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0 || header.version != FILE_FORMAT_VERSION
+			|| header.keyLow != modelKey.low || header.keyHigh != modelKey.high
+			|| header.numSections > (bytes - sizeof(header)) / sizeof(SectionEntry)) {
+		delete cache; //Made from another version of the model, or by another version of the program.
+		return nullptr;
+	}
+	cache->table.resize(header.numSections);
+	memcpy(cache->table.data(), static_cast<const char*>(mapping) + sizeof(header), header.numSections * sizeof(SectionEntry));
+	for (size_t s = 0; s < cache->table.size(); s++) {
+		const SectionEntry& entry = cache->table[s];
+		if (entry.offset % SECTION_ALIGNMENT != 0 || entry.offset > bytes || entry.bytes > bytes - entry.offset) {
+			delete cache;
+			return nullptr;
+		}
+	}
+	return cache;
+}
+
+bool SceneCache::findSection(SectionId id, const char*& bytes, size_t& numBytes) const {
+	for (size_t s = 0; s < table.size(); s++) {
+		if (table[s].id == (uint32_t) id) {
+			bytes = static_cast<const char*>(mapping) + table[s].offset;
+			numBytes = table[s].bytes;
+			return true;
+		}
+	}
+	return false;
+}
+
+bool SceneCache::hashFile(const std::string& fileName, Hash128& hash) {
+	size_t bytes = 0;
+	void* mapping = mapFile(fileName, bytes);
+	if (mapping == nullptr) {
+		return false;
+	}
+	hash = hash128(mapping, bytes);
+	munmap(mapping, bytes);
+	return true;
+}
+
+bool SceneCache::Writer::write(const std::string& fileName, const Hash128& modelKey) const {
+	FileHeader header;
+	memcpy(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC));
+	header.version = FILE_FORMAT_VERSION;
+	header.numSections = sections.size();
+	header.keyLow = modelKey.low;
+	header.keyHigh = modelKey.high;
+
+	//The table comes right after the header, and the sections after the table.
+	std::vector<SectionEntry> table(sections.size());
+	uint64_t offset = sizeof(header) + sections.size() * sizeof(SectionEntry);
+	for (size_t s = 0; s < sections.size(); s++) {
+		offset = (offset + SECTION_ALIGNMENT - 1) / SECTION_ALIGNMENT * SECTION_ALIGNMENT;
+		table[s].id = sections[s].id;
+		table[s].reserved = 0;
+		table[s].offset = offset;
+		table[s].bytes = sections[s].bytes;
+		offset += sections[s].bytes;
+	}
+
+	//Writing to a file of our own first, so a cache is never seen half written, even if several processes make it at once.
+	std::ostringstream temporaryName;
+	temporaryName << fileName << ".tmp" << getpid();
+	{
+		std::ofstream out(temporaryName.str().c_str(), std::ios::binary | std::ios::trunc);
+		out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		out.write(reinterpret_cast<const char*>(table.data()), table.size() * sizeof(SectionEntry));
+		uint64_t written = sizeof(header) + table.size() * sizeof(SectionEntry);
+		const char padding[SECTION_ALIGNMENT] = {0};
+		for (size_t s = 0; s < sections.size(); s++) {
+			out.write(padding, table[s].offset - written);
+			out.write(static_cast<const char*>(sections[s].data), sections[s].bytes);
+			written = table[s].offset + sections[s].bytes;
+		}
+		if (!out.flush()) {
+			std::remove(temporaryName.str().c_str());
+			return false;
+		}
+	}
+	if (std::rename(temporaryName.str().c_str(), fileName.c_str()) != 0) {
+		std::remove(temporaryName.str().c_str());
+		return false;
+	}
+	return true;
+}
+
+} /* namespace utility_functions */
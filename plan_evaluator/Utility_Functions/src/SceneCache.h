@@ -0,0 +1,131 @@
+/*
+ * SceneCache.h
+ *
+ * A binary file holding what SceneKeeper computes from a 3D model before plans can be evaluated, so later runs on the
+ * same model can map it into memory instead of parsing and preprocessing the model again.
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef SCENECACHE_H_
+#define SCENECACHE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "Hash128.h"
+
+namespace utility_functions {
+
+/**
+ * The file is a table of sections, each holding one array of plain values, and is keyed by a hash of the model file's
+ * contents. Opening a cache maps the file read-only, and hands out pointers to the arrays in the mapping, which stay
+ * valid as long as the cache does.
+ * Each part of the preprocessing stores and reads its own sections (see TriangleData and CollisionEngine).
+ */
+class SceneCache {
+
+public:
+	enum SectionId {
+		SCENE_BOUNDS = 1,			///<SceneKeeper's bounding box and scene center.
+		TRIANGLE_VERTEX_X,
+		TRIANGLE_VERTEX_Y,
+		TRIANGLE_VERTEX_Z,
+		TRIANGLE_VERTICES,
+		TRIANGLE_AREAS,
+		TRIANGLE_CENTER_X,
+		TRIANGLE_CENTER_Y,
+		TRIANGLE_CENTER_Z,
+		COLORED_VERTICES,			///<The vertices and colors of the geode made by colorEachTriangleDifferently.
+		COLORED_COLORS,
+		COLLISION_TRIANGLES,
+		COLLISION_NODES
+	};
+
+	/**
+	 * Collects the sections of a new cache, and writes them. Only the pointers to the arrays are kept, so they must stay
+	 * valid until write is called.
+	 */
+	class Writer {
+	private:
+		struct Section {
+			uint32_t id;
+			const void* data;
+			uint64_t bytes;
+		};
+		std::vector<Section> sections;
+
+	public:
+		template<typename T>
+		void add(SectionId id, const T* data, size_t count) {
+			Section section = {(uint32_t) id, data, count * sizeof(T)};
+			sections.push_back(section);
+		}
+
+		/**
+		 * Writes the sections to the file. The file is replaced in one step, so processes opening it at the same time
+		 * never see half a cache.
+		 * @param modelKey The hash of the model the sections were made from (see hashFile).
+		 * @return false if the file could not be written.
+		 */
+		bool write(const std::string& fileName, const Hash128& modelKey) const;
+	};
+
+	/**
+	 * Maps a cache written by Writer.
+	 * @return The cache, or nullptr if the file cannot be read, is damaged, or was made from another model or by another
+	 * version of the program. The caller owns the returned cache.
+	 */
+	static SceneCache* open(const std::string& fileName, const Hash128& modelKey);
+
+	/**
+	 * Hashes the contents of a file, such as the model a cache is made from.
+	 * @return false if the file could not be read.
+	 */
+	static bool hashFile(const std::string& fileName, Hash128& hash);
+
+	/**
+	 * Finds the array stored in a section.
+	 * @param[out] data Points into the mapped file.
+	 * @param[out] count The number of values in the array.
+	 * @return false if the cache has no such section, or it does not hold values of type T.
+	 */
+	template<typename T>
+	bool get(SectionId id, const T*& data, size_t& count) const {
+		const char* bytes;
+		size_t numBytes;
+		if (!findSection(id, bytes, numBytes) || numBytes % sizeof(T) != 0) {
+			return false;
+		}
+		data = reinterpret_cast<const T*>(bytes);
+		count = numBytes / sizeof(T);
+		return true;
+	}
+
+	~SceneCache();
+
+private:
+	struct SectionEntry {
+		uint32_t id;
+		uint32_t reserved;
+		uint64_t offset;	///<From the start of the file. A multiple of SECTION_ALIGNMENT.
+		uint64_t bytes;
+	};
+
+	void* mapping;
+	size_t mappedBytes;
+	std::vector<SectionEntry> table;
+
+	SceneCache(void* mapping, size_t mappedBytes);
+
+	SceneCache(const SceneCache&) = delete;
+	SceneCache& operator=(const SceneCache&) = delete;
+
+	bool findSection(SectionId id, const char*& bytes, size_t& numBytes) const;
+};
+
+} /* namespace utility_functions */
+
+#endif /* SCENECACHE_H_ */
@@ -7,6 +7,10 @@
 
 #include "SceneKeeper.h"
 
+#include <algorithm>
+#include <cmath>
+#include <osg/KdTree>
+#include <osgDB/Registry>
 #include <osgUtil/LineSegmentIntersector>
 #include <osgUtil/Optimizer>
 
@@ -32,6 +36,14 @@ void SceneKeeper::storeTriangles(osg::Geometry& drawable)
 
 
 void SceneKeeper::countTriangles(){
+	if(sceneCache){
+		//The constructor has read everything else from the cache. The distance field has its own cache file.
+		if(CollisionEngine::getAttached(*scene) == nullptr){
+			CollisionEngine::attachTo(*scene, cachedCollisionEngine.get(), loaded_scene_name + ".sdf");
+		}
+		return;
+	}
+
 	//First, finding the geode(s) from the scene.
 	GeodeFinder geodeFinder;
 	scene->accept(geodeFinder);
@@ -49,20 +61,49 @@ void SceneKeeper::countTriangles(){
 
 		   //Storing all triangles
 		   this->storeTriangles(*geometry);
-		   triangleStore.calculateTotalArea();
 
 	   }
 	}
+	//Once all drawables are stored, so vertices shared between drawables are stored once.
+	triangleStore.calculateTotalArea();
+	//Made after the optimizer above is done with the geometry, so it sees the triangles as they will be.
+	CollisionEngine::attachTo(*scene, loaded_scene_name + ".sdf");
+
+	if(cacheable){
+		writeCache();
+	}
 }
 
 osg::ref_ptr<osg::Geode> SceneKeeper::colorEachTriangleDifferently(){
 	if (triangleStore.getTriangleCount() == 0){
 		countTriangles();
 	}
+	if(sceneCache){
+		//Copying the arrays out of the cache, as the geode may be changed.
+		const osg::Vec3* vertices;
+		const osg::Vec3* colors;
+		size_t numVertices, numColors;
+		sceneCache->get(SceneCache::COLORED_VERTICES, vertices, numVertices);
+		sceneCache->get(SceneCache::COLORED_COLORS, colors, numColors);
+		return TriangleData::makeColoredGeode(new osg::Vec3Array(numVertices, vertices), new osg::Vec3Array(numColors, colors));
+	}
 	return triangleStore.colorEachTriangleDifferently();
 }
 
 SceneKeeper::SceneKeeper(const std::string& fileName){
+	Hash128 fileHash;
+	cacheable = USE_SCENE_CACHE && SceneCache::hashFile(fileName, fileHash);
+	//Builds storing the geometry in another precision (see GeometryPrecision.h) cannot read each other's caches.
+	Hash128Builder keyBuilder;
+	keyBuilder.addWord(fileHash.low);
+	keyBuilder.addWord(fileHash.high);
+	keyBuilder.addWord(sizeof(GeometryReal));
+	modelKey = keyBuilder.finish();
+	if(cacheable && loadFromCache(fileName)){
+		std::cout << "Loaded the preprocessed scene from " << fileName << ".scenecache" << std::endl;
+		return;
+	}
+
 	scene = LoadScene(fileName);
 	collisionPenalty = COLLISION_PENALTY_MODIFIER*calcLongestSceneSide(scene);
 
@@ -85,6 +126,72 @@ osg::ref_ptr<osg::Node> SceneKeeper::LoadScene(const std::string& fileName){
 	return scene;
 }
 
+bool SceneKeeper::loadFromCache(const std::string& fileName){
+	std::unique_ptr<SceneCache> cache(SceneCache::open(fileName + ".scenecache", modelKey));
+	if(!cache){
+		return false;
+	}
+	const double* bounds;
+	const double* triangleAreas;
+	const osg::Vec3* coloredVertices;
+	const osg::Vec3* coloredColors;
+	size_t numBounds, numTriangles, numColoredVertices, numColoredColors;
+	if(!cache->get(SceneCache::SCENE_BOUNDS, bounds, numBounds) || numBounds != 9
+			|| !cache->get(SceneCache::TRIANGLE_AREAS, triangleAreas, numTriangles)
+			|| !cache->get(SceneCache::COLORED_VERTICES, coloredVertices, numColoredVertices) || numColoredVertices != 3*numTriangles
+			|| !cache->get(SceneCache::COLORED_COLORS, coloredColors, numColoredColors) || numColoredColors != numColoredVertices){
+		return false;
+	}
+	osg::ref_ptr<CollisionEngine> engine = CollisionEngine::readFrom(*cache);
+	if(!engine || !triangleStore.readFrom(*cache)){
+		return false;
+	}
+
+	//The scene is only used for its shape, so a geode with the same triangles does. It gets a KD-tree like the ones
+	//LoadScene has the model reader build.
+	osg::ref_ptr<osg::Geode> geode = engine->makeGeode();
+	osg::ref_ptr<osg::KdTreeBuilder> kdTreeBuilder = osgDB::Registry::instance()->getKdTreeBuilder()->clone();
+	geode->accept(*kdTreeBuilder);
+	scene = geode.get();
+
+	boudingBox.set(bounds[0], bounds[1], bounds[2], bounds[3], bounds[4], bounds[5]);
+	sceneCenter.set(bounds[6], bounds[7], bounds[8]);
+	//Not cached, so changing COLLISION_PENALTY_MODIFIER takes effect without rebuilding the cache. The longest side is
+	//that of the bounding box, as calcLongestSceneSide finds it.
+	double longestSceneSide = std::max(fabs(boudingBox.zMax()-boudingBox.zMin()),
+			std::max(fabs(boudingBox.xMax()-boudingBox.xMin()), fabs(boudingBox.yMax()-boudingBox.yMin())));
+	collisionPenalty = COLLISION_PENALTY_MODIFIER*longestSceneSide;
+	loaded_scene_name = fileName;
+	triangleStore.setTriangle_scene_name(fileName);
+	cachedCollisionEngine = engine;
+	sceneCache = std::move(cache);
+	return true;
+}
+
+void SceneKeeper::writeCache() const{
+	const CollisionEngine* collisionEngine = CollisionEngine::getAttached(*scene);
+	if(collisionEngine == nullptr){
+		return; //The scene had user data of its own, so it did not get an engine.
+	}
+	//Only what follows from the model is cached. Anything depending on the constants, like the collision penalty, is
+	//recomputed when loading, and the distance field checks its own settings.
+	double bounds[9] = {boudingBox.xMin(), boudingBox.yMin(), boudingBox.zMin(), boudingBox.xMax(), boudingBox.yMax(), boudingBox.zMax(),
+			sceneCenter.x(), sceneCenter.y(), sceneCenter.z()};
+	osg::ref_ptr<osg::Vec3Array> coloredVertices = new osg::Vec3Array();
+	osg::ref_ptr<osg::Vec3Array> coloredColors = new osg::Vec3Array();
+	triangleStore.makeColoredArrays(*coloredVertices, *coloredColors);
+
+	SceneCache::Writer writer;
+	writer.add(SceneCache::SCENE_BOUNDS, bounds, 9);
+	triangleStore.writeTo(writer);
+	writer.add(SceneCache::COLORED_VERTICES, static_cast<const osg::Vec3*>(coloredVertices->getDataPointer()), coloredVertices->size());
+	writer.add(SceneCache::COLORED_COLORS, static_cast<const osg::Vec3*>(coloredColors->getDataPointer()), coloredColors->size());
+	collisionEngine->writeTo(writer);
+	if(!writer.write(loaded_scene_name + ".scenecache", modelKey)){
+		std::cerr << "Warning: Could not store the preprocessed scene in " << loaded_scene_name << ".scenecache" << std::endl;
+	}
+}
+
 } /* namespace utility_functions */
 
 
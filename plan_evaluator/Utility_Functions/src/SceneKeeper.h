@@ -13,6 +13,7 @@
 #include <boost/dynamic_bitset/dynamic_bitset.hpp>
 #include <iostream>
 #include <map>
+#include <memory>
 #include <osg/Geode>
 #include <osg/Geometry>
 #include <osg/ref_ptr>
@@ -24,6 +25,9 @@
 #include <string>
 #include <vector>
 
+#include "CollisionEngine.h"
+#include "Hash128.h"
+#include "SceneCache.h"
 #include "TriangleData.h"
 
 namespace utility_functions {
@@ -53,15 +57,36 @@ namespace utility_functions {
 
 		std::string loaded_scene_name = "";
 
+		bool cacheable = false;					///<True if the scene may be stored in the cache, under modelKey.
+		Hash128 modelKey;						///<The hash of the model file's contents, and of the geometry precision.
+		std::unique_ptr<SceneCache> sceneCache;	///<The preprocessed scene, if it was loaded from the cache. Mapped as long as we live.
+		osg::ref_ptr<CollisionEngine> cachedCollisionEngine;	///<Read from sceneCache, and attached to the scene by countTriangles.
+
+		/**
+		 * Sets up the scene from the cache of the model file, instead of loading the model: The scene becomes a single
+		 * geode with the model's triangles, and the triangles, bounds and collision engine are read, not computed.
+		 * @return false if there is no valid cache for the current contents of the file. Nothing is changed then.
+		 */
+		bool loadFromCache(const std::string &fileName);
+
+		///Stores the preprocessed scene in the cache, for later runs. countTriangles must have been called.
+		void writeCache() const;
+
 	public:
 		/**
          * Counts the number of primitives (mesh triangles) in the scene, and stores the result into our triangleStore. Information about each triangle is also store there,
          * such as its center and area.
          * This method should be called once for each run, before testing plans. Counting triangles is a prerequisite to calculating coverage scores.
+         * Also attaches a CollisionEngine to the scene, which speeds up the collision checks of plan edges. Its distance
+         * field is kept next to the model file (with the extension .sdf added), so later runs can load it.
+         * If the scene was not loaded from the cache (see USE_SCENE_CACHE), the results are stored there afterwards.
          */
 		void countTriangles();
 
-		//Need to explicitly declare the default constructor when deleting the copy-constructor.
+		/**
+		 * Loads the model in the file. If the cache next to it was made from the same contents, the preprocessed scene is
+		 * loaded from there instead, and countTriangles has little left to do.
+		 */
 		SceneKeeper(const std::string &fileName);
 
 		// = default;
@@ -84,6 +109,18 @@ namespace utility_functions {
 			return triangleStore.getTriangleCount();
 		}
 
+		double getTriangleArea(size_t triangleId) const {
+			return triangleStore.getTriangleArea(triangleId);
+		}
+
+		const AlignedVector<double>& getTriangleAreas() const {
+			return triangleStore.getTriangleAreas();
+		}
+
+		double getTotalArea() const {
+			return triangleStore.getTotalArea();
+		}
+
 		/**
          * Uses the mapping from color to triangle ID to calculate the coverage given covered colors.
          * Calculates the percentage of the current structure a given set of triangles cover, scaled to the interval 0-1, where 0 means all surfaces are covered, and 1 means no coverage.
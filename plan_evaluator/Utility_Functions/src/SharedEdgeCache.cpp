@@ -0,0 +1,283 @@
+/*
+ * SharedEdgeCache.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include "SharedEdgeCache.h"
+
+#include <algorithm>
+#include <assert.h>
+#include <atomic>
+#include <chrono>
+#include <errno.h>
+#include <fcntl.h>
+#include <iostream>
+#include <new>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+namespace utility_functions {
+
+namespace {
+	const uint64_t SHARED_EDGE_CACHE_MAGIC = 0x45444745434143ULL; //"EDGECAC"
+	const uint32_t SHARED_EDGE_CACHE_VERSION = 2;
+
+	/**
+	 * The states a slot moves through. Slots only ever move forward: empty -> claiming -> claimed -> ready or abandoned.
+	 * The key is written while claiming, and the payload while claimed. Abandoned slots are never reused.
+	 */
+	enum SlotState {
+		SLOT_EMPTY = 0,
+		SLOT_CLAIMING = 1,
+		SLOT_CLAIMED = 2,
+		SLOT_READY = 3,
+		SLOT_ABANDONED = 4
+	};
+
+	///How long we wait for another process to finish initializing a segment before giving up.
+	const std::chrono::seconds INITIALIZATION_TIMEOUT(30);
+	///How long we wait for an edge claimed by another process, before rendering it ourselves. Protects us from
+	///processes that died while rendering.
+	const std::chrono::seconds CLAIM_TIMEOUT(60);
+	///The longest pause between two looks at a claimed slot.
+	const std::chrono::microseconds MAX_CLAIM_POLL_INTERVAL(10000);
+}
+
+static_assert(sizeof(boost::dynamic_bitset<>::block_type) == sizeof(uint64_t),
+			  "The shared edge cache stores bitset blocks as 64-bit words.");
+
+struct SharedEdgeCache::Header {
+	uint64_t magic;
+	uint32_t version;
+	std::atomic<uint32_t> initialized;	///<Set to 1 by the creating process once the rest of the header is valid.
+	uint64_t capacity;
+	uint64_t numBits;
+	uint64_t blocksPerEntry;
+	Hash128 fingerprint;
+	std::atomic<uint64_t> size;
+};
+
+struct SharedEdgeCache::Slot {
+	std::atomic<uint32_t> state;
+	uint32_t padding;
+	Hash128 key;
+};
+
+size_t SharedEdgeCache::calculateMappingSize(size_t capacity, size_t blocksPerEntry){
+	return sizeof(Header) + capacity*sizeof(Slot) + capacity*blocksPerEntry*sizeof(uint64_t);
+}
+
+SharedEdgeCache::SharedEdgeCache(const std::string& name, size_t capacity, size_t numBits, const Hash128& fingerprint)
+:name(name),
+ mapping(nullptr),
+ mappingSize(0),
+ header(nullptr),
+ slots(nullptr),
+ payloads(nullptr),
+ capacity(capacity),
+ numBits(numBits),
+ blocksPerEntry((numBits + 63) / 64){
+
+	if(capacity == 0){
+		throw std::invalid_argument("A shared edge cache needs room for at least one edge.");
+	}
+
+	bool createdSegment = true;
+	int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+	if(fd == -1 && errno == EEXIST){
+		//Someone else created the table. We attach to theirs.
+		createdSegment = false;
+		fd = shm_open(name.c_str(), O_RDWR, 0600);
+	}
+	if(fd == -1){
+		throw std::runtime_error("Could not open the shared edge cache " + name);
+	}
+
+	if(createdSegment){
+		mappingSize = calculateMappingSize(capacity, blocksPerEntry);
+		//ftruncate zero-fills the segment, which leaves every slot in the SLOT_EMPTY state.
+		if(ftruncate(fd, mappingSize) == -1){
+			close(fd);
+			shm_unlink(name.c_str());
+			throw std::runtime_error("Could not allocate the shared edge cache " + name);
+		}
+	}
+	else{
+		//The creator sizes the segment right after creating it. Waiting until that has happened.
+		std::chrono::steady_clock::time_point waitStart = std::chrono::steady_clock::now();
+		struct stat segmentInfo;
+		while(fstat(fd, &segmentInfo) == 0 && (size_t)segmentInfo.st_size < sizeof(Header)){
+			if(std::chrono::steady_clock::now() - waitStart > INITIALIZATION_TIMEOUT){
+				close(fd);
+				throw std::runtime_error("Timed out waiting for the shared edge cache " + name + " to be created.");
+			}
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		mappingSize = segmentInfo.st_size;
+	}
+
+	mapping = mmap(nullptr, mappingSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd); //The mapping stays valid after closing the descriptor.
+	if(mapping == MAP_FAILED){
+		mapping = nullptr;
+		throw std::runtime_error("Could not map the shared edge cache " + name);
+	}
+	header = static_cast<Header*>(mapping);
+
+	if(createdSegment){
+		header->magic = SHARED_EDGE_CACHE_MAGIC;
+		header->version = SHARED_EDGE_CACHE_VERSION;
+		header->capacity = capacity;
+		header->numBits = numBits;
+		header->blocksPerEntry = blocksPerEntry;
+		header->fingerprint = fingerprint;
+		header->size.store(0, std::memory_order_relaxed);
+		header->initialized.store(1, std::memory_order_release);
+	}
+	else{
+		std::chrono::steady_clock::time_point waitStart = std::chrono::steady_clock::now();
+		while(header->initialized.load(std::memory_order_acquire) == 0){
+			if(std::chrono::steady_clock::now() - waitStart > INITIALIZATION_TIMEOUT){
+				munmap(mapping, mappingSize);
+				throw std::runtime_error("Timed out waiting for the shared edge cache " + name + " to be initialized.");
+			}
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		if(header->magic != SHARED_EDGE_CACHE_MAGIC || header->version != SHARED_EDGE_CACHE_VERSION ||
+				header->numBits != numBits || header->fingerprint != fingerprint ||
+				mappingSize < calculateMappingSize(header->capacity, header->blocksPerEntry)){
+			munmap(mapping, mappingSize);
+			throw std::runtime_error("The shared edge cache " + name + " was created for a different scene or sensor setup. "
+									 "Remove it, or use a different name.");
+		}
+		this->capacity = header->capacity;
+		std::cout << "Attached to shared edge cache " << name << " holding " << size() << " edges." << std::endl;
+	}
+
+	slots = reinterpret_cast<Slot*>(static_cast<char*>(mapping) + sizeof(Header));
+	payloads = reinterpret_cast<uint64_t*>(static_cast<char*>(mapping) + sizeof(Header) + this->capacity*sizeof(Slot));
+}
+
+SharedEdgeCache::~SharedEdgeCache() {
+	if(mapping != nullptr){
+		munmap(mapping, mappingSize);
+	}
+}
+
+uint32_t SharedEdgeCache::loadStateWithKey(const Slot& slot){
+	uint32_t state = slot.state.load(std::memory_order_acquire);
+	//A claimer writes its key right after taking the slot, so this wait is short.
+	while(state == SLOT_CLAIMING){
+		std::this_thread::yield();
+		state = slot.state.load(std::memory_order_acquire);
+	}
+	return state;
+}
+
+void SharedEdgeCache::readPayload(size_t slot, boost::dynamic_bitset<>& coverage) const{
+	const uint64_t* payload = payloads + slot*blocksPerEntry;
+	boost::from_block_range(payload, payload + blocksPerEntry, coverage);
+}
+
+bool SharedEdgeCache::lookup(const Hash128& key, boost::dynamic_bitset<>& coverage) const{
+	assert(coverage.size() == numBits);
+	for(size_t probe = 0; probe < MAX_PROBES && probe < capacity; probe++){
+		size_t index = slotIndex(key, probe);
+		uint32_t state = loadStateWithKey(slots[index]);
+		if(state == SLOT_EMPTY){
+			//Claims never skip an empty slot, so the key cannot be further along the probe sequence.
+			return false;
+		}
+		if(state == SLOT_READY && slots[index].key == key){
+			readPayload(index, coverage);
+			return true;
+		}
+		//Slots of other keys, and claims of ours not yet ready, are skipped.
+	}
+	return false;
+}
+
+SharedEdgeCache::ClaimResult SharedEdgeCache::claim(const Hash128& key, boost::dynamic_bitset<>& coverage, size_t& slot){
+	assert(coverage.size() == numBits);
+	for(size_t probe = 0; probe < MAX_PROBES && probe < capacity; probe++){
+		size_t index = slotIndex(key, probe);
+		uint32_t state = loadStateWithKey(slots[index]);
+		if(state == SLOT_EMPTY){
+			uint32_t expected = SLOT_EMPTY;
+			if(slots[index].state.compare_exchange_strong(expected, SLOT_CLAIMING, std::memory_order_acq_rel)){
+				//The slot is ours. Nobody reads the key before we publish the claim.
+				slots[index].key = key;
+				slots[index].state.store(SLOT_CLAIMED, std::memory_order_release);
+				slot = index;
+				return claim_granted;
+			}
+			//Lost the race for this slot. Looking at what the winner put there.
+			state = loadStateWithKey(slots[index]);
+		}
+		if(slots[index].key != key || state == SLOT_ABANDONED){
+			continue;
+		}
+		if(state == SLOT_READY){
+			readPayload(index, coverage);
+			return claim_found;
+		}
+		slot = index;
+		return claim_taken;
+	}
+	return claim_failed; //Table is full along this probe sequence.
+}
+
+void SharedEdgeCache::publish(size_t slot, const boost::dynamic_bitset<>& coverage){
+	assert(coverage.size() == numBits);
+	assert(slots[slot].state.load(std::memory_order_relaxed) == SLOT_CLAIMED);
+	boost::to_block_range(coverage, payloads + slot*blocksPerEntry);
+	slots[slot].state.store(SLOT_READY, std::memory_order_release);
+	header->size.fetch_add(1, std::memory_order_relaxed);
+}
+
+void SharedEdgeCache::abandon(size_t slot){
+	assert(slots[slot].state.load(std::memory_order_relaxed) == SLOT_CLAIMED);
+	slots[slot].state.store(SLOT_ABANDONED, std::memory_order_release);
+}
+
+bool SharedEdgeCache::waitForClaimed(size_t slot, boost::dynamic_bitset<>& coverage) const{
+	assert(coverage.size() == numBits);
+	std::chrono::steady_clock::time_point waitStart = std::chrono::steady_clock::now();
+	std::chrono::microseconds pollInterval(50);
+	while(true){
+		uint32_t state = slots[slot].state.load(std::memory_order_acquire);
+		if(state == SLOT_READY){
+			readPayload(slot, coverage);
+			return true;
+		}
+		if(state != SLOT_CLAIMED || std::chrono::steady_clock::now() - waitStart > CLAIM_TIMEOUT){
+			return false;
+		}
+		std::this_thread::sleep_for(pollInterval);
+		pollInterval = std::min(pollInterval * 2, MAX_CLAIM_POLL_INTERVAL);
+	}
+}
+
+bool SharedEdgeCache::insert(const Hash128& key, const boost::dynamic_bitset<>& coverage){
+	size_t slot;
+	boost::dynamic_bitset<> storedCoverage(numBits);
+	if(claim(key, storedCoverage, slot) != claim_granted){
+		return false; //Stored or claimed by someone else, or the table is full.
+	}
+	publish(slot, coverage);
+	return true;
+}
+
+size_t SharedEdgeCache::size() const{
+	return header->size.load(std::memory_order_relaxed);
+}
+
+bool SharedEdgeCache::remove(const std::string& name){
+	return shm_unlink(name.c_str()) == 0;
+}
+
+} /* namespace utility_functions */
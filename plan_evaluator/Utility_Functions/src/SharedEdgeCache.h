@@ -0,0 +1,153 @@
+/*
+ * SharedEdgeCache.h
+ *
+ * A table of edge coverages living in POSIX shared memory, so that several evaluator processes on the same host
+ * can reuse each others' rendered edges.
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef SHAREDEDGECACHE_H_
+#define SHAREDEDGECACHE_H_
+
+#include <boost/dynamic_bitset/dynamic_bitset.hpp>
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+
+#include "Hash128.h"
+
+namespace utility_functions {
+
+/**
+ * A fixed-capacity, open-addressing hash table of edge coverages, stored in a named POSIX shared memory segment.
+ * All PlanCoverageEstimators (in any process on the host) that attach to the same name see the same table.
+ *
+ * All operations are lock-free: Each slot has an atomic state, and its payload is only read after it has been published
+ * as ready. Entries are never modified or removed once written, which is safe since the coverage of a given edge never
+ * changes during a run. When the table is full, new edges are simply not shared.
+ *
+ * So that processes missing the same edge at once do not all render it, an edge is claimed before it is rendered (see
+ * claim). The process holding the claim renders the edge and publishes it, while the others wait for it.
+ *
+ * The segment outlives the processes using it, and has to be removed with SharedEdgeCache::remove when the run is done.
+ */
+class SharedEdgeCache {
+
+private:
+	struct Header;
+	struct Slot;
+
+	std::string name;			///<The name of the shared memory segment.
+	void* mapping;				///<The start of our mapping of the segment.
+	size_t mappingSize;			///<The size of the mapped segment, in bytes.
+	Header* header;
+	Slot* slots;
+	uint64_t* payloads;			///<The bitset blocks of all slots, blocksPerEntry blocks for each slot.
+	size_t capacity;			///<The number of slots in the table.
+	size_t numBits;				///<The size of each stored bitset.
+	size_t blocksPerEntry;		///<The number of 64-bit blocks needed to store one bitset.
+
+	///The number of slots we probe before giving up. Keeps worst-case lookups short when the table is nearly full.
+	static const size_t MAX_PROBES = 64;
+
+	size_t slotIndex(const Hash128& key, size_t probe) const {
+		return (key.low + probe) % capacity;
+	}
+
+	static size_t calculateMappingSize(size_t capacity, size_t blocksPerEntry);
+
+	///@return The state of the slot, once any key being written to it is visible.
+	static uint32_t loadStateWithKey(const Slot& slot);
+
+	///Copies the payload of a ready slot into coverage.
+	void readPayload(size_t slot, boost::dynamic_bitset<>& coverage) const;
+
+	//Here, I'm disallowing copy-constructors for this object, as it owns a memory mapping.
+	SharedEdgeCache(const SharedEdgeCache&) = delete;
+	SharedEdgeCache& operator=(const SharedEdgeCache&) = delete;
+
+public:
+
+	///The outcomes of claim.
+	enum ClaimResult {
+		claim_found,	///<The edge is stored, and its coverage was copied out.
+		claim_granted,	///<We hold the claim, and have to render the edge, and then publish or abandon it.
+		claim_taken,	///<Another process holds the claim. Use waitForClaimed to get its result.
+		claim_failed	///<The table is full along the edge's probe sequence. Render the edge without sharing it.
+	};
+
+	/**
+	 * Attaches to the shared edge cache with the given name, creating it if it does not exist yet.
+	 * @param name The name of the shared memory segment. Should start with a slash, e.g. "/inspection_edges".
+	 * @param capacity The maximum number of edges in the table. Only used by the process creating the segment.
+	 * @param numBits The size of the coverage bitsets we store (the number of triangles in the scene).
+	 * @param fingerprint Identifies the scene and sensor setup the cached edges belong to. Attaching to a table created
+	 * with a different fingerprint throws, since its entries would be meaningless for us.
+	 * @throws std::runtime_error if the segment cannot be created or mapped, or belongs to a different setup.
+	 */
+	SharedEdgeCache(const std::string& name, size_t capacity, size_t numBits, const Hash128& fingerprint);
+
+	~SharedEdgeCache();
+
+	/**
+	 * Looks up the coverage of the edge with the given key.
+	 * @param key The hashed edge name
+	 * @param[out] coverage Set to the stored coverage if found. Has to be numBits long.
+	 * @return true if the edge was found, false otherwise.
+	 */
+	bool lookup(const Hash128& key, boost::dynamic_bitset<>& coverage) const;
+
+	/**
+	 * Looks up the coverage of an edge, and claims the edge for rendering if it is neither stored nor claimed by anyone.
+	 * @param key The hashed edge name
+	 * @param[out] coverage Set to the stored coverage for claim_found. Has to be numBits long.
+	 * @param[out] slot For claim_granted, our claim. For claim_taken, the other process's claim.
+	 */
+	ClaimResult claim(const Hash128& key, boost::dynamic_bitset<>& coverage, size_t& slot);
+
+	///Stores the coverage of an edge we hold the claim on, and lets everyone read it.
+	void publish(size_t slot, const boost::dynamic_bitset<>& coverage);
+
+	///Gives up a claim we hold without storing anything, e.g. when rendering failed. Those waiting for it render the edge themselves.
+	void abandon(size_t slot);
+
+	/**
+	 * Waits for another process to publish the edge it claimed. Gives up if the claim is abandoned, or not published
+	 * within a minute, in case its process died.
+	 * @param slot The claim, as given by claim.
+	 * @param[out] coverage Set to the edge's coverage if published. Has to be numBits long.
+	 * @return true if the edge was published.
+	 */
+	bool waitForClaimed(size_t slot, boost::dynamic_bitset<>& coverage) const;
+
+	/**
+	 * Stores the coverage of an edge. If the edge is already stored or claimed, or the table is full, nothing happens.
+	 * @param key The hashed edge name
+	 * @param coverage The coverage of the edge. Has to be numBits long.
+	 * @return true if we stored the edge, false otherwise.
+	 */
+	bool insert(const Hash128& key, const boost::dynamic_bitset<>& coverage);
+
+	///@return The number of edges currently stored (by all attached processes).
+	size_t size() const;
+
+	size_t getCapacity() const {
+		return capacity;
+	}
+
+	const std::string& getName() const {
+		return name;
+	}
+
+	/**
+	 * Removes the shared memory segment with the given name. Processes still attached keep their mapping, but
+	 * processes attaching later will get a fresh, empty table.
+	 * @return true if a segment was removed.
+	 */
+	static bool remove(const std::string& name);
+};
+
+} /* namespace utility_functions */
+
+#endif /* SHAREDEDGECACHE_H_ */
@@ -0,0 +1,111 @@
+/*
+ * ThreadPool.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+#include "NumaTopology.h"
+
+namespace utility_functions {
+
+ThreadPool::ThreadPool(size_t numThreads)
+:currentTask(nullptr),
+ numTasks(0),
+ nextTask(0),
+ numCompletedTasks(0),
+ generation(0),
+ stopping(false){
+	if (numThreads == 0) {
+		numThreads = std::max(1u, std::thread::hardware_concurrency());
+	}
+	startWorkers(numThreads);
+}
+
+ThreadPool::ThreadPool(const std::vector<std::vector<int> >& workerCpus)
+:currentTask(nullptr),
+ numTasks(0),
+ nextTask(0),
+ numCompletedTasks(0),
+ generation(0),
+ stopping(false),
+ workerCpus(workerCpus){
+	startWorkers(std::max<size_t>(1, workerCpus.size()));
+}
+
+void ThreadPool::startWorkers(size_t numThreads) {
+	for (size_t workerIndex = 0; workerIndex < numThreads; workerIndex++) {
+		workers.push_back(std::thread(&ThreadPool::workerLoop, this, workerIndex));
+	}
+}
+
+ThreadPool::~ThreadPool() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	workAvailable.notify_all();
+	for (std::vector<std::thread>::iterator worker = workers.begin(); worker != workers.end(); worker++) {
+		worker->join();
+	}
+}
+
+void ThreadPool::workerLoop(size_t workerIndex) {
+	if (workerIndex < workerCpus.size() && !workerCpus[workerIndex].empty()) {
+		NumaTopology::pinCurrentThread(workerCpus[workerIndex]);
+	}
+	unsigned int seenGeneration = 0;
+	std::unique_lock<std::mutex> lock(mutex);
+	while (true) {
+		workAvailable.wait(lock, [&]{ return stopping || generation != seenGeneration; });
+		if (stopping) {
+			return;
+		}
+		seenGeneration = generation;
+		while (nextTask < numTasks) {
+			size_t taskIndex = nextTask++;
+			lock.unlock();
+			std::exception_ptr error;
+			try {
+				(*currentTask)(taskIndex, workerIndex);
+			} catch (...) {
+				error = std::current_exception();
+			}
+			lock.lock();
+			if (error && !firstError) {
+				firstError = error;
+			}
+			if (++numCompletedTasks == numTasks) {
+				workDone.notify_all();
+			}
+		}
+	}
+}
+
+void ThreadPool::parallelFor(size_t numTasks, const std::function<void(size_t taskIndex, size_t workerIndex)>& task) {
+	if (numTasks == 0) {
+		return;
+	}
+	std::lock_guard<std::mutex> callLock(callMutex);
+	std::unique_lock<std::mutex> lock(mutex);
+	currentTask = &task;
+	this->numTasks = numTasks;
+	nextTask = 0;
+	numCompletedTasks = 0;
+	firstError = nullptr;
+	generation++;
+	workAvailable.notify_all();
+	workDone.wait(lock, [&]{ return numCompletedTasks == this->numTasks; });
+	currentTask = nullptr;
+	std::exception_ptr error = firstError;
+	firstError = nullptr;
+	lock.unlock();
+	if (error) {
+		std::rethrow_exception(error);
+	}
+}
+
+} /* namespace utility_functions */
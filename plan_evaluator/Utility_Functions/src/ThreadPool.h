@@ -0,0 +1,80 @@
+/*
+ * ThreadPool.h
+ *
+ * A fixed set of worker threads, used to spread independent pieces of work (such as the evaluation of the plans in
+ * one generation) across the cores of the machine.
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef THREADPOOL_H_
+#define THREADPOOL_H_
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <stddef.h>
+#include <thread>
+#include <vector>
+
+namespace utility_functions {
+
+class ThreadPool {
+
+private:
+	std::vector<std::thread> workers;
+
+	std::mutex callMutex;			///<Held during parallelFor, so calls from several threads do not mix their tasks.
+	std::mutex mutex;				///<Protects everything below.
+	std::condition_variable workAvailable;
+	std::condition_variable workDone;
+	const std::function<void(size_t, size_t)>* currentTask;
+	size_t numTasks;
+	size_t nextTask;				///<The index of the next task to hand out to a worker.
+	size_t numCompletedTasks;
+	unsigned int generation;		///<Incremented for each call to parallelFor, so workers can tell new work from old.
+	bool stopping;
+	std::exception_ptr firstError;	///<The first exception thrown by a task in the current call.
+	std::vector<std::vector<int> > workerCpus;	///<The CPUs each worker is pinned to. Empty if workers are not pinned.
+
+	void startWorkers(size_t numThreads);
+	void workerLoop(size_t workerIndex);
+
+	//Here, I'm disallowing copy-constructors for this object, as it owns threads.
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+public:
+
+	/**
+	 * Starts the worker threads.
+	 * @param numThreads The number of workers. If 0, we use one worker per hardware thread.
+	 */
+	explicit ThreadPool(size_t numThreads);
+
+	/**
+	 * Starts one worker per entry of workerCpus, each pinned to the CPUs listed for it (see NumaTopology), so the memory
+	 * a worker touches first stays on its NUMA node. A worker with an empty list is not pinned.
+	 */
+	explicit ThreadPool(const std::vector<std::vector<int> >& workerCpus);
+
+	///Stops and joins all workers.
+	~ThreadPool();
+
+	/**
+	 * Runs task(taskIndex, workerIndex) for every taskIndex in [0, numTasks), spread over the workers, and waits until all are done.
+	 * The worker index (in [0, size())) lets tasks use per-worker resources without locking. Each worker runs one task at a time.
+	 * If any task throws, the remaining tasks still run, and the first exception is rethrown here.
+	 */
+	void parallelFor(size_t numTasks, const std::function<void(size_t taskIndex, size_t workerIndex)>& task);
+
+	///@return The number of worker threads.
+	size_t size() const {
+		return workers.size();
+	}
+};
+
+} /* namespace utility_functions */
+
+#endif /* THREADPOOL_H_ */
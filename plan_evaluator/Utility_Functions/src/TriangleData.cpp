@@ -7,6 +7,8 @@
 
 #include "TriangleData.h"
 
+#include <boost/functional/hash.hpp>
+#include <cstring>
 #include <iostream>
 #include <osg/Geometry>
 #include <osgUtil/SmoothingVisitor>
@@ -38,19 +40,39 @@ osg::ref_ptr<osg::Vec3Array> TriangleData::generateDifferentRandomColors(int num
 
 }
 
+size_t TriangleData::VertexKeyHash::operator()(const VertexKey& key) const{
+	size_t seed = 0;
+	for(int axis = 0; axis < 3; axis++){
+		boost::hash_combine(seed, key.bits[axis]);
+	}
+	return seed;
+}
+
+uint32_t TriangleData::addVertex(const osg::Vec3d& vertex){
+	VertexKey key;
+	for(int axis = 0; axis < 3; axis++){
+		double coordinate = vertex[axis];
+		memcpy(&key.bits[axis], &coordinate, sizeof(coordinate));
+	}
+	std::pair<std::unordered_map<VertexKey, uint32_t, VertexKeyHash>::iterator, bool> inserted = vertexIds.insert(std::make_pair(key, (uint32_t) vertexX.size()));
+	if(inserted.second){
+		vertexX.push_back(vertex.x());
+		vertexY.push_back(vertex.y());
+		vertexZ.push_back(vertex.z());
+	}
+	return inserted.first->second;
+}
+
 void TriangleData::operator()(const osg::Vec3d v1, const osg::Vec3d v2, const osg::Vec3d v3, bool treatVertexDataAsTemporary)
 {
-	//osg::Vec3dArray tri;
-	std::vector<osg::Vec3d> tri;
-	tri.push_back(v1);
-	tri.push_back(v2);
-	tri.push_back(v3);
-
-	triangles.push_back(tri);
+	triangleVertices.push_back(addVertex(v1));
+	triangleVertices.push_back(addVertex(v2));
+	triangleVertices.push_back(addVertex(v3));
 
 	//Calculating triangle centroid
-	osg::Vec3d triangleCentroid((v1.x()+v2.x()+v3.x())/3.0,(v1.y()+v2.y()+v3.y())/3.0,(v1.z()+v2.z()+v3.z())/3.0);
-	triangleCenters.push_back(triangleCentroid);
+	centerX.push_back((v1.x()+v2.x()+v3.x())/3.0);
+	centerY.push_back((v1.y()+v2.y()+v3.y())/3.0);
+	centerZ.push_back((v1.z()+v2.z()+v3.z())/3.0);
 
 	//Calculating triangle size using Heron's formula
 	double side1Len = (v2-v1).length();
@@ -63,12 +85,93 @@ void TriangleData::operator()(const osg::Vec3d v1, const osg::Vec3d v2, const os
 }
 
 void TriangleData::calculateTotalArea(){
-	std::cout << "Stored in total " << triangles.size() << " triangles" << std::endl;
+	std::cout << "Stored in total " << getTriangleCount() << " triangles, with " << getVertexCount() << " distinct vertices" << std::endl;
 	double area = 0;
-	for(std::vector<double>::iterator it = triangleSizes.begin(); it<triangleSizes.end();it++){
-		area+=*it;
+	for(size_t triangleId = 0; triangleId < triangleSizes.size(); triangleId++){
+		area+=triangleSizes[triangleId];
 	}
 	totalArea = area;
+	std::unordered_map<VertexKey, uint32_t, VertexKeyHash>().swap(vertexIds);
+}
+
+void TriangleData::writeTo(SceneCache::Writer& writer) const{
+	writer.add(SceneCache::TRIANGLE_VERTEX_X, vertexX.data(), vertexX.size());
+	writer.add(SceneCache::TRIANGLE_VERTEX_Y, vertexY.data(), vertexY.size());
+	writer.add(SceneCache::TRIANGLE_VERTEX_Z, vertexZ.data(), vertexZ.size());
+	writer.add(SceneCache::TRIANGLE_VERTICES, triangleVertices.data(), triangleVertices.size());
+	writer.add(SceneCache::TRIANGLE_AREAS, triangleSizes.data(), triangleSizes.size());
+	writer.add(SceneCache::TRIANGLE_CENTER_X, centerX.data(), centerX.size());
+	writer.add(SceneCache::TRIANGLE_CENTER_Y, centerY.data(), centerY.size());
+	writer.add(SceneCache::TRIANGLE_CENTER_Z, centerZ.data(), centerZ.size());
+}
+
+namespace {
+	///Copies a section of the cache into the array. @return false if the section is missing, or does not hold count values.
+	template<typename T>
+	bool readSection(const SceneCache& cache, SceneCache::SectionId id, size_t count, AlignedVector<T>& array){
+		const T* data;
+		size_t storedCount;
+		if(!cache.get(id, data, storedCount) || storedCount != count){
+			return false;
+		}
+		array.assign(data, data+count);
+		return true;
+	}
+}
+
+bool TriangleData::readFrom(const SceneCache& cache){
+	//The sizes of all sections follow from these three, and the indices must all point to stored vertices.
+	const double* storedAreas;
+	const uint32_t* storedVertices;
+	const GeometryReal* storedVertexX;
+	size_t numTriangles, numIndices, numVertices;
+	if(!cache.get(SceneCache::TRIANGLE_AREAS, storedAreas, numTriangles) || !cache.get(SceneCache::TRIANGLE_VERTICES, storedVertices, numIndices)
+			|| numIndices != 3*numTriangles || !cache.get(SceneCache::TRIANGLE_VERTEX_X, storedVertexX, numVertices)){
+		return false;
+	}
+	for(size_t i = 0; i < numIndices; i++){
+		if(storedVertices[i] >= numVertices){
+			return false;
+		}
+	}
+	if(!readSection(cache, SceneCache::TRIANGLE_VERTEX_X, numVertices, vertexX) || !readSection(cache, SceneCache::TRIANGLE_VERTEX_Y, numVertices, vertexY)
+			|| !readSection(cache, SceneCache::TRIANGLE_VERTEX_Z, numVertices, vertexZ)
+			|| !readSection(cache, SceneCache::TRIANGLE_VERTICES, numIndices, triangleVertices)
+			|| !readSection(cache, SceneCache::TRIANGLE_AREAS, numTriangles, triangleSizes)
+			|| !readSection(cache, SceneCache::TRIANGLE_CENTER_X, numTriangles, centerX)
+			|| !readSection(cache, SceneCache::TRIANGLE_CENTER_Y, numTriangles, centerY)
+			|| !readSection(cache, SceneCache::TRIANGLE_CENTER_Z, numTriangles, centerZ)){
+		vertexX.clear();
+		vertexY.clear();
+		vertexZ.clear();
+		triangleVertices.clear();
+		triangleSizes.clear();
+		centerX.clear();
+		centerY.clear();
+		centerZ.clear();
+		return false;
+	}
+	calculateTotalArea();
+	return true;
+}
+
+std::vector<osg::Vec3d> TriangleData::getTriangleCenters() const{
+	std::vector<osg::Vec3d> centers;
+	centers.reserve(getTriangleCount());
+	for(size_t triangleId = 0; triangleId < getTriangleCount(); triangleId++){
+		centers.push_back(getTriangleCenter(triangleId));
+	}
+	return centers;
+}
+
+std::vector<std::vector<osg::Vec3d> > TriangleData::getTriangles() const{
+	std::vector<std::vector<osg::Vec3d> > triangles(getTriangleCount());
+	for(size_t triangleId = 0; triangleId < getTriangleCount(); triangleId++){
+		for(int corner = 0; corner < 3; corner++){
+			triangles[triangleId].push_back(getTriangleVertex(triangleId, corner));
+		}
+	}
+	return triangles;
 }
 
 //void TriangleData::divideScene(osg::ref_ptr<osg::Geode> inspectionScene, osg::ref_ptr<osg::Geode> collisionScene, osg::Vec3d inspectionColor){
@@ -76,35 +179,37 @@ void TriangleData::calculateTotalArea(){
 //}
 
 osg::ref_ptr<osg::Geode> TriangleData::colorEachTriangleDifferently() const{
-
 	osg::ref_ptr<osg::Vec3Array> vertexArray = new osg::Vec3Array;
 	osg::ref_ptr<osg::Vec3Array> colorArray = new osg::Vec3Array;
+	makeColoredArrays(*vertexArray, *colorArray);
+	return makeColoredGeode(vertexArray, colorArray);
+}
+
+void TriangleData::makeColoredArrays(osg::Vec3Array& vertexArray, osg::Vec3Array& colorArray) const{
+	size_t numTriangles = getTriangleCount();
+	osg::ref_ptr<osg::Vec3Array> colors = generateDifferentRandomColors(numTriangles);
+	vertexArray.reserve(3*numTriangles);
+	colorArray.reserve(3*numTriangles);
+
+	//Each triangle gets its own three vertices, since the color is given per vertex. One primitive set draws them all,
+	//in the same order as drawing one triangle at a time did.
+	for(size_t triangleId = 0; triangleId < numTriangles; triangleId++){
+		const osg::Vec3& intColor = (*colors)[triangleId];
+		osg::Vec3 floatColor(convertRGBValuesToFloats(intColor.x()),convertRGBValuesToFloats(intColor.y()),convertRGBValuesToFloats(intColor.z()));
+		for(int corner = 0; corner < 3; corner++){
+			vertexArray.push_back(getTriangleVertex(triangleId, corner));
+			colorArray.push_back(floatColor);
+		}
+	}
+}
+
+osg::ref_ptr<osg::Geode> TriangleData::makeColoredGeode(osg::ref_ptr<osg::Vec3Array> vertexArray, osg::ref_ptr<osg::Vec3Array> colorArray){
 	osg::ref_ptr<osg::Geode> coloredScene = new osg::Geode();
 	osg::Geometry* coloredGeom = new osg::Geometry();
 	coloredScene->addDrawable(coloredGeom);
 	coloredGeom->setVertexArray(vertexArray);
 	coloredGeom->setColorArray(colorArray.get(), osg::Array::BIND_PER_VERTEX);
-
-	osg::ref_ptr<osg::Vec3Array> colors = generateDifferentRandomColors(triangles.size());
-	int counter = 0;
-	int primitiveCounter = 0;
-
-	for(std::vector<std::vector<osg::Vec3d> >::const_iterator  it = triangles.begin(); it!=triangles.end(); it++){
-		osg::ref_ptr<osg::DrawElementsUInt> trianglePrimitive = new osg::DrawElementsUInt(osg::PrimitiveSet::TRIANGLES, 0);
-		const std::vector<osg::Vec3d> currentTriangle = *it;
-		for(unsigned int i = 0; i<currentTriangle.size();i++){
-			vertexArray->push_back(currentTriangle.at(i));
-			trianglePrimitive->push_back(primitiveCounter);
-			osg::Vec3 intColor = colors->at(counter);
-			osg::Vec3 floatColor(convertRGBValuesToFloats(intColor.x()),convertRGBValuesToFloats(intColor.y()),convertRGBValuesToFloats(intColor.z()));
-
-			colorArray->push_back(floatColor);
-
-			primitiveCounter++;
-		}
-		coloredGeom->addPrimitiveSet(trianglePrimitive);
-		counter += 1;
-	}
+	coloredGeom->addPrimitiveSet(new osg::DrawArrays(osg::PrimitiveSet::TRIANGLES, 0, vertexArray->size()));
 
 	//Turning off the light. This makes the colors we see independent of normal directions, which is important when checking which colors we observe.
 	osg::StateSet* state = coloredScene->getOrCreateStateSet();
@@ -115,8 +220,8 @@ osg::ref_ptr<osg::Geode> TriangleData::colorEachTriangleDifferently() const{
 
 
 void TriangleData::colorCoveredTriangle(int triangleIndex, osg::Geode& g, const osg::Vec4& color) const{
-	std::vector<osg::Vec3d> coveredTriangle = triangles[triangleIndex];
-	double triangle_z_level = triangleCenters[triangleIndex].z();
+	osg::Vec3d coveredTriangle[3] = {getTriangleVertex(triangleIndex, 0), getTriangleVertex(triangleIndex, 1), getTriangleVertex(triangleIndex, 2)};
+	double triangle_z_level = centerZ[triangleIndex];
 	osg::Vec4 scaled_color;
 
 	//"Hack" I use to see the structure of the inspection target better in plots.
@@ -127,16 +232,13 @@ void TriangleData::colorCoveredTriangle(int triangleIndex, osg::Geode& g, const
 		scaled_color = color;
 	}
 
-	osg::ref_ptr<osg::Vec3dArray> coveredTriangleArray = new osg::Vec3dArray();
-	for(unsigned int i = 0; i<coveredTriangle.size();i++){
-		coveredTriangleArray->push_back(coveredTriangle.at(i));
-	}
+	osg::ref_ptr<osg::Vec3dArray> coveredTriangleArray = new osg::Vec3dArray(3, coveredTriangle);
 	osg::Geometry* polyGeom = new osg::Geometry();
 
 	//Calculating normals, to make the scene get a more three-dimensional view
 	osg::ref_ptr<osg::Vec3dArray> normalArray = new osg::Vec3dArray();
 	osg::Vec3d triangleNormal = calculateTriangleNormal(coveredTriangle[0],coveredTriangle[1],coveredTriangle[2]);
-	for(unsigned int i = 0; i<coveredTriangle.size();i++){
+	for(unsigned int i = 0; i<3;i++){
 		normalArray->push_back(triangleNormal);
 	}
 
@@ -152,8 +254,21 @@ void TriangleData::colorCoveredTriangle(int triangleIndex, osg::Geode& g, const
 }
 
 
+double TriangleData::calculateCoveredArea(const boost::dynamic_bitset<> &coveredColors) const{
+	//Summing in the same order as calculateAndColorCoverage, so both give exactly the same result.
+	double coverage = 0;
+	for(size_t colorId = coveredColors.find_first(); colorId != boost::dynamic_bitset<>::npos; colorId = coveredColors.find_next(colorId)){
+		coverage+=triangleSizes[colorId];
+	}
+	return coverage;
+}
+
 double TriangleData::calculateAndColorCoverage(const boost::dynamic_bitset<> &coveredColors,
 											   osg::ref_ptr<osg::Geode> g/*=nullptr*/, bool printerFriendly /*=false*/) const{
+	if(g==nullptr){
+		//Nothing to draw, so we only need the covered triangles.
+		return 1.0 - (calculateCoveredArea(coveredColors)/totalArea);
+	}
 	double coverage = 0;
 	for(unsigned int colorId=0;colorId<coveredColors.size();colorId++){
 
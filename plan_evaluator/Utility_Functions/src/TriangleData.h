@@ -16,23 +16,53 @@
 #include <osg/Vec3d>
 #include <osg/Vec4>
 #include <set>
+#include <stdint.h>
+#include <unordered_map>
 #include <vector>
 
+#include "AlignedAllocator.h"
+#include "GeometryPrecision.h"
+#include "SceneCache.h"
+
 namespace utility_functions {
 
 
 /**
  * Helper class to find and store all triangles in a scene. Follows the "visitor" pattern of OSG, which requires us to implement the
  * function "operator", which will be called each time a triangle is visited.
+ * The triangles are stored as a structure of arrays: One array for each coordinate of the (distinct) vertices, an index
+ * buffer with three vertices per triangle, and arrays of the centers and areas of the triangles. Passes over all
+ * triangles thereby scan a few contiguous arrays, instead of following a pointer per triangle.
  */
 class TriangleData
 {
 private:
+	///The bits of a vertex's coordinates, used to find vertices shared between triangles while loading.
+	struct VertexKey {
+		uint64_t bits[3];
+
+		bool operator==(const VertexKey& other) const {
+			return bits[0] == other.bits[0] && bits[1] == other.bits[1] && bits[2] == other.bits[2];
+		}
+	};
+
+	struct VertexKeyHash {
+		size_t operator()(const VertexKey& key) const;
+	};
 
 	double totalArea = 0; ///<Total area of all triangles - necessary to get the percentage of the area we currently cover.
-	std::vector<std::vector<osg::Vec3d> > triangles;	///<Vector containing each triangle in the scene.
-	std::vector<double> triangleSizes; 	///<Stores the size of each triangle in the scene, mapped from that triangle's ID.
-	std::vector<osg::Vec3d> triangleCenters; 	///<The center point of each triangle.
+	AlignedVector<GeometryReal> vertexX;		///<The coordinates of each distinct vertex.
+	AlignedVector<GeometryReal> vertexY;
+	AlignedVector<GeometryReal> vertexZ;
+	AlignedVector<uint32_t> triangleVertices;	///<The indices of the three vertices of each triangle, triangle by triangle.
+	AlignedVector<double> triangleSizes; 		///<Stores the size of each triangle in the scene, mapped from that triangle's ID.
+	AlignedVector<GeometryReal> centerX;		///<The center point of each triangle.
+	AlignedVector<GeometryReal> centerY;
+	AlignedVector<GeometryReal> centerZ;
+	std::unordered_map<VertexKey, uint32_t, VertexKeyHash> vertexIds;	///<The index of each vertex seen so far. Only used while loading.
+
+	///@return The index of the vertex, adding it if it has not been seen before.
+	uint32_t addVertex(const osg::Vec3d& vertex);
 
 	/**
 	 * Colors the given triangle with the given color, and inserting into the given geode for display.
@@ -71,6 +101,7 @@ public:
 
 	/**
 	 * Calculates the summed area of all the triangles in the scene, and stores them in the "totalArea" variable.
+	 * Also lets go of the memory only needed while triangles are being added.
 	 */
 	void calculateTotalArea();
 
@@ -80,6 +111,24 @@ public:
 	 */
 	osg::ref_ptr<osg::Geode> colorEachTriangleDifferently() const;
 
+	/**
+	 * Makes the vertices and colors of the geode colorEachTriangleDifferently returns: Three vertices for each triangle,
+	 * all with the triangle's color.
+	 */
+	void makeColoredArrays(osg::Vec3Array& vertexArray, osg::Vec3Array& colorArray) const;
+
+	///Makes the geode colorEachTriangleDifferently returns, from arrays made by makeColoredArrays.
+	static osg::ref_ptr<osg::Geode> makeColoredGeode(osg::ref_ptr<osg::Vec3Array> vertexArray, osg::ref_ptr<osg::Vec3Array> colorArray);
+
+	///Stores the triangles in the cache. calculateTotalArea must have been called.
+	void writeTo(SceneCache::Writer& writer) const;
+
+	/**
+	 * Replaces the (empty) store with the triangles in the cache, and calculates their total area.
+	 * @return false if the cache holds no valid triangles. The store is then left empty.
+	 */
+	bool readFrom(const SceneCache& cache);
+
 	/**
 	 * Calculates the percentage of the 3D-model the covered points represent (area-wise).
 	 * The result is a number between 0 and 1, 0 meaning full coverage and 1 meaning no coverage.
@@ -92,22 +141,60 @@ public:
 	double calculateAndColorCoverage(const boost::dynamic_bitset<> &coveredColors, osg::ref_ptr<osg::Geode> g = nullptr,
 									 bool printerFriendly = false) const;
 
+	/**
+	 * Sums the area of the covered triangles. Only visits the set bits, so sparse coverage is summed quickly.
+	 * @param coveredColors A bit for each triangle, set for the covered ones.
+	 * @return The covered area
+	 */
+	double calculateCoveredArea(const boost::dynamic_bitset<> &coveredColors) const;
+
+
 
+	///@return The center of each triangle. Copied out of the arrays, so prefer getTriangleCenter in loops.
+	std::vector<osg::Vec3d> getTriangleCenters() const;
 
-	const std::vector<osg::Vec3d>& getTriangleCenters() const {
-		return triangleCenters;
+	///@return The corners of each triangle. Copied out of the arrays, so prefer getTriangleVertex in loops.
+	std::vector<std::vector<osg::Vec3d> > getTriangles() const;
+
+	osg::Vec3d getTriangleCenter(size_t triangleId) const{
+		return osg::Vec3d(centerX[triangleId], centerY[triangleId], centerZ[triangleId]);
 	}
 
-	const std::vector<std::vector<osg::Vec3d> >& getTriangles() const {
-		return triangles;
+	///@param corner 0, 1 or 2.
+	osg::Vec3d getTriangleVertex(size_t triangleId, int corner) const{
+		return getVertex(getTriangleVertexId(triangleId, corner));
 	}
 
-	const osg::Vec3d& getTriangleCenter(size_t triangleId) const{
-		return triangleCenters[triangleId];
+	///@return The index of a corner of a triangle among the distinct vertices. @param corner 0, 1 or 2.
+	uint32_t getTriangleVertexId(size_t triangleId, int corner) const{
+		return triangleVertices[3*triangleId+corner];
+	}
+
+	///@param vertexId Between 0 and getVertexCount()-1.
+	osg::Vec3d getVertex(size_t vertexId) const{
+		return osg::Vec3d(vertexX[vertexId], vertexY[vertexId], vertexZ[vertexId]);
 	}
 
 	const size_t getTriangleCount() const{
-		return triangles.size();
+		return triangleSizes.size();
+	}
+
+	///@return The number of distinct vertices. Triangles sharing a corner share its vertex.
+	size_t getVertexCount() const{
+		return vertexX.size();
+	}
+
+	double getTriangleArea(size_t triangleId) const{
+		return triangleSizes[triangleId];
+	}
+
+	///@return The area of each triangle, indexed by triangle ID.
+	const AlignedVector<double>& getTriangleAreas() const{
+		return triangleSizes;
+	}
+
+	double getTotalArea() const{
+		return totalArea;
 	}
 
 
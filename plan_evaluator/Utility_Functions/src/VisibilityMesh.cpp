@@ -0,0 +1,416 @@
+/*
+ * VisibilityMesh.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include "VisibilityMesh.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <queue>
+#include <unordered_map>
+
+namespace utility_functions {
+
+namespace {
+	///Borders of open surfaces are held in place by planes through them, weighted this much more than the faces.
+	const double BORDER_WEIGHT = 1000;
+	const uint32_t NO_TRIANGLE = std::numeric_limits<uint32_t>::max();
+
+	/**
+	 * The weighted sum of the squared distances to a set of planes, as a symmetric 4x4 matrix. Adding the quadrics of
+	 * two vertices gives the error of moving both to one point.
+	 */
+	struct Quadric {
+		double a2, ab, ac, ad, b2, bc, bd, c2, cd, d2;
+
+		Quadric()
+		:a2(0), ab(0), ac(0), ad(0), b2(0), bc(0), bd(0), c2(0), cd(0), d2(0){}
+
+		///@param normal The unit normal of the plane. @param point Any point in the plane.
+		void addPlane(const osg::Vec3d& normal, const osg::Vec3d& point, double weight) {
+			double a = normal.x(), b = normal.y(), c = normal.z(), d = -(normal * point);
+			a2 += weight*a*a; ab += weight*a*b; ac += weight*a*c; ad += weight*a*d;
+			b2 += weight*b*b; bc += weight*b*c; bd += weight*b*d;
+			c2 += weight*c*c; cd += weight*c*d;
+			d2 += weight*d*d;
+		}
+
+		void add(const Quadric& other) {
+			a2 += other.a2; ab += other.ab; ac += other.ac; ad += other.ad;
+			b2 += other.b2; bc += other.bc; bd += other.bd;
+			c2 += other.c2; cd += other.cd;
+			d2 += other.d2;
+		}
+
+		double error(const osg::Vec3d& v) const {
+			double x = v.x(), y = v.y(), z = v.z();
+			return a2*x*x + 2*ab*x*y + 2*ac*x*z + 2*ad*x + b2*y*y + 2*bc*y*z + 2*bd*y + c2*z*z + 2*cd*z + d2;
+		}
+
+		///Finds the point with the least error. @return false if there is no single such point, as along a flat area.
+		bool minimize(osg::Vec3d& v) const {
+			double c00 = b2*c2 - bc*bc;
+			double c01 = ac*bc - ab*c2;
+			double c02 = ab*bc - b2*ac;
+			double c11 = a2*c2 - ac*ac;
+			double c12 = ab*ac - a2*bc;
+			double c22 = a2*b2 - ab*ab;
+			double det = a2*c00 + ab*c01 + ac*c02;
+			double trace = a2 + b2 + c2;
+			if (!(std::abs(det) > 1e-10*trace*trace*trace)) {
+				return false;
+			}
+			v = osg::Vec3d(-(c00*ad + c01*bd + c02*cd)/det, -(c01*ad + c11*bd + c12*cd)/det, -(c02*ad + c12*bd + c22*cd)/det);
+			return true;
+		}
+	};
+
+	///Moving two vertices (connected by an edge) to a point, merging them into the first.
+	struct Collapse {
+		double cost;
+		uint32_t kept;
+		uint32_t removed;
+		uint32_t keptStamp;				///<The stamps of the vertices when the collapse was found. Outdated if they differ now.
+		uint32_t removedStamp;
+		osg::Vec3d position;
+
+		bool operator>(const Collapse& other) const {
+			return cost > other.cost;
+		}
+	};
+
+	/**
+	 * The mesh while it is being simplified. Faces are never moved: Collapses mark faces dead, and renumber the corners
+	 * of the faces around them. Each face keeps a linked list of the model's triangles it stands for.
+	 */
+	class Simplifier {
+	private:
+		std::vector<osg::Vec3d> positions;
+		std::vector<Quadric> quadrics;
+		std::vector<uint32_t> stamps;			///<Raised each time a vertex moves, so queued collapses of it can be told outdated.
+		std::vector<char> vertexAlive;
+		std::vector<std::vector<uint32_t> > vertexFaces;	///<The faces around each vertex. May also hold dead faces.
+		std::vector<uint32_t> corners;			///<Three vertices for each face.
+		std::vector<char> faceAlive;
+		std::vector<uint32_t> firstTriangle;	///<The lists of the model's triangles, by face.
+		std::vector<uint32_t> lastTriangle;
+		std::vector<uint32_t> nextTriangle;		///<By triangle. NO_TRIANGLE ends a list.
+		size_t numAliveFaces;
+		std::priority_queue<Collapse, std::vector<Collapse>, std::greater<Collapse> > queue;
+
+		static uint64_t edgeKey(uint32_t a, uint32_t b) {
+			return a < b ? (uint64_t(a) << 32) | b : (uint64_t(b) << 32) | a;
+		}
+
+		bool hasCorner(uint32_t face, uint32_t vertex) const {
+			return corners[3*face] == vertex || corners[3*face+1] == vertex || corners[3*face+2] == vertex;
+		}
+
+		///The (unnormalized) normal of a face, with the given vertices moved to the given position.
+		osg::Vec3d faceNormal(uint32_t face, uint32_t movedVertex, uint32_t otherMovedVertex, const osg::Vec3d& position) const {
+			osg::Vec3d p[3];
+			for (int corner = 0; corner < 3; corner++) {
+				uint32_t vertex = corners[3*face+corner];
+				p[corner] = vertex == movedVertex || vertex == otherMovedVertex ? position : positions[vertex];
+			}
+			return (p[1]-p[0]) ^ (p[2]-p[0]);
+		}
+
+		osg::Vec3d faceNormal(uint32_t face) const {
+			const osg::Vec3d& p0 = positions[corners[3*face]];
+			return (positions[corners[3*face+1]]-p0) ^ (positions[corners[3*face+2]]-p0);
+		}
+
+		///The distinct vertices sharing a living face with the vertex, in increasing order.
+		void collectNeighbors(uint32_t vertex, std::vector<uint32_t>& neighbors) const {
+			neighbors.clear();
+			for (std::vector<uint32_t>::const_iterator face = vertexFaces[vertex].begin(); face != vertexFaces[vertex].end(); face++) {
+				if (!faceAlive[*face]) {
+					continue;
+				}
+				for (int corner = 0; corner < 3; corner++) {
+					if (corners[3*(*face)+corner] != vertex) {
+						neighbors.push_back(corners[3*(*face)+corner]);
+					}
+				}
+			}
+			std::sort(neighbors.begin(), neighbors.end());
+			neighbors.erase(std::unique(neighbors.begin(), neighbors.end()), neighbors.end());
+		}
+
+		///Finds the best point to collapse the edge to, and queues the collapse.
+		void queueCollapse(uint32_t a, uint32_t b) {
+			Quadric quadric = quadrics[a];
+			quadric.add(quadrics[b]);
+			osg::Vec3d midpoint = (positions[a] + positions[b]) * 0.5;
+			osg::Vec3d candidates[4] = {midpoint, positions[a], positions[b], midpoint};
+			int numCandidates = 3;
+			//Points far off the edge come from nearly flat quadrics, and would fold the surface.
+			if (quadric.minimize(candidates[3]) && (candidates[3] - midpoint).length2() <= (positions[a] - positions[b]).length2()) {
+				numCandidates = 4;
+			}
+			Collapse collapse = {std::numeric_limits<double>::max(), a, b, stamps[a], stamps[b], midpoint};
+			for (int candidate = 0; candidate < numCandidates; candidate++) {
+				double error = quadric.error(candidates[candidate]);
+				if (error < collapse.cost) {
+					collapse.cost = error;
+					collapse.position = candidates[candidate];
+				}
+			}
+			collapse.cost = std::max(collapse.cost, 0.0); //Rounding may make the error slightly negative.
+			queue.push(collapse);
+		}
+
+		///Hands the triangles of a dying face to another face.
+		void moveTriangles(uint32_t from, uint32_t to) {
+			nextTriangle[lastTriangle[to]] = firstTriangle[from];
+			lastTriangle[to] = lastTriangle[from];
+			firstTriangle[from] = lastTriangle[from] = NO_TRIANGLE;
+		}
+
+		/**
+		 * Carries out a collapse, unless it would change the topology of the mesh or fold a face over.
+		 * @return true if the edge was collapsed.
+		 */
+		bool tryCollapse(const Collapse& collapse) {
+			uint32_t kept = collapse.kept;
+			uint32_t removed = collapse.removed;
+			//The faces on the edge die. The other faces around its ends stay, moving one corner.
+			std::vector<uint32_t> dying;
+			std::vector<uint32_t> moving;
+			for (std::vector<uint32_t>::const_iterator face = vertexFaces[removed].begin(); face != vertexFaces[removed].end(); face++) {
+				if (faceAlive[*face]) {
+					(hasCorner(*face, kept) ? dying : moving).push_back(*face);
+				}
+			}
+			if (dying.empty()) {
+				return false;
+			}
+			for (std::vector<uint32_t>::const_iterator face = vertexFaces[kept].begin(); face != vertexFaces[kept].end(); face++) {
+				if (faceAlive[*face] && !hasCorner(*face, removed)) {
+					moving.push_back(*face);
+				}
+			}
+			if (moving.empty()) {
+				return false; //The edge is all there is left of its part of the mesh.
+			}
+
+			//Merging two vertices with more shared neighbors than faces on the edge would pinch the surface.
+			std::vector<uint32_t> keptNeighbors, removedNeighbors, sharedNeighbors;
+			collectNeighbors(kept, keptNeighbors);
+			collectNeighbors(removed, removedNeighbors);
+			std::set_intersection(keptNeighbors.begin(), keptNeighbors.end(), removedNeighbors.begin(), removedNeighbors.end(),
+					std::back_inserter(sharedNeighbors));
+			if (sharedNeighbors.size() > dying.size()) {
+				return false;
+			}
+			for (std::vector<uint32_t>::const_iterator face = moving.begin(); face != moving.end(); face++) {
+				osg::Vec3d oldNormal = faceNormal(*face);
+				if (oldNormal.length2() > 0 && faceNormal(*face, kept, removed, collapse.position) * oldNormal <= 0) {
+					return false;
+				}
+			}
+
+			//The triangles of each dying face go to a face across one of its other edges, if there is one.
+			std::vector<uint32_t> heirs;
+			for (std::vector<uint32_t>::const_iterator face = dying.begin(); face != dying.end(); face++) {
+				uint32_t heir = moving.front();
+				for (int corner = 0; corner < 3; corner++) {
+					uint32_t vertex = corners[3*(*face)+corner];
+					if (vertex == kept || vertex == removed) {
+						continue;
+					}
+					for (std::vector<uint32_t>::const_iterator neighbor = moving.begin(); neighbor != moving.end(); neighbor++) {
+						if (hasCorner(*neighbor, vertex)) {
+							heir = *neighbor;
+							break;
+						}
+					}
+				}
+				heirs.push_back(heir);
+			}
+
+			positions[kept] = collapse.position;
+			quadrics[kept].add(quadrics[removed]);
+			for (size_t d = 0; d < dying.size(); d++) {
+				faceAlive[dying[d]] = 0;
+				numAliveFaces--;
+				moveTriangles(dying[d], heirs[d]);
+			}
+			std::vector<uint32_t> keptFaces;
+			for (std::vector<uint32_t>::const_iterator face = vertexFaces[kept].begin(); face != vertexFaces[kept].end(); face++) {
+				if (faceAlive[*face]) {
+					keptFaces.push_back(*face);
+				}
+			}
+			for (std::vector<uint32_t>::const_iterator face = vertexFaces[removed].begin(); face != vertexFaces[removed].end(); face++) {
+				if (faceAlive[*face]) {
+					for (int corner = 0; corner < 3; corner++) {
+						if (corners[3*(*face)+corner] == removed) {
+							corners[3*(*face)+corner] = kept;
+						}
+					}
+					keptFaces.push_back(*face);
+				}
+			}
+			vertexFaces[kept].swap(keptFaces);
+			std::vector<uint32_t>().swap(vertexFaces[removed]);
+			vertexAlive[removed] = 0;
+			stamps[kept]++;
+
+			collectNeighbors(kept, keptNeighbors);
+			for (std::vector<uint32_t>::const_iterator neighbor = keptNeighbors.begin(); neighbor != keptNeighbors.end(); neighbor++) {
+				queueCollapse(kept, *neighbor);
+			}
+			return true;
+		}
+
+	public:
+		explicit Simplifier(const TriangleData& model)
+		:positions(model.getVertexCount()),
+		 quadrics(model.getVertexCount()),
+		 stamps(model.getVertexCount(), 0),
+		 vertexAlive(model.getVertexCount(), 1),
+		 vertexFaces(model.getVertexCount()),
+		 corners(3*model.getTriangleCount()),
+		 faceAlive(model.getTriangleCount(), 1),
+		 firstTriangle(model.getTriangleCount()),
+		 lastTriangle(model.getTriangleCount()),
+		 nextTriangle(model.getTriangleCount(), NO_TRIANGLE),
+		 numAliveFaces(model.getTriangleCount()){
+			for (size_t vertex = 0; vertex < positions.size(); vertex++) {
+				positions[vertex] = model.getVertex(vertex);
+			}
+			//Each vertex starts with the planes of the faces around it, weighted by their area.
+			std::unordered_map<uint64_t, uint32_t> edgeFaceCounts;
+			for (uint32_t face = 0; face < numAliveFaces; face++) {
+				firstTriangle[face] = lastTriangle[face] = face;
+				for (int corner = 0; corner < 3; corner++) {
+					corners[3*face+corner] = model.getTriangleVertexId(face, corner);
+				}
+				for (int corner = 0; corner < 3; corner++) {
+					uint32_t vertex = corners[3*face+corner];
+					uint32_t nextVertex = corners[3*face+(corner+1)%3];
+					//Degenerate triangles may use a vertex twice. They are carried along, but never give an edge to itself.
+					if (std::find(corners.begin()+3*face, corners.begin()+3*face+corner, vertex) == corners.begin()+3*face+corner) {
+						vertexFaces[vertex].push_back(face);
+					}
+					if (vertex != nextVertex) {
+						edgeFaceCounts[edgeKey(vertex, nextVertex)]++;
+					}
+				}
+				osg::Vec3d normal = faceNormal(face);
+				double doubleArea = normal.length();
+				if (doubleArea > 0) {
+					normal /= doubleArea;
+					for (int corner = 0; corner < 3; corner++) {
+						quadrics[corners[3*face+corner]].addPlane(normal, positions[corners[3*face]], doubleArea/2);
+					}
+				}
+			}
+			//Edges with a face on only one side are borders. Planes through them, perpendicular to the face, keep them in place.
+			for (uint32_t face = 0; face < numAliveFaces; face++) {
+				osg::Vec3d normal = faceNormal(face);
+				if (normal.length2() == 0) {
+					continue;
+				}
+				normal.normalize();
+				for (int corner = 0; corner < 3; corner++) {
+					uint32_t vertex = corners[3*face+corner];
+					uint32_t nextVertex = corners[3*face+(corner+1)%3];
+					if (vertex == nextVertex || edgeFaceCounts[edgeKey(vertex, nextVertex)] != 1) {
+						continue;
+					}
+					osg::Vec3d edge = positions[nextVertex] - positions[vertex];
+					osg::Vec3d borderNormal = edge ^ normal;
+					borderNormal.normalize();
+					quadrics[vertex].addPlane(borderNormal, positions[vertex], BORDER_WEIGHT*edge.length2());
+					quadrics[nextVertex].addPlane(borderNormal, positions[vertex], BORDER_WEIGHT*edge.length2());
+				}
+			}
+			for (std::unordered_map<uint64_t, uint32_t>::const_iterator edge = edgeFaceCounts.begin(); edge != edgeFaceCounts.end(); edge++) {
+				queueCollapse(edge->first >> 32, edge->first & 0xffffffff);
+			}
+		}
+
+		///Collapses the cheapest edges until at most targetFaceCount faces are left, or no edge may be collapsed.
+		void simplify(size_t targetFaceCount) {
+			while (numAliveFaces > targetFaceCount && !queue.empty()) {
+				Collapse collapse = queue.top();
+				queue.pop();
+				if (vertexAlive[collapse.kept] && vertexAlive[collapse.removed] && stamps[collapse.kept] == collapse.keptStamp
+						&& stamps[collapse.removed] == collapse.removedStamp) {
+					tryCollapse(collapse);
+				}
+			}
+		}
+
+		/**
+		 * Hands over the living faces, in the order they had in the model.
+		 * @param[out] faces The corners of each face, three by three.
+		 * @param[out] triangles The model's triangles of each face, in increasing order.
+		 */
+		void getFaces(std::vector<osg::Vec3d>& faces, std::vector<std::vector<uint32_t> >& triangles) const {
+			for (uint32_t face = 0; face < faceAlive.size(); face++) {
+				if (!faceAlive[face]) {
+					continue;
+				}
+				for (int corner = 0; corner < 3; corner++) {
+					faces.push_back(positions[corners[3*face+corner]]);
+				}
+				triangles.push_back(std::vector<uint32_t>());
+				for (uint32_t triangle = firstTriangle[face]; triangle != NO_TRIANGLE; triangle = nextTriangle[triangle]) {
+					triangles.back().push_back(triangle);
+				}
+				std::sort(triangles.back().begin(), triangles.back().end());
+			}
+		}
+	};
+}
+
+VisibilityMesh::VisibilityMesh(const TriangleData& model, size_t targetFaceCount)
+:numOriginalTriangles(model.getTriangleCount()){
+	std::vector<osg::Vec3d> faceCorners;
+	std::vector<std::vector<uint32_t> > faceTriangles;
+	{
+		Simplifier simplifier(model);
+		simplifier.simplify(targetFaceCount);
+		simplifier.getFaces(faceCorners, faceTriangles);
+	}
+	firstOriginalTriangle.reserve(faceTriangles.size() + 1);
+	originalTriangles.reserve(numOriginalTriangles);
+	faceAreas.reserve(faceTriangles.size());
+	for (size_t faceId = 0; faceId < faceTriangles.size(); faceId++) {
+		faces(faceCorners[3*faceId], faceCorners[3*faceId+1], faceCorners[3*faceId+2], false);
+		firstOriginalTriangle.push_back(originalTriangles.size());
+		double area = 0;
+		for (std::vector<uint32_t>::const_iterator triangle = faceTriangles[faceId].begin(); triangle != faceTriangles[faceId].end(); triangle++) {
+			originalTriangles.push_back(*triangle);
+			area += model.getTriangleArea(*triangle);
+		}
+		faceAreas.push_back(area);
+	}
+	firstOriginalTriangle.push_back(originalTriangles.size());
+	faces.calculateTotalArea();
+	std::cout << "Simplified the " << numOriginalTriangles << " triangles of the model into " << getFaceCount()
+			<< " faces for estimating coverage" << std::endl;
+}
+
+boost::dynamic_bitset<> VisibilityMesh::expandCoverage(const boost::dynamic_bitset<>& coveredFaces) const {
+	boost::dynamic_bitset<> coveredTriangles(numOriginalTriangles);
+	for (size_t faceId = coveredFaces.find_first(); faceId != boost::dynamic_bitset<>::npos && faceId < getFaceCount();
+			faceId = coveredFaces.find_next(faceId)) {
+		for (uint32_t i = firstOriginalTriangle[faceId]; i < firstOriginalTriangle[faceId + 1]; i++) {
+			coveredTriangles.set(originalTriangles[i]);
+		}
+	}
+	return coveredTriangles;
+}
+
+} /* namespace utility_functions */
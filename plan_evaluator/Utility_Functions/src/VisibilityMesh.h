@@ -0,0 +1,78 @@
+/*
+ * VisibilityMesh.h
+ *
+ * A simplified copy of the inspection target, rendered instead of the full model when estimating coverage during
+ * optimization. Each of its faces stands for a set of the model's triangles.
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef VISIBILITYMESH_H_
+#define VISIBILITYMESH_H_
+
+#include <boost/dynamic_bitset/dynamic_bitset.hpp>
+#include <osg/Geode>
+#include <osg/ref_ptr>
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+#include "TriangleData.h"
+
+namespace utility_functions {
+
+/**
+ * Made by quadric edge collapse (Garland and Heckbert): Edges are collapsed in order of how far they move the surface,
+ * so flat and smooth areas lose most of their triangles, while edges, corners and the borders of open surfaces are kept.
+ * Each triangle of the model belongs to exactly one face: When a collapse removes a face, its triangles are handed to
+ * a neighboring face. The faces are colored with their own IDs, like TriangleData::colorEachTriangleDifferently does
+ * with triangle IDs, so the colors seen when rendering it can be expanded into the triangles of the model, and scored
+ * with their areas.
+ */
+class VisibilityMesh {
+
+private:
+	TriangleData faces;							///<The faces of the simplified mesh, indexed by face ID.
+	std::vector<uint32_t> firstOriginalTriangle;	///<Where the triangles of each face start in originalTriangles. One more than the faces.
+	std::vector<uint32_t> originalTriangles;	///<The IDs of the model's triangles each face stands for, face by face, in increasing order.
+	std::vector<double> faceAreas;				///<The summed area of the model's triangles each face stands for.
+	size_t numOriginalTriangles;
+
+	VisibilityMesh(const VisibilityMesh&) = delete;
+	VisibilityMesh& operator=(const VisibilityMesh&) = delete;
+
+public:
+
+	/**
+	 * Simplifies the triangles of a model.
+	 * @param model The triangles of the model. calculateTotalArea must have been called.
+	 * @param targetFaceCount The number of faces to simplify down to. Fewer are made if the model has fewer triangles,
+	 * and more if collapsing further would fold the surface over itself.
+	 */
+	VisibilityMesh(const TriangleData& model, size_t targetFaceCount);
+
+	size_t getFaceCount() const {
+		return faceAreas.size();
+	}
+
+	///@return The summed area of the model's triangles the face stands for.
+	double getFaceArea(size_t faceId) const {
+		return faceAreas[faceId];
+	}
+
+	///The scene to render instead of the model: Each face colored with its own ID.
+	osg::ref_ptr<osg::Geode> colorEachFaceDifferently() const {
+		return faces.colorEachTriangleDifferently();
+	}
+
+	/**
+	 * Finds the model's triangles standing behind the faces seen.
+	 * @param coveredFaces A bit for each face, set for the seen ones.
+	 * @return A bit for each triangle of the model, set for those belonging to a seen face.
+	 */
+	boost::dynamic_bitset<> expandCoverage(const boost::dynamic_bitset<>& coveredFaces) const;
+};
+
+} /* namespace utility_functions */
+
+#endif /* VISIBILITYMESH_H_ */
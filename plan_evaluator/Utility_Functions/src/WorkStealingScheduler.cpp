@@ -0,0 +1,137 @@
+/*
+ * WorkStealingScheduler.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include "WorkStealingScheduler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <stdexcept>
+#include <thread>
+
+#include "ThreadPool.h"
+
+namespace utility_functions {
+
+WorkStealingScheduler::WorkStealingScheduler(ThreadPool& threadPool, size_t maxSubtaskSize)
+:threadPool(threadPool),
+ maxSubtaskSize(maxSubtaskSize){
+	if (maxSubtaskSize == 0) {
+		throw std::invalid_argument("ERROR! Subtasks must have room for at least one item.");
+	}
+}
+
+void WorkStealingScheduler::pushSubtask(WorkerQueue& queue, const Subtask& subtask, unsigned long& maxQueueDepth) {
+	std::lock_guard<std::mutex> lock(queue.mutex);
+	queue.subtasks.push_back(subtask);
+	maxQueueDepth = std::max<unsigned long>(maxQueueDepth, queue.subtasks.size());
+}
+
+bool WorkStealingScheduler::takeSubtask(std::vector<WorkerQueue>& queues, size_t workerIndex, Subtask& subtask,
+		SchedulingStatistics& statistics) {
+	{
+		WorkerQueue& ownQueue = queues[workerIndex];
+		std::lock_guard<std::mutex> lock(ownQueue.mutex);
+		if (!ownQueue.subtasks.empty()) {
+			subtask = ownQueue.subtasks.back();
+			ownQueue.subtasks.pop_back();
+			return true;
+		}
+	}
+	//Stealing the oldest subtask of the next worker that has one. Old subtasks are the large ones, so thieves
+	//come back less often.
+	for (size_t offset = 1; offset < queues.size(); offset++) {
+		WorkerQueue& victim = queues[(workerIndex + offset) % queues.size()];
+		std::lock_guard<std::mutex> lock(victim.mutex);
+		if (!victim.subtasks.empty()) {
+			subtask = victim.subtasks.front();
+			victim.subtasks.pop_front();
+			statistics.steals++;
+			return true;
+		}
+	}
+	return false;
+}
+
+SchedulingStatistics WorkStealingScheduler::run(const std::vector<size_t>& jobSizes,
+		const std::function<void(size_t job, size_t begin, size_t end, size_t workerIndex)>& work) {
+	size_t numWorkers = threadPool.size();
+	std::vector<WorkerQueue> queues(numWorkers);
+	std::vector<SchedulingStatistics> workerStatistics(numWorkers);
+	size_t totalItems = 0;
+	//Dealing the jobs out evenly. Stealing evens out the differences in job size.
+	for (size_t job = 0; job < jobSizes.size(); job++) {
+		if (jobSizes[job] == 0) {
+			continue;
+		}
+		Subtask subtask = {job, 0, jobSizes[job]};
+		size_t owner = job % numWorkers;
+		pushSubtask(queues[owner], subtask, workerStatistics[owner].maxQueueDepth);
+		totalItems += jobSizes[job];
+	}
+	std::atomic<size_t> remainingItems(totalItems);
+
+	//Workers finding no subtask to take sleep until another worker splits off more work, or all items are done.
+	std::mutex idleMutex;
+	std::condition_variable idleWorkers;
+	unsigned long numPushes = 0;	//The number of subtasks split off so far. Guarded by idleMutex.
+	auto finishItems = [&](size_t numItems) {
+		if ((remainingItems -= numItems) == 0) {
+			std::lock_guard<std::mutex> lock(idleMutex);
+			idleWorkers.notify_all();
+		}
+	};
+
+	threadPool.parallelFor(numWorkers, [&](size_t, size_t workerIndex) {
+		SchedulingStatistics& statistics = workerStatistics[workerIndex];
+		while (remainingItems.load() > 0) {
+			unsigned long pushesSeen;
+			{
+				std::lock_guard<std::mutex> lock(idleMutex);
+				pushesSeen = numPushes;
+			}
+			Subtask subtask;
+			if (!takeSubtask(queues, workerIndex, subtask, statistics)) {
+				//All remaining items are being worked on by others, but they may still split off more work.
+				std::unique_lock<std::mutex> lock(idleMutex);
+				idleWorkers.wait(lock, [&]() { return remainingItems.load() == 0 || numPushes != pushesSeen; });
+				continue;
+			}
+			//Keeping the first half of large subtasks, and leaving the rest for us or a thief.
+			while (subtask.end - subtask.begin > maxSubtaskSize) {
+				size_t middle = subtask.begin + (subtask.end - subtask.begin) / 2;
+				Subtask secondHalf = {subtask.job, middle, subtask.end};
+				pushSubtask(queues[workerIndex], secondHalf, statistics.maxQueueDepth);
+				subtask.end = middle;
+				{
+					std::lock_guard<std::mutex> lock(idleMutex);
+					numPushes++;
+				}
+				idleWorkers.notify_one();
+			}
+			statistics.subtasksRun++;
+			try {
+				work(subtask.job, subtask.begin, subtask.end, workerIndex);
+			} catch (...) {
+				//Counting the items as done, so run still returns once the other workers have done theirs, or have
+				//failed too. The thread pool rethrows the exception.
+				finishItems(subtask.end - subtask.begin);
+				throw;
+			}
+			finishItems(subtask.end - subtask.begin);
+		}
+	});
+
+	SchedulingStatistics total;
+	for (std::vector<SchedulingStatistics>::const_iterator statistics = workerStatistics.begin(); statistics != workerStatistics.end(); statistics++) {
+		total.subtasksRun += statistics->subtasksRun;
+		total.steals += statistics->steals;
+		total.maxQueueDepth = std::max(total.maxQueueDepth, statistics->maxQueueDepth);
+	}
+	return total;
+}
+
+} /* namespace utility_functions */
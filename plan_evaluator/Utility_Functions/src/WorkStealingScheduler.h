@@ -0,0 +1,84 @@
+/*
+ * WorkStealingScheduler.h
+ *
+ * Spreads jobs of very different sizes over the threads of a ThreadPool. Each job is a range of work items (such as
+ * the sampling positions along an edge). Every worker has its own queue of item ranges. Workers split large ranges
+ * in half as they take them, leaving one half in their queue, and workers with empty queues steal from the others.
+ * That way, a few long jobs at the end of a batch do not leave most threads idle.
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef WORKSTEALINGSCHEDULER_H_
+#define WORKSTEALINGSCHEDULER_H_
+
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <stddef.h>
+#include <vector>
+
+namespace utility_functions {
+
+class ThreadPool;
+
+/**
+ * Counts the scheduling done in one call to WorkStealingScheduler::run.
+ */
+struct SchedulingStatistics {
+	unsigned long subtasksRun;	///<The number of item ranges handed to the work function.
+	unsigned long steals;		///<The number of item ranges taken from another worker's queue.
+	unsigned long maxQueueDepth;	///<The largest number of item ranges waiting in any one queue.
+
+	SchedulingStatistics()
+	:subtasksRun(0), steals(0), maxQueueDepth(0){}
+};
+
+class WorkStealingScheduler {
+
+private:
+	///A range of the items of one job: [begin, end).
+	struct Subtask {
+		size_t job;
+		size_t begin;
+		size_t end;
+	};
+
+	///The queue of one worker. The owner takes from the back, thieves take from the front.
+	struct WorkerQueue {
+		std::mutex mutex;
+		std::deque<Subtask> subtasks;
+	};
+
+	ThreadPool& threadPool;
+	size_t maxSubtaskSize;	///<Ranges larger than this are split before they are run.
+
+	///Takes a subtask from the given worker's own queue, or failing that, steals one from another worker.
+	bool takeSubtask(std::vector<WorkerQueue>& queues, size_t workerIndex, Subtask& subtask, SchedulingStatistics& statistics);
+
+	///Pushes a subtask to a worker's queue, and notes the queue depth.
+	static void pushSubtask(WorkerQueue& queue, const Subtask& subtask, unsigned long& maxQueueDepth);
+
+public:
+
+	/**
+	 * @param threadPool The threads to run jobs on.
+	 * @param maxSubtaskSize The largest number of items the work function is given at once. Must be at least 1.
+	 */
+	WorkStealingScheduler(ThreadPool& threadPool, size_t maxSubtaskSize);
+
+	/**
+	 * Runs work(job, begin, end, workerIndex) over all items of all jobs, and waits until all items are done.
+	 * Each item is given to the work function exactly once. The items of one job may be done by several workers,
+	 * so the work function should collect results per worker, and the caller merge them afterwards.
+	 * @param jobSizes The number of items in each job.
+	 * @param work The work function.
+	 * @return Statistics on how the work was scheduled.
+	 */
+	SchedulingStatistics run(const std::vector<size_t>& jobSizes,
+			const std::function<void(size_t job, size_t begin, size_t end, size_t workerIndex)>& work);
+};
+
+} /* namespace utility_functions */
+
+#endif /* WORKSTEALINGSCHEDULER_H_ */
@@ -2,10 +2,22 @@
 %include "std_vector.i"
 %include "std_string.i"
 %include typemaps.i
+%include "exception.i"
 
 %{
 #define SWIG_FILE_WITH_INIT
 #include "../../plan_evaluator/Evaluator/src/PlanCoverageEstimator.h"
+
+//Releases the Python interpreter lock for as long as it lives, so other Python threads can run during long C++ calls.
+class ReleasePythonLock {
+private:
+	PyThreadState* savedState;
+public:
+	ReleasePythonLock() : savedState(PyEval_SaveThread()) {}
+	~ReleasePythonLock() {
+		PyEval_RestoreThread(savedState);
+	}
+};
 %}
 
 
@@ -16,24 +28,68 @@ namespace std {
 %template(StringVector) vector < string >;
 }
 
+//Turning C++ exceptions into Python exceptions, rather than letting them take down the interpreter.
+%exception {
+	try {
+		$action
+	} catch (const std::invalid_argument& e) {
+		SWIG_exception(SWIG_ValueError, e.what());
+	} catch (const std::exception& e) {
+		SWIG_exception(SWIG_RuntimeError, e.what());
+	}
+}
+
+//Batch evaluations do not touch Python objects while evaluating, so they run without holding the interpreter lock.
+//The lock is taken back before any exception is turned into a Python exception.
+%exception evolutionary_inspection_plan_evaluation::PlanCoverageEstimator::evaluatePlans {
+	try {
+		ReleasePythonLock unlocked;
+		$action
+	} catch (const std::invalid_argument& e) {
+		SWIG_exception(SWIG_ValueError, e.what());
+	} catch (const std::exception& e) {
+		SWIG_exception(SWIG_RuntimeError, e.what());
+	}
+}
+
 //enum defining the ways we may plot plans to screen
 enum plotting_style {normal, circulating, image, nothing};
+//enum defining the ways plans can be edited in evaluateMutation
+enum plan_edit_type {remove_gene, replace_gene, insert_gene};
+
+//Statistics on the work done by the evaluator. Wrapped from the header itself, so the fields are only listed there.
+%include "../../plan_evaluator/Evaluator/src/EvaluationStatistics.h"
 
 namespace evolutionary_inspection_plan_evaluation {
+
 std::vector<std::vector<double> > viewMatrixSelector(std::string sceneFileName);
 
 
 class PlanCoverageEstimator{
 public:
 
-PlanCoverageEstimator(const std::string& sceneFileName, const std::vector<double>& sensorSpecs, bool postProcessing = false,const std::vector<double>* startLocation = NULL, bool planLoopsAround = false,  bool printerFriendly = true);
+PlanCoverageEstimator(const std::string& sceneFileName, const std::vector<double>& sensorSpecs, bool postProcessing = false,const std::vector<double>* startLocation = NULL, bool planLoopsAround = false,  bool printerFriendly = true, double visibilityMeshFaceFraction = 1.0);
 
 std::vector<double> evaluatePlan(const std::vector<std::vector<double> >& plan, bool memoization, plotting_style how_to_plot, bool disableEnergyLimit = False);
+std::vector<std::vector<double> > evaluatePlans(const std::vector<std::vector<std::vector<double> > >& plans, bool memoization, bool disableEnergyLimit = False);
+void setNumThreads(int numThreads);
+int getNumThreads() const;
 int getNumberOfBoxes() const;
 int updateMemoisedEdges(const std::vector<std::vector<std::vector<double> > >& allSolutions);
+void startSpeculativePrefetch(const std::vector<std::vector<std::vector<double> > >& elitePlans, int edgeBudget);
+void stopSpeculativePrefetch();
+void attachSharedEdgeCache(const std::string& name, int capacity);
+static bool removeSharedEdgeCache(const std::string& name);
+int registerParentPlan(const std::vector<std::vector<double> >& plan);
+std::vector<double> evaluateMutation(int parentHandle, const std::vector<std::vector<double> >& editOps);
+void releaseParentPlan(int parentHandle);
+EvaluationStatistics getStatistics() const;
+EvaluationStatistics getLastCallStatistics() const;
+void resetStatistics();
 std::vector<std::vector<std::vector<double> > > getSimplePlans() const;
 void storePlanImage(const std::vector<std::vector<double> >& plan, const std::vector<std::vector<double> >& viewMatrix, const std::string storagePath);
 double getMaxAllowedEnergy() const;
+int getVisibilityMeshFaceCount() const;
 //This is how SWIG turns a C++ return by reference into a Python multiple-argument return. Called in python like: [a, b] = interpretAndExportPlan(plan, [], [])
 void interpretAndExportPlan(const std::vector<std::vector<double> >& plan, std::vector<std::vector<double> > &INOUT, std::vector<std::vector<double> > &INOUT);
 };
@@ -18,15 +18,27 @@ setup.py file for SWIG
 #3. All source files we want to compile (sources)
 eval_module = Extension('_cpp_binding',
                         include_dirs= [os.path.realpath(MOEA_COVERAGE_FOLDER), os.path.realpath(COMMON_SOURCES_FOLDER), "/usr/include/boost/"],
-                        libraries = ['osg','osgViewer','osgSim','osgUtil','osgDB','osgGA','osgText', 'boost_serialization', 'boost_filesystem', 'OpenThreads'],
+                        libraries = ['osg','osgViewer','osgSim','osgUtil','osgDB','osgGA','osgText', 'boost_serialization', 'boost_filesystem', 'OpenThreads', 'rt', 'pthread'],
 #, 'gsl',
                                      #'gslcblas', 'm', 'pthread',  'glpk', 'OpenThreads'], #'boost', 'emon',, gurobilib, 'gurobi_c++', 'GurobiJni60'
                            sources=['cpp_binding_wrap.cxx',os.path.realpath(MOEA_COVERAGE_FOLDER)+'/PlanCoverageEstimator.cpp',
                                     os.path.realpath(COMMON_SOURCES_FOLDER)+'/GeodeFinder.cpp',os.path.realpath(COMMON_SOURCES_FOLDER)+'/SceneKeeper.cpp',
                                    os.path.realpath(MOEA_COVERAGE_FOLDER)+'/PlanInterpreterBoxOrder.cpp',os.path.realpath(COMMON_SOURCES_FOLDER)+'/TriangleData.cpp',os.path.realpath(COMMON_SOURCES_FOLDER)+'/CameraEstimator.cpp',
                                     os.path.realpath(COMMON_SOURCES_FOLDER)+'/ImageViewerCaptureTool.cpp', os.path.realpath(COMMON_SOURCES_FOLDER)+'/KeyboardInputHandler.cpp',os.path.realpath(MOEA_COVERAGE_FOLDER)+'/ContourTracing.cpp'
-                                    , os.path.realpath(COMMON_SOURCES_FOLDER)+'/OsgHelpers.cpp',os.path.realpath(MOEA_COVERAGE_FOLDER)+'/PlanEnergyEvaluator.cpp', os.path.realpath(COMMON_SOURCES_FOLDER)+'/HelperMethods.cpp']
-                                    ,extra_compile_args=["-O2", "-std=c++11"] ,extra_link_args=["-O2"]#Enabling O2 optimization (think it is on by default too). See http://stackoverflow.com/questions/6928110/how-may-i-override-the-compiler-gcc-flags-that-setup-py-uses-by-default
+                                    , os.path.realpath(COMMON_SOURCES_FOLDER)+'/OsgHelpers.cpp',os.path.realpath(MOEA_COVERAGE_FOLDER)+'/PlanEnergyEvaluator.cpp', os.path.realpath(COMMON_SOURCES_FOLDER)+'/HelperMethods.cpp',
+                                    os.path.realpath(COMMON_SOURCES_FOLDER)+'/SharedEdgeCache.cpp',
+                                    os.path.realpath(COMMON_SOURCES_FOLDER)+'/CoveragePatternPool.cpp', os.path.realpath(MOEA_COVERAGE_FOLDER)+'/EdgeCoverageMemo.cpp',
+                                    os.path.realpath(MOEA_COVERAGE_FOLDER)+'/PlanResultCache.cpp',
+                                    os.path.realpath(MOEA_COVERAGE_FOLDER)+'/PlanPrefixTrie.cpp', os.path.realpath(COMMON_SOURCES_FOLDER)+'/ThreadPool.cpp',
+                                    os.path.realpath(COMMON_SOURCES_FOLDER)+'/WorkStealingScheduler.cpp', os.path.realpath(COMMON_SOURCES_FOLDER)+'/NumaTopology.cpp',
+                                    os.path.realpath(COMMON_SOURCES_FOLDER)+'/CollisionEngine.cpp',
+                                    os.path.realpath(COMMON_SOURCES_FOLDER)+'/DistanceField.cpp',
+                                    os.path.realpath(COMMON_SOURCES_FOLDER)+'/AnyHitPolytopeIntersector.cpp',
+                                    os.path.realpath(MOEA_COVERAGE_FOLDER)+'/SceneRegistry.cpp',
+                                    os.path.realpath(MOEA_COVERAGE_FOLDER)+'/BoxCollisionMatrix.cpp',
+                                    os.path.realpath(COMMON_SOURCES_FOLDER)+'/SceneCache.cpp',
+                                    os.path.realpath(COMMON_SOURCES_FOLDER)+'/VisibilityMesh.cpp']
+                                    ,extra_compile_args=["-O2", "-std=c++11", "-pthread"] ,extra_link_args=["-O2", "-pthread"]#Enabling O2 optimization (think it is on by default too). See http://stackoverflow.com/questions/6928110/how-may-i-override-the-compiler-gcc-flags-that-setup-py-uses-by-default
                         )
 
 setup (name = 'cpp_binding',
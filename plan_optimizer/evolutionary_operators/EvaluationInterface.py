@@ -1,14 +1,35 @@
 __author__ = 'kaiolae'
 
 from cpp_wrapper import cpp_binding
+from EvaluationServiceClient import EvaluationServiceClient
 
 # An interface to make my Python and C++ code less dependent.
 
 def generateEvaluator(sceneFile, sensorParams, postProcessing = False, startLocation = None,
                       planLoopsAround = False,
-                      printerFriendly = False):
+                      printerFriendly = False, sharedEdgeCacheName = None, sharedEdgeCacheCapacity = 20000,
+                      numThreads = 0, serviceSocket = None, visibilityMeshFaceFraction = 1.0):
 
+    if serviceSocket is not None:
+        # Client mode: Plans are sent to an evaluation service already running on this host (see evaluationServiceRunner.cpp),
+        # which several experiments can share. The service has its own threads and edge cache, set when it was started.
+        if postProcessing:
+            raise ValueError("The evaluation service does not support post-processing.")
+        return EvaluationServiceClient(serviceSocket, sceneFile, sensorParams, startLocation, planLoopsAround,
+                                       visibilityMeshFaceFraction)
 
+    # With a visibilityMeshFaceFraction below 1, a simplified model is rendered outside post-processing. See Parameters.py.
     evaluator = cpp_binding.PlanCoverageEstimator(sceneFile, sensorParams, postProcessing, startLocation,
-                                                planLoopsAround, printerFriendly)
+                                                planLoopsAround, printerFriendly, visibilityMeshFaceFraction)
+    if sharedEdgeCacheName is not None:
+        # Lets evaluators in several processes reuse each other's memoized edges.
+        evaluator.attachSharedEdgeCache(sharedEdgeCacheName, sharedEdgeCacheCapacity)
+    # The number of threads evaluatePlans spreads batches of plans over. 0 means one per hardware thread.
+    evaluator.setNumThreads(numThreads)
     return evaluator
+
+def removeSharedEdgeCache(sharedEdgeCacheName):
+    # Unlinks the shared memory table of memoized edges, which otherwise outlives the experiment in /dev/shm.
+    # Processes still attached keep their table, but evaluators made later start with an empty one.
+    if sharedEdgeCacheName is not None:
+        cpp_binding.PlanCoverageEstimator.removeSharedEdgeCache(sharedEdgeCacheName)
@@ -0,0 +1,152 @@
+__author__ = 'kaiolae'
+
+import socket
+import struct
+import os
+
+from cpp_wrapper.cpp_binding import nothing #plotting_style
+from settings.Constants_and_Datastructures import evaluationStatisticsCounters, evaluationStatisticsTimes
+
+# A stand-in for the C++ PlanCoverageEstimator, which sends plans to an evaluation service (evaluationServiceRunner.cpp)
+# over a UNIX socket instead of evaluating them in this process. Several optimizer processes can thus share one warm
+# evaluator per host. The wire protocol is described in EvaluationService.h.
+
+PROTOCOL_VERSION = 3
+
+# Request types, as in service_protocol::request_type.
+HELLO = 1
+EVALUATE_PLANS = 2
+EVALUATE_PLAN = 3
+GET_NUMBER_OF_BOXES = 4
+GET_MAX_ALLOWED_ENERGY = 5
+GET_SIMPLE_PLANS = 6
+UPDATE_MEMOISED_EDGES = 7
+GET_STATISTICS = 8
+GET_VISIBILITY_MESH_FACE_COUNT = 9
+
+STATUS_OK = 0
+
+
+class EvaluationServiceError(Exception):
+    pass
+
+
+class EvaluationStatistics(object):
+    # Has the same fields as the C++ EvaluationStatistics, so the two can be used interchangeably.
+    def __init__(self, values):
+        for name, value in values.items():
+            setattr(self, name, value)
+
+
+def _packDoubles(values):
+    return struct.pack("=I%dd" % len(values), len(values), *values)
+
+def _packPlan(plan):
+    return struct.pack("=I", len(plan)) + "".join(_packDoubles(gene) for gene in plan)
+
+def _packPlans(plans):
+    return struct.pack("=I", len(plans)) + "".join(_packPlan(plan) for plan in plans)
+
+
+class _PayloadReader(object):
+    def __init__(self, payload):
+        self.payload = payload
+        self.position = 0
+
+    def read(self, format):
+        values = struct.unpack_from("=" + format, self.payload, self.position)
+        self.position += struct.calcsize("=" + format)
+        return values
+
+    def readDoubles(self):
+        (length,) = self.read("I")
+        return list(self.read("%dd" % length))
+
+    def readPlans(self):
+        plans = []
+        (numPlans,) = self.read("I")
+        for _ in range(numPlans):
+            (numGenes,) = self.read("I")
+            plans.append([self.readDoubles() for _ in range(numGenes)])
+        return plans
+
+
+class EvaluationServiceClient(object):
+
+    def __init__(self, socketPath, sceneFile, sensorParams, startLocation = None, planLoopsAround = False,
+                 visibilityMeshFaceFraction = 1.0):
+        self.connection = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+        self.connection.connect(socketPath)
+        # The service checks that it evaluates plans for the same scene and settings as we would.
+        hello = struct.pack("=I", PROTOCOL_VERSION)
+        sceneFile = os.path.realpath(sceneFile)
+        hello += struct.pack("=I", len(sceneFile)) + sceneFile
+        hello += _packDoubles([float(v) for v in sensorParams])
+        hello += _packDoubles([float(v) for v in startLocation] if startLocation is not None else [])
+        hello += struct.pack("=B", 1 if planLoopsAround else 0)
+        hello += struct.pack("=d", float(visibilityMeshFaceFraction))
+        self._request(HELLO, hello)
+
+    def close(self):
+        self.connection.close()
+
+    def _receiveExactly(self, numBytes):
+        chunks = []
+        while numBytes > 0:
+            chunk = self.connection.recv(min(numBytes, 1 << 20))
+            if not chunk:
+                raise EvaluationServiceError("The evaluation service closed the connection.")
+            chunks.append(chunk)
+            numBytes -= len(chunk)
+        return "".join(chunks)
+
+    def _request(self, requestType, payload = ""):
+        self.connection.sendall(struct.pack("=II", requestType, len(payload)) + payload)
+        status, payloadBytes = struct.unpack("=II", self._receiveExactly(8))
+        response = self._receiveExactly(payloadBytes)
+        if status != STATUS_OK:
+            raise EvaluationServiceError(response)
+        return _PayloadReader(response)
+
+    def evaluatePlans(self, plans, memoization, disableEnergyLimit = False):
+        payload = struct.pack("=BB", memoization, disableEnergyLimit) + _packPlans(plans)
+        reader = self._request(EVALUATE_PLANS, payload)
+        (numPlans,) = reader.read("I")
+        return [tuple(reader.readDoubles()) for _ in range(numPlans)]
+
+    def evaluatePlan(self, plan, memoization, how_to_plot = nothing, disableEnergyLimit = False):
+        if how_to_plot != nothing:
+            raise EvaluationServiceError("The evaluation service cannot plot plans.")
+        payload = struct.pack("=BB", memoization, disableEnergyLimit) + _packPlan(plan)
+        return tuple(self._request(EVALUATE_PLAN, payload).readDoubles())
+
+    def getNumberOfBoxes(self):
+        return self._request(GET_NUMBER_OF_BOXES).read("i")[0]
+
+    def getMaxAllowedEnergy(self):
+        return self._request(GET_MAX_ALLOWED_ENERGY).read("d")[0]
+
+    def getVisibilityMeshFaceCount(self):
+        return self._request(GET_VISIBILITY_MESH_FACE_COUNT).read("i")[0]
+
+    def getSimplePlans(self):
+        return self._request(GET_SIMPLE_PLANS).readPlans()
+
+    def updateMemoisedEdges(self, allSolutions):
+        # The service keeps the edges of the latest populations of all its clients.
+        return self._request(UPDATE_MEMOISED_EDGES, _packPlans(allSolutions)).read("i")[0]
+
+    def getStatistics(self):
+        # Statistics of all work done by the service, for every client.
+        reader = self._request(GET_STATISTICS)
+        values = dict(zip(evaluationStatisticsCounters, reader.read("%dQ" % len(evaluationStatisticsCounters))))
+        values.update(zip(evaluationStatisticsTimes, reader.read("%dd" % len(evaluationStatisticsTimes))))
+        return EvaluationStatistics(values)
+
+    def startSpeculativePrefetch(self, elitePlans, edgeBudget):
+        # The service is shared by several experiments, so it has no idle time of its own to speculate in.
+        pass
+
+    def setNumThreads(self, numThreads):
+        # The service's thread count is set when it is started.
+        pass
@@ -32,11 +32,17 @@ def evaluate(evaluator, memoization, override_energy_limit, individual):
     evolutionary_operators.mutationAndRecombination.cleanUpIndividual(individual)
     return evaluator.evaluatePlan(individual, memoization, nothing, override_energy_limit)
 
+def evaluateAll(evaluator, memoization, override_energy_limit, individuals):
+    #Evaluates a batch of individuals in one call, letting the evaluator spread them over several threads.
+    for individual in individuals:
+        evolutionary_operators.mutationAndRecombination.cleanUpIndividual(individual)
+    return evaluator.evaluatePlans(individuals, memoization, override_energy_limit)
+
 def storeSeedFitnesses(seedIndividuals, toolbox, storageFolder,evaluator, elapsedTime):
     if len(seedIndividuals) == 0:
         return
     #Storing the fitness of seed-plans.
-    fitnesses = toolbox.map(partial(toolbox.evaluate, evaluator, params.USING_EDGE_MEMOISATION, False), seedIndividuals)
+    fitnesses = evaluateAll(evaluator, params.USING_EDGE_MEMOISATION, False, seedIndividuals)
     for ind, fit in zip(seedIndividuals, fitnesses):
         ind.fitness.values = fit
     Utilities.storePopulationAndParameters(seedIndividuals, SEED_PLAN_FILE_PKL, args.output_folder, args.input_model_path, params, elapsedTime=elapsedTime)
@@ -64,11 +70,19 @@ def initialize(toolbox,storageFolder, multirun):
     #The main object we use to interface to the c++ evalution of plans.
     evaluator = evolutionary_operators.EvaluationInterface.generateEvaluator(args.input_model_path, params.SENSOR_PARAMETERS,
                                                                              postProcessing=False, planLoopsAround=params.PLAN_LOOPS_AROUND, startLocation=params.PLAN_ORIGIN,
-                                                                             printerFriendly=True)
+                                                                             printerFriendly=True,
+                                                                             sharedEdgeCacheName=getattr(params, "SHARED_EDGE_CACHE_NAME", None),
+                                                                             sharedEdgeCacheCapacity=getattr(params, "SHARED_EDGE_CACHE_CAPACITY", 20000),
+                                                                             numThreads=getattr(params, "EVALUATION_THREADS", 0),
+                                                                             serviceSocket=getattr(params, "EVALUATION_SERVICE_SOCKET", None),
+                                                                             visibilityMeshFaceFraction=getattr(params, "VISIBILITY_MESH_FACE_FRACTION", 1.0))
 
     #After the C++ object has been set up, we query it for some parameter values that we will use later.
     runtime_specified_parameters.num_potential_viewpoints = evaluator.getNumberOfBoxes()
     runtime_specified_parameters.max_energy_usage = evaluator.getMaxAllowedEnergy()
+    runtime_specified_parameters.visibility_mesh_faces = evaluator.getVisibilityMeshFaceCount()
+    if runtime_specified_parameters.visibility_mesh_faces > 0:
+        print "Estimating coverage with a simplified model of", runtime_specified_parameters.visibility_mesh_faces, "faces."
     #All the seeds we are considering. Empty if we don't seed.
     seedIndividuals, elapsedTime = generateSeedIndividuals(evaluator)
 
@@ -136,9 +150,9 @@ def main_nsga2(storageFolder, multirun):
     pop = toolbox.population(params.NUM_INDIVS)
 
     # Evaluate the individuals with an invalid fitness
-    #This map, can also multiprocess to parallelize calculations.
+    #The evaluator spreads the batch over several threads.
     invalid_ind = [ind for ind in pop if not ind.fitness.valid]
-    fitnesses = toolbox.map(partial(toolbox.evaluate, evaluator, params.USING_EDGE_MEMOISATION, False), invalid_ind)
+    fitnesses = evaluateAll(evaluator, params.USING_EDGE_MEMOISATION, False, invalid_ind)
     for ind, fit in zip(invalid_ind, fitnesses):
         ind.fitness.values = fit
 
@@ -188,7 +202,7 @@ def main_nsga2(storageFolder, multirun):
 
          #Reevaluating all individuals that were changed by crossover and mutation.
         invalid_ind = [ind for ind in offspring if not ind.fitness.valid]
-        fitnesses = toolbox.map(partial(toolbox.evaluate, evaluator, params.USING_EDGE_MEMOISATION, False), invalid_ind)
+        fitnesses = evaluateAll(evaluator, params.USING_EDGE_MEMOISATION, False, invalid_ind)
         for ind, fit in zip(invalid_ind, fitnesses):
             ind.fitness.values = fit
 
@@ -210,6 +224,13 @@ def main_nsga2(storageFolder, multirun):
         #Could consider doing this only each X generation - to save time.
         if params.USING_EDGE_MEMOISATION:
             runtime_specified_parameters.num_memoized_edges = evaluator.updateMemoisedEdges(pop)
+        runtime_specified_parameters.evaluation_statistics = Utilities.evaluationStatisticsToDict(evaluator.getStatistics())
+        runtime_specified_parameters.evaluation_statistics["visibilityMeshFaces"] = runtime_specified_parameters.visibility_mesh_faces
+        #Letting the evaluator render edges the next generation will probably need, while we select and vary.
+        prefetchBudget = getattr(params, "SPECULATIVE_PREFETCH_BUDGET", 0)
+        if params.USING_EDGE_MEMOISATION and prefetchBudget > 0:
+            elites = tools.sortNondominated(pop, len(pop), first_front_only=True)[0]
+            evaluator.startSpeculativePrefetch(elites, prefetchBudget)
     return pop, logbook, pf
 
 
@@ -240,7 +261,13 @@ if __name__ == "__main__":
 
     #Ensuring the same params are available to every part of the program
     runtime_specified_parameters.params = params
-    pop, stats, paretoFront = main_nsga2(storageFolder, args.multirun)
+    try:
+        pop, stats, paretoFront = main_nsga2(storageFolder, args.multirun)
+    finally:
+        # The shared edge table is only valid for this experiment's scene and sensor, so it should not outlive it.
+        # An evaluation service owns its own table, and removes it when it stops.
+        if getattr(params, "EVALUATION_SERVICE_SOCKET", None) is None:
+            evolutionary_operators.EvaluationInterface.removeSharedEdgeCache(getattr(params, "SHARED_EDGE_CACHE_NAME", None))
     print "Pareto front size is ", paretoFront
     print "Fitness frontier:"
     for p in pop:
@@ -17,6 +17,16 @@ maxEnergyName = "max_energy"
 elapsedTimeName = "elapsed_time"
 planLoopsAroundName = "plan_loops_around"
 numMemoizedSolutionsName = "num_memoized_solutions"
+evaluationStatisticsName = "evaluation_statistics"
+visibilityMeshFacesName = "visibility_mesh_faces"
+
+# The fields of EvaluationStatistics (see EvaluationStatistics.h), in the order the evaluation service sends them:
+# First the counters, then the times.
+evaluationStatisticsCounters = ["plansEvaluated", "planCacheHits", "memoHits", "memoMisses", "sharedCacheHits",
+                                "prefixEdgesSkipped", "framesRendered", "framesSkipped", "pixelsScanned", "edgeSubtasks",
+                                "subtaskSteals", "maxQueueDepth", "speculativeEdges", "memoEdges", "memoPatterns", "memoBytes"]
+evaluationStatisticsTimes = ["energySeconds", "edgeCoverageSeconds", "renderSeconds", "pixelScanSeconds", "scoringSeconds",
+                             "totalSeconds"]
 
 # Things we may want to plot
 hyperVolumeName = "hypervol"
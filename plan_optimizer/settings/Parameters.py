@@ -56,3 +56,23 @@ SENSOR_PARAMETERS = [2.0, 46.0, 46.0, 1024, 0.1, 10, 1, DOWN_CAM_ACTIVE]
 
 # Speeds up evaluation by memoizing results. Probably good idea to keep this active.
 USING_EDGE_MEMOISATION = True
+
+# If given, evaluators share their memoized edges through a shared memory table with this name (e.g. "/inspection_edges"),
+# so several optimizer processes on the same machine do not render the same edges twice. Requires USING_EDGE_MEMOISATION.
+# The table is removed when an experiment finishes. Processes still running keep theirs, but later ones start empty.
+SHARED_EDGE_CACHE_NAME = None
+SHARED_EDGE_CACHE_CAPACITY = 20000 # Max number of edges in the shared table. Memory use is roughly capacity*num_triangles/8 bytes.
+# During optimization, coverage is estimated by rendering a simplified model with this fraction of the inspection
+# target's triangles (small models are rendered as they are, see VISIBILITY_MESH_MIN_FACES in Constants.h). Much faster on
+# large models, but the scores differ slightly from those of the full model. 1 renders the full model, as runs before
+# this option did.
+# Post-processing always renders the full model. The number of faces rendered is stored with each population.
+VISIBILITY_MESH_FACE_FRACTION = 0.25
+# The number of threads used to evaluate each generation. 0 means one per hardware thread, 1 evaluates plans one at a time.
+EVALUATION_THREADS = 0
+# If given, plans are evaluated by an evaluation service listening on this UNIX socket (e.g. "/tmp/inspection_evaluator"),
+# started with the evaluationService program for the same scene and sensor parameters. Lets several runs share one evaluator.
+EVALUATION_SERVICE_SOCKET = None
+# While Python does selection and variation, the evaluator may render up to this many edges that mutations of the
+# Pareto front are likely to need next. 0 disables this speculative prefetching. Requires USING_EDGE_MEMOISATION.
+SPECULATIVE_PREFETCH_BUDGET = 0
@@ -284,6 +284,11 @@ def generate_simplified_roll_pitch_yaw(viewing_vectors):
     print "generated rpy vals: ", rpy_values
     return rpy_values
 
+#Turns the evaluator's EvaluationStatistics object into a dict, so it can be printed and stored in pkl and yml files.
+def evaluationStatisticsToDict(statistics):
+    fieldNames = Constants_and_Datastructures.evaluationStatisticsCounters + Constants_and_Datastructures.evaluationStatisticsTimes
+    return {name: getattr(statistics, name) for name in fieldNames}
+
 #Stores individuals, as well as parameters on how they were fitness tested.
 def storePopulationAndParameters(indivs, storageFileName, outputFolder, structure_path,
                                  parameters_file, paretoFront = None, elapsedTime = None):
@@ -297,6 +302,8 @@ def storePopulationAndParameters(indivs, storageFileName, outputFolder, structur
     storageDict = {settings.Constants_and_Datastructures.populationName : indivs, settings.Constants_and_Datastructures.sceneName : structure_path, settings.Constants_and_Datastructures.originName : parameters_file.PLAN_ORIGIN,
                    settings.Constants_and_Datastructures.sensorParamsName : parameters_file.SENSOR_PARAMETERS, settings.Constants_and_Datastructures.paretoFrontName : paretoFront,
                    settings.Constants_and_Datastructures.maxEnergyName: runtime_specified_parameters.max_energy_usage, settings.Constants_and_Datastructures.numMemoizedSolutionsName: runtime_specified_parameters.num_memoized_edges,
+                   settings.Constants_and_Datastructures.evaluationStatisticsName: runtime_specified_parameters.evaluation_statistics,
+                   settings.Constants_and_Datastructures.visibilityMeshFacesName: runtime_specified_parameters.visibility_mesh_faces,
                    settings.Constants_and_Datastructures.elapsedTimeName : elapsedTime, settings.Constants_and_Datastructures.planLoopsAroundName : parameters_file.PLAN_LOOPS_AROUND,
                    }
     with open(os.path.join(popSubFolder,storageFileName) , "wb") as store_file:
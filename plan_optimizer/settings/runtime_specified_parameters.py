@@ -5,6 +5,8 @@ __author__ = 'kaiolae'
 num_potential_viewpoints = None # The number of potential viewpoints to consider in our planning.
 max_energy_usage = None # The max energy usage of any allowed plan.
 num_memoized_edges = None # The number of edges memoized at any point. Important to keep low enough to avoid memory filling up.
+visibility_mesh_faces = None # The number of faces of the simplified model the evaluator renders. 0 if it renders the full model.
+evaluation_statistics = None # Dict with the evaluator's statistics (memo hits, frames rendered, time per stage, ...), as of the last generation.
 params = None #The module that holds this run's parameters, imported runtime.
 algorithm_start_time = -1 #The clock time when the algorithm started.
 use_seeds = True
\ No newline at end of file